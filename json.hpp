@@ -25,6 +25,7 @@
 #include <string>
 #include <deque>
 #include <map>
+#include <algorithm>
 #include <typeinfo> 
 #include <type_traits>
 #include <initializer_list>
@@ -33,6 +34,27 @@
 #include <fstream>
 #include <sstream>
 #include <limits>
+#include <utility>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MMR_JSON_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define MMR_JSON_SIMD_SSSE3
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define MMR_JSON_SIMD_AVX2
+#include <immintrin.h>
+#endif
 
 
 namespace Json
@@ -61,8 +83,731 @@ namespace Json
 	template<typename T>
 	static constexpr bool is_double_v = std::is_floating_point<T>::value;
 
+	//数组的存储方式，全部为int64或double的数组使用紧凑存储
+	enum class emArrayStorage : uint8_t {
+		Generic,//std::deque<Value>
+		Int64,//std::vector<int64_t>
+		Double//std::vector<double>
+	};
+
+	//对象的存储方式，数组中键序列相同的对象共享形状
+	enum class emObjectStorage : uint8_t {
+		Generic,//std::map<std::string, Value, std::less<>>
+		Shaped//共享的ObjectShape + 按槽位保存的值
+	};
+
+	//紧凑存储数组的只读视图，不拷贝数据
+	template<typename T>
+	class ArraySpan
+	{
+	public:
+		ArraySpan() : m_pData(nullptr), m_size(0) {}
+		ArraySpan(const T* data, size_t size) : m_pData(data), m_size(size) {}
+
+		const T* data() const { return m_pData; }
+		size_t size() const { return m_size; }
+		bool empty() const { return 0 == m_size; }
+		const T* begin() const { return m_pData; }
+		const T* end() const { return m_pData + m_size; }
+		const T& operator[](size_t index) const { return m_pData[index]; }
+
+	private:
+		const T* m_pData;
+		size_t m_size;
+	};
+
+	//紧凑存储数组的批量计算，支持SSE2、AVX2时使用向量指令
+	//浮点求和的累加顺序与逐个累加不同，结果可能存在舍入误差；空数组求和返回0，最小值、最大值返回类型的极值
+	namespace simd
+	{
+		inline double sum(const ArraySpan<double>& span)
+		{
+			const double* pData = span.data();
+			size_t size = span.size();
+			size_t i = 0;
+			double dRet = 0.0;
+#if defined(MMR_JSON_SIMD_AVX2)
+			__m256d acc0 = _mm256_setzero_pd();
+			__m256d acc1 = _mm256_setzero_pd();
+			for (; i + 8 <= size; i += 8)
+			{
+				acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(pData + i));
+				acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(pData + i + 4));
+			}
+			alignas(32) double buf[4];
+			_mm256_store_pd(buf, _mm256_add_pd(acc0, acc1));
+			dRet = (buf[0] + buf[1]) + (buf[2] + buf[3]);
+#elif defined(MMR_JSON_SIMD_SSE2)
+			__m128d acc0 = _mm_setzero_pd();
+			__m128d acc1 = _mm_setzero_pd();
+			for (; i + 4 <= size; i += 4)
+			{
+				acc0 = _mm_add_pd(acc0, _mm_loadu_pd(pData + i));
+				acc1 = _mm_add_pd(acc1, _mm_loadu_pd(pData + i + 2));
+			}
+			alignas(16) double buf[2];
+			_mm_store_pd(buf, _mm_add_pd(acc0, acc1));
+			dRet = buf[0] + buf[1];
+#endif
+			for (; i < size; ++i)
+				dRet += pData[i];
+			return dRet;
+		}
+
+		inline double min(const ArraySpan<double>& span)
+		{
+			const double* pData = span.data();
+			size_t size = span.size();
+			size_t i = 0;
+			double dRet = (std::numeric_limits<double>::max)();
+#if defined(MMR_JSON_SIMD_AVX2)
+			__m256d acc = _mm256_set1_pd(dRet);
+			for (; i + 4 <= size; i += 4)
+				acc = _mm256_min_pd(acc, _mm256_loadu_pd(pData + i));
+			alignas(32) double buf[4];
+			_mm256_store_pd(buf, acc);
+			for (auto iter : buf)
+				dRet = iter < dRet ? iter : dRet;
+#elif defined(MMR_JSON_SIMD_SSE2)
+			__m128d acc = _mm_set1_pd(dRet);
+			for (; i + 2 <= size; i += 2)
+				acc = _mm_min_pd(acc, _mm_loadu_pd(pData + i));
+			alignas(16) double buf[2];
+			_mm_store_pd(buf, acc);
+			dRet = buf[0] < buf[1] ? buf[0] : buf[1];
+#endif
+			for (; i < size; ++i)
+				dRet = pData[i] < dRet ? pData[i] : dRet;
+			return dRet;
+		}
+
+		inline double max(const ArraySpan<double>& span)
+		{
+			const double* pData = span.data();
+			size_t size = span.size();
+			size_t i = 0;
+			double dRet = std::numeric_limits<double>::lowest();
+#if defined(MMR_JSON_SIMD_AVX2)
+			__m256d acc = _mm256_set1_pd(dRet);
+			for (; i + 4 <= size; i += 4)
+				acc = _mm256_max_pd(acc, _mm256_loadu_pd(pData + i));
+			alignas(32) double buf[4];
+			_mm256_store_pd(buf, acc);
+			for (auto iter : buf)
+				dRet = iter > dRet ? iter : dRet;
+#elif defined(MMR_JSON_SIMD_SSE2)
+			__m128d acc = _mm_set1_pd(dRet);
+			for (; i + 2 <= size; i += 2)
+				acc = _mm_max_pd(acc, _mm_loadu_pd(pData + i));
+			alignas(16) double buf[2];
+			_mm_store_pd(buf, acc);
+			dRet = buf[0] > buf[1] ? buf[0] : buf[1];
+#endif
+			for (; i < size; ++i)
+				dRet = pData[i] > dRet ? pData[i] : dRet;
+			return dRet;
+		}
+
+		//整数求和溢出时按补码回绕
+		inline int64_t sum(const ArraySpan<int64_t>& span)
+		{
+			const int64_t* pData = span.data();
+			size_t size = span.size();
+			size_t i = 0;
+			uint64_t ulRet = 0;
+#if defined(MMR_JSON_SIMD_AVX2)
+			__m256i acc = _mm256_setzero_si256();
+			for (; i + 4 <= size; i += 4)
+				acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i)));
+			alignas(32) uint64_t buf[4];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(buf), acc);
+			ulRet = buf[0] + buf[1] + buf[2] + buf[3];
+#elif defined(MMR_JSON_SIMD_SSE2)
+			__m128i acc = _mm_setzero_si128();
+			for (; i + 2 <= size; i += 2)
+				acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i)));
+			alignas(16) uint64_t buf[2];
+			_mm_store_si128(reinterpret_cast<__m128i*>(buf), acc);
+			ulRet = buf[0] + buf[1];
+#endif
+			for (; i < size; ++i)
+				ulRet += static_cast<uint64_t>(pData[i]);
+			return static_cast<int64_t>(ulRet);
+		}
+
+		inline int64_t min(const ArraySpan<int64_t>& span)
+		{
+			const int64_t* pData = span.data();
+			size_t size = span.size();
+			size_t i = 0;
+			int64_t lRet = (std::numeric_limits<int64_t>::max)();
+#if defined(MMR_JSON_SIMD_AVX2)
+			__m256i acc = _mm256_set1_epi64x(lRet);
+			for (; i + 4 <= size; i += 4)
+			{
+				__m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i));
+				acc = _mm256_blendv_epi8(acc, data, _mm256_cmpgt_epi64(acc, data));
+			}
+			alignas(32) int64_t buf[4];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(buf), acc);
+			for (auto iter : buf)
+				lRet = iter < lRet ? iter : lRet;
+#endif
+			for (; i < size; ++i)
+				lRet = pData[i] < lRet ? pData[i] : lRet;
+			return lRet;
+		}
+
+		inline int64_t max(const ArraySpan<int64_t>& span)
+		{
+			const int64_t* pData = span.data();
+			size_t size = span.size();
+			size_t i = 0;
+			int64_t lRet = (std::numeric_limits<int64_t>::min)();
+#if defined(MMR_JSON_SIMD_AVX2)
+			__m256i acc = _mm256_set1_epi64x(lRet);
+			for (; i + 4 <= size; i += 4)
+			{
+				__m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData + i));
+				acc = _mm256_blendv_epi8(acc, data, _mm256_cmpgt_epi64(data, acc));
+			}
+			alignas(32) int64_t buf[4];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(buf), acc);
+			for (auto iter : buf)
+				lRet = iter > lRet ? iter : lRet;
+#endif
+			for (; i < size; ++i)
+				lRet = pData[i] > lRet ? pData[i] : lRet;
+			return lRet;
+		}
+	}
+
+	//Base64编解码（RFC 4648标准字母表，带'='填充），用于二进制数据与Json字符串互转
+	//支持SSSE3、AVX2时每次处理12/24字节，剩余部分及非法字符逐个处理
+	namespace base64
+	{
+		constexpr size_t encoded_size(size_t len) { return (len + 2) / 3 * 4; }
+
+		//解码后的最大长度，实际长度由decode返回
+		constexpr size_t decoded_max_size(size_t len) { return len / 4 * 3; }
+
+		inline const char* alphabet() { return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"; }
+
+		//字符对应的6位值，非法字符为-1
+		inline const int8_t* decode_table()
+		{
+			static const struct Table {
+				int8_t values[256];
+				Table() {
+					memset(values, -1, sizeof(values));
+					for (int i = 0; i < 64; ++i)
+						values[static_cast<uint8_t>(alphabet()[i])] = static_cast<int8_t>(i);
+				}
+			} table;
+			return table.values;
+		}
+
+#if defined(MMR_JSON_SIMD_SSSE3)
+		//12字节拆分为16个6位值，每个值占一个字节
+		inline __m128i encode_reshuffle(__m128i in)
+		{
+			in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+			const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+			const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+			return _mm_or_si128(t0, t1);
+		}
+
+		//6位值按区间查表得到与字符的差值
+		inline __m128i encode_translate(__m128i in)
+		{
+			const __m128i lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+			__m128i index = _mm_subs_epu8(in, _mm_set1_epi8(51));
+			index = _mm_or_si128(index, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), in), _mm_set1_epi8(13)));
+			return _mm_add_epi8(in, _mm_shuffle_epi8(lut, index));
+		}
+
+		//16个字符转换为6位值，含非法字符时返回false
+		inline bool decode_translate(__m128i& str)
+		{
+			const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+				0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+			const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+				0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+			const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+			const __m128i mask2F = _mm_set1_epi8(0x2f);
+			const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask2F);
+			const __m128i lo = _mm_shuffle_epi8(lutLo, _mm_and_si128(str, mask2F));
+			const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+			if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
+				return false;
+			const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(_mm_cmpeq_epi8(str, mask2F), hiNibbles));
+			str = _mm_add_epi8(str, roll);
+			return true;
+		}
+
+		//16个6位值合并为12字节，放在低12字节
+		inline __m128i decode_reshuffle(__m128i in)
+		{
+			const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+			return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+		}
+#endif
+
+#if defined(MMR_JSON_SIMD_AVX2)
+		//两个128位通道分别处理，与SSSE3版本相同
+		inline __m256i encode_reshuffle(__m256i in)
+		{
+			in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+				10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+			const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+			const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+			return _mm256_or_si256(t0, t1);
+		}
+
+		inline __m256i encode_translate(__m256i in)
+		{
+			const __m256i lut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+				'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+			__m256i index = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+			index = _mm256_or_si256(index, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), in), _mm256_set1_epi8(13)));
+			return _mm256_add_epi8(in, _mm256_shuffle_epi8(lut, index));
+		}
+
+		inline bool decode_translate(__m256i& str)
+		{
+			const __m256i lutLo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+				0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+				0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+				0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+			const __m256i lutHi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+				0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+				0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+				0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+			const __m256i lutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+				0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+			const __m256i mask2F = _mm256_set1_epi8(0x2f);
+			const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask2F);
+			const __m256i lo = _mm256_shuffle_epi8(lutLo, _mm256_and_si256(str, mask2F));
+			const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+			if (!_mm256_testz_si256(_mm256_and_si256(lo, hi), _mm256_and_si256(lo, hi)))
+				return false;
+			const __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(str, mask2F), hiNibbles));
+			str = _mm256_add_epi8(str, roll);
+			return true;
+		}
+
+		//各通道的12字节合并到低24字节
+		inline __m256i decode_reshuffle(__m256i in)
+		{
+			__m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+			merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+			return _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1));
+		}
+#endif
+
+		//pOut须有encoded_size(len)字节
+		inline void encode(const uint8_t* pData, size_t len, char* pOut)
+		{
+			size_t i = 0;
+#if defined(MMR_JSON_SIMD_AVX2)
+			for (; i + 28 <= len; i += 24, pOut += 32)
+			{
+				__m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i))),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i + 12)), 1);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut), encode_translate(encode_reshuffle(in)));
+			}
+#endif
+#if defined(MMR_JSON_SIMD_SSSE3)
+			for (; i + 16 <= len; i += 12, pOut += 16)
+			{
+				__m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pOut), encode_translate(encode_reshuffle(in)));
+			}
+#endif
+			const char* pTable = alphabet();
+			for (; i + 3 <= len; i += 3, pOut += 4)
+			{
+				uint32_t value = (uint32_t(pData[i]) << 16) | (uint32_t(pData[i + 1]) << 8) | pData[i + 2];
+				pOut[0] = pTable[value >> 18];
+				pOut[1] = pTable[(value >> 12) & 0x3f];
+				pOut[2] = pTable[(value >> 6) & 0x3f];
+				pOut[3] = pTable[value & 0x3f];
+			}
+			if (i < len)
+			{
+				uint32_t value = uint32_t(pData[i]) << 16;
+				if (i + 1 < len)
+					value |= uint32_t(pData[i + 1]) << 8;
+				pOut[0] = pTable[value >> 18];
+				pOut[1] = pTable[(value >> 12) & 0x3f];
+				pOut[2] = i + 1 < len ? pTable[(value >> 6) & 0x3f] : '=';
+				pOut[3] = '=';
+			}
+		}
+
+		inline std::string encode(const void* pData, size_t len)
+		{
+			std::string strRet(encoded_size(len), '\0');
+			encode(static_cast<const uint8_t*>(pData), len, &strRet[0]);
+			return strRet;
+		}
+
+		//pOut须有decoded_max_size(len)字节；长度不是4的倍数、含非法字符或'='不在末尾时返回false
+		inline bool decode(const char* pData, size_t len, uint8_t* pOut, size_t& outLen)
+		{
+			outLen = 0;
+			if (len % 4 != 0)
+				return false;
+			const uint8_t* pIn = reinterpret_cast<const uint8_t*>(pData);
+			uint8_t* pBegin = pOut;
+			size_t i = 0;
+			//向量写入的字节数多于解码的字节数，保证写入不超过decoded_max_size(len)
+#if defined(MMR_JSON_SIMD_AVX2)
+			for (; i + 48 <= len; i += 32, pOut += 24)
+			{
+				__m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIn + i));
+				if (!decode_translate(str))
+					break;
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut), decode_reshuffle(str));
+			}
+#endif
+#if defined(MMR_JSON_SIMD_SSSE3)
+			for (; i + 24 <= len; i += 16, pOut += 12)
+			{
+				__m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+				if (!decode_translate(str))
+					break;
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pOut), decode_reshuffle(str));
+			}
+#endif
+			const int8_t* pTable = decode_table();
+			for (; i + 4 < len; i += 4, pOut += 3)
+			{
+				int8_t a = pTable[pIn[i]], b = pTable[pIn[i + 1]], c = pTable[pIn[i + 2]], d = pTable[pIn[i + 3]];
+				if ((a | b | c | d) < 0)
+					return false;
+				uint32_t value = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+				pOut[0] = static_cast<uint8_t>(value >> 16);
+				pOut[1] = static_cast<uint8_t>(value >> 8);
+				pOut[2] = static_cast<uint8_t>(value);
+			}
+			//最后一组，可能有1~2个'='
+			if (i < len)
+			{
+				size_t padding = pIn[i + 3] != '=' ? 0 : (pIn[i + 2] != '=' ? 1 : 2);
+				int8_t a = pTable[pIn[i]], b = pTable[pIn[i + 1]];
+				int8_t c = padding < 2 ? pTable[pIn[i + 2]] : 0, d = padding < 1 ? pTable[pIn[i + 3]] : 0;
+				if ((a | b | c | d) < 0)
+					return false;
+				uint32_t value = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+				*pOut++ = static_cast<uint8_t>(value >> 16);
+				if (padding < 2)
+					*pOut++ = static_cast<uint8_t>(value >> 8);
+				if (padding < 1)
+					*pOut++ = static_cast<uint8_t>(value);
+			}
+			outLen = static_cast<size_t>(pOut - pBegin);
+			return true;
+		}
+	}
+
+	//字符串哈希（FNV-1a），用于键驻留等场景
+	inline constexpr uint64_t key_hash(const char* data, size_t len)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (size_t i = 0; i < len; ++i)
+		{
+			hash ^= static_cast<uint8_t>(data[i]);
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	//驻留的键，同一个KeyPool中内容相同的键指向同一个字符串，比较时只比较指针
+	class InternedKey
+	{
+	public:
+		InternedKey() : m_pStr(nullptr), m_hash(0) {}
+
+		const std::string& str() const { return m_pStr ? *m_pStr : empty_string(); }
+		uint64_t hash() const { return m_hash; }
+		bool valid() const { return nullptr != m_pStr; }
+
+		bool operator==(const InternedKey& other) const { return m_pStr == other.m_pStr; }
+		bool operator!=(const InternedKey& other) const { return m_pStr != other.m_pStr; }
+
+	private:
+		friend class KeyPool;
+		InternedKey(const std::string* pStr, uint64_t hash) : m_pStr(pStr), m_hash(hash) {}
+
+		static const std::string& empty_string() {
+			static const std::string strEmpty;
+			return strEmpty;
+		}
+
+		const std::string* m_pStr;
+		uint64_t m_hash;
+	};
+
+	//键驻留表，驻留的字符串在KeyPool生命周期内有效
+	//可以使用全局驻留表（线程安全），也可以为每个文档单独创建
+	//std::map存储的对象由节点保存键，不使用驻留表；解析时只有按形状保存的对象（ObjectShape）使用驻留的键
+	class KeyPool
+	{
+	public:
+		explicit KeyPool(bool bThreadSafe = false) : m_bThreadSafe(bThreadSafe) {}
+		KeyPool(const KeyPool&) = delete;
+		KeyPool& operator = (const KeyPool&) = delete;
+
+		//全局驻留表，程序运行期间一直有效
+		static KeyPool& global() {
+			static KeyPool pool(true);
+			return pool;
+		}
+
+		InternedKey intern(const std::string_view& key) {
+			return intern(key, key_hash(key.data(), key.size()));
+		}
+
+		//hash必须为key_hash(key)的结果
+		InternedKey intern(const std::string_view& key, uint64_t hash) {
+			std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+			if (m_bThreadSafe)
+				lock.lock();
+			auto range = m_mapIndex.equal_range(hash);
+			for (auto iter = range.first; iter != range.second; ++iter)
+			{
+				if (std::string_view(*iter->second) == key)
+					return InternedKey(iter->second, hash);
+			}
+			m_dqKeys.emplace_back(key.data(), key.size());
+			const std::string* pStr = &m_dqKeys.back();
+			m_mapIndex.emplace(hash, pStr);
+			return InternedKey(pStr, hash);
+		}
+
+		size_t size() const {
+			std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+			if (m_bThreadSafe)
+				lock.lock();
+			return m_dqKeys.size();
+		}
+
+	private:
+		std::deque<std::string> m_dqKeys;//deque追加元素时已有元素地址不变
+		std::unordered_multimap<uint64_t, const std::string*> m_mapIndex;
+		mutable std::mutex m_mutex;
+		bool m_bThreadSafe;
+	};
+
+	//对象的形状：键及其顺序，键序列相同的对象共享同一个形状，值按槽位保存
+	class ObjectShape
+	{
+	public:
+		static constexpr uint32_t npos = 0xFFFFFFFF;
+
+		//pOwner为键所在的驻留表，使用外部驻留表时为空
+		ObjectShape(std::vector<InternedKey> vecKeys, std::shared_ptr<KeyPool> pOwner = nullptr)
+			: m_pOwner(std::move(pOwner))
+			, m_vecKeys(std::move(vecKeys))
+		{
+			m_vecSorted.resize(m_vecKeys.size());
+			for (uint32_t i = 0; i < m_vecSorted.size(); ++i)
+				m_vecSorted[i] = i;
+			std::stable_sort(m_vecSorted.begin(), m_vecSorted.end(), [this](uint32_t lhs, uint32_t rhs) {
+				return m_vecKeys[lhs].str() < m_vecKeys[rhs].str();
+			});
+			if (m_vecKeys.size() > LINEAR_MAX)
+			{
+				m_vecIndex.reserve(m_vecKeys.size());
+				for (uint32_t i = 0; i < m_vecKeys.size(); ++i)
+					m_vecIndex.emplace_back(m_vecKeys[i].hash(), i);
+				std::sort(m_vecIndex.begin(), m_vecIndex.end());
+			}
+		}
+
+		size_t size() const { return m_vecKeys.size(); }
+		const InternedKey& key(size_t slot) const { return m_vecKeys[slot]; }
+
+		//按键排序的槽位，与std::map的遍历顺序一致
+		const std::vector<uint32_t>& sorted_slots() const { return m_vecSorted; }
+
+		//查找键所在的槽位，不存在时返回npos
+		uint32_t slot(const std::string_view& key) const {
+			return slot(key, key_hash(key.data(), key.size()));
+		}
+
+		uint32_t slot(const InternedKey& key) const {
+			return slot(key.str(), key.hash());
+		}
+
+		uint32_t slot(const std::string_view& key, uint64_t hash) const {
+			if (m_vecIndex.empty())
+			{
+				for (uint32_t i = 0; i < m_vecKeys.size(); ++i)
+				{
+					if (m_vecKeys[i].hash() == hash && m_vecKeys[i].str() == key)
+						return i;
+				}
+				return npos;
+			}
+			auto iter = std::lower_bound(m_vecIndex.begin(), m_vecIndex.end(), std::make_pair(hash, uint32_t(0)));
+			for (; iter != m_vecIndex.end() && iter->first == hash; ++iter)
+			{
+				if (m_vecKeys[iter->second].str() == key)
+					return iter->second;
+			}
+			return npos;
+		}
+
+	private:
+		static constexpr size_t LINEAR_MAX = 8;//键个数不超过该值时顺序查找
+
+		std::shared_ptr<KeyPool> m_pOwner;//先于m_vecKeys构造，后于其析构
+		std::vector<InternedKey> m_vecKeys;
+		std::vector<uint32_t> m_vecSorted;
+		std::vector<std::pair<uint64_t, uint32_t>> m_vecIndex;//按哈希排序的槽位索引
+	};
+
+	//投影解析时需要保留的字段，每个路径为"payload.kind"形式或JSON Pointer（"/payload/kind"）
+	//路径经过数组时对每个元素投影，路径的最后一级保留整个子树
+	class Projection
+	{
+	public:
+		struct Node
+		{
+			std::string key;			//与Json::Value中保存的键形式一致（转义后的形式）
+			bool all = false;			//保留整个子树
+			std::vector<Node> children;
+
+			const Node* find(const std::string_view& strKey) const {
+				for (const auto& iter : children)
+				{
+					if (iter.key == strKey)
+						return &iter;
+				}
+				return nullptr;
+			}
+		};
+
+		Projection() = default;
+
+		Projection(std::initializer_list<std::string_view> paths) {
+			for (const auto& iter : paths)
+				add(iter);
+		}
+
+		explicit Projection(const std::vector<std::string>& vecPaths) {
+			for (const auto& iter : vecPaths)
+				add(iter);
+		}
+
+		//JSON Pointer格式错误时抛出std::invalid_argument
+		void add(const std::string_view& path);
+
+		const Node& root() const { return m_root; }
+
+	private:
+		void add_keys(const std::vector<std::string>& vecKeys) {
+			Node* pNode = &m_root;
+			for (const auto& key : vecKeys)
+			{
+				if (pNode->all)
+					return;
+				Node* pChild = const_cast<Node*>(pNode->find(key));
+				if (pChild == nullptr)
+				{
+					pNode->children.emplace_back();
+					pChild = &pNode->children.back();
+					pChild->key = key;
+				}
+				pNode = pChild;
+			}
+			pNode->all = true;
+			pNode->children.clear();
+		}
+
+		Node m_root;
+	};
+
+	class FrozenDocument;
+	class ValueRef;
+	class CompactValue;
+	class Writer;
+	class Reader;
+	class Pointer;
+	class JsonPath;
+	class JsonIndex;
+	class IndexedFile;
+	class Schema;
+
 	class Value
 	{
+		friend class FrozenDocument;
+		friend class ValueRef;
+		friend class CompactValue;
+		friend class Writer;
+		friend class Reader;
+		friend class Pointer;
+		friend class JsonPath;
+		friend class Projection;
+		friend class JsonIndex;
+		friend class IndexedFile;
+		friend class Schema;
+
+	public:
+		//std::map存储的对象，比较器支持直接用string_view查找，不构造临时的std::string
+		using ObjectType = std::map<std::string, Value, std::less<>>;
+
+	private:
+		struct ShapedRecord {//按形状保存的对象
+			std::shared_ptr<const ObjectShape> Shape;
+			std::vector<Value> Slots;
+		};
+
+		//解析时的形状缓存，同一次解析中键序列相同的对象共享形状
+		struct ShapeContext {
+			KeyPool* pPool = nullptr;//为空时使用本次解析独有的驻留表
+			std::shared_ptr<KeyPool> pOwnPool;
+			std::vector<std::shared_ptr<const ObjectShape>> vecShapes;
+			std::deque<std::vector<std::pair<std::string, Value>>> dqEntries;//每层嵌套一个缓冲区，复用键的内存
+			size_t depth = 0;
+		};
+
+		//紧凑存储的数组，const的operator[]、at、ArrayRange第一次访问时在std::call_once中生成只读的Value副本，
+		//之后返回副本中元素的引用，不改变数组的存储方式；追加元素时同步追加到副本，转换为通用存储时直接使用副本
+		template<typename T>
+		class PackedList : public std::vector<T>
+		{
+		public:
+			PackedList() = default;
+			explicit PackedList(std::vector<T>&& vec) : std::vector<T>(std::move(vec)) {}
+			PackedList(const PackedList& other) : std::vector<T>(other) {}
+
+			const std::deque<Value>& values() const {
+				std::call_once(m_onceValues, [this]() {
+					m_pValues.reset(new std::deque<Value>(this->begin(), this->end()));
+				});
+				return *m_pValues;
+			}
+
+			void push_back(T arg) {
+				std::vector<T>::push_back(arg);
+				if (m_pValues)
+					m_pValues->emplace_back(arg);
+			}
+
+			std::deque<Value>* release_values() { return m_pValues.release(); }
+
+		private:
+			mutable std::once_flag m_onceValues;
+			mutable std::unique_ptr<std::deque<Value>> m_pValues;
+		};
+
 		union BackingData { //定义内联数据
 			BackingData(double d) : Float(d) {}
 			BackingData(int64_t   l) : Int(l) {}
@@ -72,7 +817,10 @@ namespace Json
 			BackingData() : Int(0) {}
 
 			std::deque<Value>        *List;
-			std::map<std::string, Value>   *Map;
+			PackedList<int64_t>      *IntList;
+			PackedList<double>       *FloatList;
+			ObjectType              *Map;
+			ShapedRecord            *Record;
 			std::string             *String;
 			double              Float;
 			int64_t            Int;
@@ -81,6 +829,9 @@ namespace Json
 		};
 
 	public:
+		class ConstObjectIterator;
+		class ConstObjectRange;
+
 		template <typename Container>//Arrry或Objec迭代器
 		class JSONWrapper {
 			Container *object;
@@ -120,6 +871,8 @@ namespace Json
 		Value(Value&& other)
 			: Internal(other.Internal)
 			, Type(std::exchange(other.Type, emJsonType::Null))
+			, Storage(std::exchange(other.Storage, emArrayStorage::Generic))
+			, ObjStorage(std::exchange(other.ObjStorage, emObjectStorage::Generic))
 		{
 			other.Internal.Map = nullptr;
 		}
@@ -130,8 +883,12 @@ namespace Json
 				ClearInternal();
 				Internal = other.Internal;
 				Type = other.Type;
+				Storage = other.Storage;
+				ObjStorage = other.ObjStorage;
 				other.Internal.Map = nullptr;
 				other.Type = emJsonType::Null;
+				other.Storage = emArrayStorage::Generic;
+				other.ObjStorage = emObjectStorage::Generic;
 			}
 			return *this;
 		}
@@ -139,14 +896,10 @@ namespace Json
 		Value(const Value &other) {
 			switch (other.Type) {
 			case emJsonType::Object:
-				Internal.Map =
-					new std::map<std::string, Value>(other.Internal.Map->begin(),
-						other.Internal.Map->end());
+				CopyObject(other);
 				break;
 			case emJsonType::Array:
-				Internal.List =
-					new std::deque<Value>(other.Internal.List->begin(),
-						other.Internal.List->end());
+				CopyArray(other);
 				break;
 			case emJsonType::String:
 				Internal.String =
@@ -156,6 +909,8 @@ namespace Json
 				Internal = other.Internal;
 			}
 			Type = other.Type;
+			Storage = other.Storage;
+			ObjStorage = other.ObjStorage;
 		}
 
 		Value& operator = (const Value &other) {
@@ -164,14 +919,10 @@ namespace Json
 				ClearInternal();
 				switch (other.Type) {
 				case emJsonType::Object:
-					Internal.Map =
-						new std::map<std::string, Value>(other.Internal.Map->begin(),
-							other.Internal.Map->end());
+					CopyObject(other);
 					break;
 				case emJsonType::Array:
-					Internal.List =
-						new std::deque<Value>(other.Internal.List->begin(),
-							other.Internal.List->end());
+					CopyArray(other);
 					break;
 				case emJsonType::String:
 					Internal.String =
@@ -181,6 +932,8 @@ namespace Json
 					Internal = other.Internal;
 				}
 				Type = other.Type;
+				Storage = other.Storage;
+				ObjStorage = other.ObjStorage;
 			}
 			return *this;
 		}
@@ -235,9 +988,15 @@ namespace Json
 			return arr;
 		}
 
+		//紧凑存储的数组追加同类型数字时保持紧凑存储，否则转换为通用存储
 		template <typename T>
 		void append(T arg) {
-			SetType(emJsonType::Array); Internal.List->emplace_back(arg);
+			SetType(emJsonType::Array);
+			if (!AppendPacked(arg))
+			{
+				unpack_array();
+				Internal.List->emplace_back(arg);
+			}
 		}
 
 		template <typename T, typename... U>
@@ -278,28 +1037,73 @@ namespace Json
 		}
 
 		template<typename _Ty>
-		Json::Value& operator >> ( _Ty& data){
+		Json::Value& operator >> ( _Ty& data) &{
 			data.parseJson(*this);
 			return *this;
 		}
 
+		//右值对象转换后即销毁，字符串和子树直接转移到结构体成员
+		template<typename _Ty>
+		void operator >> (_Ty& data) &&{
+			data.parseJson(std::move(*this));
+		}
+
+		//按形状保存的对象通过槽位访问，插入新的键时转换为通用存储
 		Value& operator[](const std::string &key) {
-			SetType(emJsonType::Object); return Internal.Map->operator[](key);
+			SetType(emJsonType::Object);
+			if (Value* pValue = find_slot(key))
+				return *pValue;
+			unpack_object();
+			return Internal.Map->operator[](key);
+		}
+
+		//设置成员的值，键直接构造在std::map的节点中，不产生临时的std::string
+		Value& set(const std::string_view &key, Value &&value) {
+			SetType(emJsonType::Object);
+			if (ObjStorage == emObjectStorage::Shaped)
+			{
+				uint32_t slot = Internal.Record->Shape->slot(key, key_hash(key.data(), key.size()));
+				if (slot != ObjectShape::npos)
+					return Internal.Record->Slots[slot] = std::move(value);
+				unpack_object();
+			}
+			//键已存在时新节点被丢弃，值在插入后再赋值
+			auto ret = Internal.Map->emplace(std::piecewise_construct,
+				std::forward_as_tuple(key.data(), key.size()), std::forward_as_tuple());
+			return ret.first->second = std::move(value);
 		}
 
+	//只读访问不改变对象的存储方式，键不存在或不是对象时返回null
 	const Value& operator[](const std::string &key) const {
-		return Internal.Map->operator[](key);
+		if (Type == emJsonType::Object)
+		{
+			if (ObjStorage == emObjectStorage::Shaped)
+			{
+				if (Value* pValue = find_slot(key))
+					return *pValue;
+			}
+			else
+			{
+				auto iter = Internal.Map->find(key);
+				if (iter != Internal.Map->end())
+					return iter->second;
+			}
+		}
+		return null_value();
 	}
 
 	Value& operator[](unsigned index) {
 		SetType(emJsonType::Array);
+		unpack_array();
 		if (index >= Internal.List->size()) Internal.List->resize(index + 1);
 		return Internal.List->operator[](index);
 	}
 
-	const Value& operator[](unsigned index) const{
-		if (index >= Internal.List->size()) Internal.List->resize(index + 1);
-		return Internal.List->operator[](index);
+	//只读访问不改变数组的存储方式，紧凑存储的数组返回只读副本中的元素；下标越界时为null
+	const Value& operator[](unsigned index) const {
+		if (Type != emJsonType::Array || index >= static_cast<unsigned>(array_size()))
+			return null_value();
+		return array_values()[index];
 	}
 
 		Value &at(const std::string &key) {
@@ -307,6 +1111,12 @@ namespace Json
 		}
 
 		const Value &at(const std::string &key) const {
+			if (ObjStorage == emObjectStorage::Shaped)
+			{
+				if (Value* pValue = find_slot(key))
+					return *pValue;
+				throw std::out_of_range("Json::Value::at: key not found.");
+			}
 			return Internal.Map->at(key);
 		}
 
@@ -314,54 +1124,258 @@ namespace Json
 			return operator[](index);
 		}
 
+		//下标越界或不是数组时抛出std::out_of_range
 		const Value &at(unsigned index) const {
-			return Internal.List->at(index);
+			if (Type != emJsonType::Array || index >= static_cast<unsigned>(array_size()))
+				throw std::out_of_range("Json::Value::at: index out of range.");
+			return array_values()[index];
 		}
 
 		int length() const {
 			if (Type == emJsonType::Array)
-				return Internal.List->size();
+				return array_size();
 			else
 				return -1;
 		}
 
+		//查找键对应的值，不是对象或键不存在时返回nullptr，按形状保存的对象直接使用哈希查找槽位
+		const Value* find(const std::string_view &key) const {
+			return find(key, key_hash(key.data(), key.size()));
+		}
+
+		//hash必须为key_hash(key)的结果
+		const Value* find(const std::string_view &key, uint64_t hash) const {
+			if (Type != emJsonType::Object)
+				return nullptr;
+			if (ObjStorage == emObjectStorage::Shaped)
+			{
+				uint32_t slot = Internal.Record->Shape->slot(key, hash);
+				return slot == ObjectShape::npos ? nullptr : &Internal.Record->Slots[slot];
+			}
+			auto iter = Internal.Map->find(key);
+			return iter == Internal.Map->end() ? nullptr : &iter->second;
+		}
+
 		bool hasKey(const std::string &key) const {
-			if (Type == emJsonType::Object)
-				return Internal.Map->find(key) != Internal.Map->end();
-			return false;
+			if (Type != emJsonType::Object)
+				return false;
+			if (ObjStorage == emObjectStorage::Shaped)
+				return nullptr != find_slot(key);
+			return Internal.Map->find(key) != Internal.Map->end();
 		}
 
 		bool eraseKey(const std::string& key) {
 			if (Type == emJsonType::Object)
+			{
+				unpack_object();
 				return Internal.Map->erase(key);
+			}
 			return false;
 		}
 
 		int size() const {
 			if (Type == emJsonType::Object)
-				return Internal.Map->size();
+				return ObjStorage == emObjectStorage::Shaped ? Internal.Record->Slots.size() : Internal.Map->size();
 			else if (Type == emJsonType::Array)
-				return Internal.List->size();
+				return array_size();
 			else
 				return -1;
 		}
 
 		emJsonType JSONType() const { return Type; }
 
-		/// Functions for getting primitives from the Value object.
-		bool IsNull() const { return Type == emJsonType::Null; }
+		emArrayStorage ArrayStorage() const { return Type == emJsonType::Array ? Storage : emArrayStorage::Generic; }
+
+		emObjectStorage ObjectStorage() const { return Type == emJsonType::Object ? ObjStorage : emObjectStorage::Generic; }
+
+		//按形状保存的对象返回其形状，否则返回nullptr
+		const ObjectShape* Shape() const {
+			return ObjectStorage() == emObjectStorage::Shaped ? Internal.Record->Shape.get() : nullptr;
+		}
 
+		//紧凑存储数组的只读视图，T为int64_t或double，存储方式不一致时返回空视图
 		template<typename T>
-		typename std::enable_if<std::is_arithmetic<T>::value, T>::type toNum() const { bool ret; return get<T>(ret); }
+		typename std::enable_if<std::is_same<T, int64_t>::value, ArraySpan<T>>::type as_span() const {
+			if (Type == emJsonType::Array && Storage == emArrayStorage::Int64)
+				return ArraySpan<T>(Internal.IntList->data(), Internal.IntList->size());
+			return ArraySpan<T>();
+		}
 
 		template<typename T>
-		typename std::enable_if<std::is_arithmetic<T>::value || std::is_same<std::decay_t<T>, std::string>::value, T>::type get() const
-		{
-			bool bRet = false;
-			auto ret = get<std::decay_t<T>>(bRet);
-			if (false == bRet)
+		typename std::enable_if<std::is_same<T, double>::value, ArraySpan<T>>::type as_span() const {
+			if (Type == emJsonType::Array && Storage == emArrayStorage::Double)
+				return ArraySpan<T>(Internal.FloatList->data(), Internal.FloatList->size());
+			return ArraySpan<T>();
+		}
+
+		//元素全部为Integral或全部为Floating的数组转换为紧凑存储，返回是否为紧凑存储
+		bool pack() {
+			if (Type != emJsonType::Array)
+				return false;
+			if (Storage != emArrayStorage::Generic)
+				return true;
+			if (Internal.List->empty())
+				return false;
+			emJsonType elemType = Internal.List->front().Type;
+			if (elemType != emJsonType::Integral && elemType != emJsonType::Floating)
+				return false;
+			for (const auto& iter : *Internal.List)
 			{
-				std::stringstream ss;
+				if (iter.Type != elemType)
+					return false;
+			}
+			if (elemType == emJsonType::Integral)
+			{
+				PackedList<int64_t>* pList = new PackedList<int64_t>();
+				pList->reserve(Internal.List->size());
+				for (const auto& iter : *Internal.List)
+					pList->push_back(iter.Internal.Int);
+				delete Internal.List;
+				Internal.IntList = pList;
+				Storage = emArrayStorage::Int64;
+			}
+			else
+			{
+				PackedList<double>* pList = new PackedList<double>();
+				pList->reserve(Internal.List->size());
+				for (const auto& iter : *Internal.List)
+					pList->push_back(iter.Internal.Float);
+				delete Internal.List;
+				Internal.FloatList = pList;
+				Storage = emArrayStorage::Double;
+			}
+			return true;
+		}
+
+		//紧凑存储的数组转换为通用存储，通过非const引用访问数组元素前调用；const接口不转换
+		void unpack_array() {
+			if (Type != emJsonType::Array || Storage == emArrayStorage::Generic)
+				return;
+			std::deque<Value>* pList = nullptr;
+			if (Storage == emArrayStorage::Int64)
+			{
+				pList = Internal.IntList->release_values();
+				if (pList == nullptr)
+					pList = new std::deque<Value>(Internal.IntList->begin(), Internal.IntList->end());
+				delete Internal.IntList;
+			}
+			else
+			{
+				pList = Internal.FloatList->release_values();
+				if (pList == nullptr)
+					pList = new std::deque<Value>(Internal.FloatList->begin(), Internal.FloatList->end());
+				delete Internal.FloatList;
+			}
+			Internal.List = pList;
+			Storage = emArrayStorage::Generic;
+		}
+
+		//按形状保存的对象转换为通用存储，通过非const的ObjectRange遍历或插入新的键前调用；const接口不转换
+		void unpack_object() {
+			if (Type != emJsonType::Object || ObjStorage == emObjectStorage::Generic)
+				return;
+			ShapedRecord* pRecord = Internal.Record;
+			const ObjectShape& shape = *pRecord->Shape;
+			ObjectType* pMap = new ObjectType();
+			for (auto slot : shape.sorted_slots())
+				pMap->emplace_hint(pMap->end(), shape.key(slot).str(), std::move(pRecord->Slots[slot]));
+			delete pRecord;
+			Internal.Map = pMap;
+			ObjStorage = emObjectStorage::Generic;
+		}
+
+		//按键的顺序遍历对象成员，与std::map的遍历顺序一致，不改变对象的存储方式
+		template<typename _Func>
+		void for_each_member(_Func&& func) const {
+			if (Type != emJsonType::Object)
+				return;
+			if (ObjStorage == emObjectStorage::Shaped)
+			{
+				const ObjectShape& shape = *Internal.Record->Shape;
+				for (auto slot : shape.sorted_slots())
+					func(shape.key(slot).str(), Internal.Record->Slots[slot]);
+			}
+			else
+			{
+				for (const auto& iter : *Internal.Map)
+					func(iter.first, iter.second);
+			}
+		}
+
+		template<typename _Func>
+		void for_each_member(_Func&& func) {
+			if (Type != emJsonType::Object)
+				return;
+			if (ObjStorage == emObjectStorage::Shaped)
+			{
+				const ObjectShape& shape = *Internal.Record->Shape;
+				for (auto slot : shape.sorted_slots())
+					func(shape.key(slot).str(), Internal.Record->Slots[slot]);
+			}
+			else
+			{
+				for (auto& iter : *Internal.Map)
+					func(iter.first, iter.second);
+			}
+		}
+
+		//按键的顺序逐个取出对象成员，键和值交给func后不再使用，结束后对象为空
+		//形状对象的键为驻留的字符串，以const std::string&传入，不复制；std::map存储的对象C++17中转移节点的键（std::string&&），否则以const std::string&传入
+		template<typename _Func>
+		void consume_members(_Func&& func) {
+			if (Type != emJsonType::Object)
+				return;
+			if (ObjStorage == emObjectStorage::Shaped)
+			{
+				const ObjectShape& shape = *Internal.Record->Shape;
+				for (auto slot : shape.sorted_slots())
+					func(shape.key(slot).str(), Internal.Record->Slots[slot]);
+				delete Internal.Record;
+				Internal.Map = new ObjectType();
+				ObjStorage = emObjectStorage::Generic;
+			}
+			else
+			{
+				while (!Internal.Map->empty())
+				{
+#if __cplusplus >= 201703L
+					auto node = Internal.Map->extract(Internal.Map->begin());
+					func(std::move(node.key()), node.mapped());
+#else
+					auto iter = Internal.Map->begin();
+					func(iter->first, iter->second);
+					Internal.Map->erase(iter);
+#endif
+				}
+			}
+		}
+
+		//字符串未转义的内容，不是字符串时返回空，对象销毁或修改后失效
+		std::string_view str_view() const {
+			return Type == emJsonType::String ? std::string_view(*Internal.String) : std::string_view();
+		}
+
+		//取出字符串，结果与get<std::string>()一致；不需要转义时直接转移缓冲区，不复制
+		std::string take_string() {
+			if (Type != emJsonType::String || need_escape(*Internal.String))
+				return get<std::string>();
+			return std::move(*Internal.String);
+		}
+
+		/// Functions for getting primitives from the Value object.
+		bool IsNull() const { return Type == emJsonType::Null; }
+
+		template<typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value, T>::type toNum() const { bool ret; return get<T>(ret); }
+
+		template<typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value || std::is_same<std::decay_t<T>, std::string>::value, T>::type get() const
+		{
+			bool bRet = false;
+			auto ret = get<std::decay_t<T>>(bRet);
+			if (false == bRet)
+			{
+				std::stringstream ss;
 				ss << "Json data [" << this->dumpFast() << "] convert to [" << typeid(T).name() << "] error." << std::endl;
 				throw std::runtime_error(ss.str());
 			}
@@ -464,27 +1478,27 @@ namespace Json
 			return strRet;//RVO
 		}
 
-		JSONWrapper<std::map<std::string, Value>> ObjectRange() {
+		JSONWrapper<ObjectType> ObjectRange() {
+			unpack_object();
 			if (Type == emJsonType::Object)
-				return JSONWrapper<std::map<std::string, Value>>(Internal.Map);
-			return JSONWrapper<std::map<std::string, Value>>(nullptr);
+				return JSONWrapper<ObjectType>(Internal.Map);
+			return JSONWrapper<ObjectType>(nullptr);
 		}
 
 		JSONWrapper<std::deque<Value>> ArrayRange() {
+			unpack_array();
 			if (Type == emJsonType::Array)
 				return JSONWrapper<std::deque<Value>>(Internal.List);
 			return JSONWrapper<std::deque<Value>>(nullptr);
 		}
 
-		JSONConstWrapper<std::map<std::string, Value>> ObjectRange() const {
-			if (Type == emJsonType::Object)
-				return JSONConstWrapper<std::map<std::string, Value>>(Internal.Map);
-			return JSONConstWrapper<std::map<std::string, Value>>(nullptr);
-		}
+		//只读遍历，按形状保存的对象不转换，按键的顺序遍历
+		ConstObjectRange ObjectRange() const;
 
+		//只读遍历，紧凑存储的数组不转换，遍历只读副本
 		JSONConstWrapper<std::deque<Value>> ArrayRange() const {
 			if (Type == emJsonType::Array)
-				return JSONConstWrapper<std::deque<Value>>(Internal.List);
+				return JSONConstWrapper<std::deque<Value>>(&array_values());
 			return JSONConstWrapper<std::deque<Value>>(nullptr);
 		}
 
@@ -513,24 +1527,31 @@ namespace Json
 			case emJsonType::Object: {
 				strR.append("{");
 				bool skip = true;
-				for (auto &p : *Internal.Map) {
+				for_each_member([&](const std::string& key, const Value& value) {
 					if (!skip)
 						strR.append(",");
-					strR.append("\"" + p.first + "\":");
-					p.second.dumpFast(strR);
+					strR.append("\"" + key + "\":");
+					value.dumpFast(strR);
 					skip = false;
-				}
+				});
 				strR.append("}");
 				break;
 			}
 			case emJsonType::Array: {
 				strR.append("[");
-				bool skip = true;
-				for (auto &p : *Internal.List)
+				if (Storage == emArrayStorage::Int64)
+					append_packed(strR, *Internal.IntList, ",");
+				else if (Storage == emArrayStorage::Double)
+					append_packed(strR, *Internal.FloatList, ",");
+				else
 				{
-					if (!skip) strR.append(",");
-					p.dumpFast(strR);
-					skip = false;
+					bool skip = true;
+					for (auto &p : *Internal.List)
+					{
+						if (!skip) strR.append(",");
+						p.dumpFast(strR);
+						skip = false;
+					}
 				}
 				strR.append("]");
 				break;
@@ -539,13 +1560,13 @@ namespace Json
 				strR.append("\"" + json_escape(*Internal.String) + "\"");
 				break;
 			case emJsonType::Floating:
-				strR.append(std::to_string(Internal.Float));
+				append_number(strR, Internal.Float);
 				break;
 			case emJsonType::Integral:
-				strR.append(std::to_string(Internal.Int));
+				append_number(strR, Internal.Int);
 				break;
 			case emJsonType::Uintegral:
-				strR.append(std::to_string(Internal.Uint64));
+				append_number(strR, Internal.Uint64);
 				break;
 			case emJsonType::Boolean:
 				strR.append(Internal.Bool ? "true" : "false");
@@ -569,15 +1590,14 @@ namespace Json
 				//strRet = 0 == depth ? pad + "{\n" : "\n" + pad + "{\n";
 				strData.append("{\n");
 				bool skip = true;
-				for (auto &p : *Internal.Map)
-				{
+				for_each_member([&](const std::string& key, const Value& value) {
 					if (!skip)
 						strData.append(",\n");
 
-					strData.append(pad + tab + "\"" + p.first + "\" : ");
-					p.second.dumpStyle(strData, depth + 1, tab);
+					strData.append(pad + tab + "\"" + key + "\" : ");
+					value.dumpStyle(strData, depth + 1, tab);
 					skip = false;
-				}
+				});
 				strData.append("\n" + pad + "}");
 				break;
 			}
@@ -585,15 +1605,27 @@ namespace Json
 				//strRet = 0 == depth ? pad + "[\n" : "\n" + pad + "[\n";
 				strData.append("[\n");
 				std::string childPad = pad + tab;
-				bool skip = true;
-				for (auto &p : *Internal.List)
+				if (Storage != emArrayStorage::Generic)
 				{
-					if (!skip)
-						strData.append(",\n");
-
+					std::string sep = ",\n" + childPad;
 					strData.append(childPad);
-					p.dumpStyle(strData, depth + 1, tab);
-					skip = false;
+					if (Storage == emArrayStorage::Int64)
+						append_packed(strData, *Internal.IntList, sep.c_str());
+					else
+						append_packed(strData, *Internal.FloatList, sep.c_str());
+				}
+				else
+				{
+					bool skip = true;
+					for (auto &p : *Internal.List)
+					{
+						if (!skip)
+							strData.append(",\n");
+
+						strData.append(childPad);
+						p.dumpStyle(strData, depth + 1, tab);
+						skip = false;
+					}
 				}
 				strData.append("\n" + pad + "]");
 				break;
@@ -602,13 +1634,13 @@ namespace Json
 				strData.append("\"" + json_escape(*Internal.String) + "\"");
 				break;
 			case emJsonType::Floating:
-				strData.append(std::to_string(Internal.Float));
+				append_number(strData, Internal.Float);
 				break;
 			case emJsonType::Integral:
-				strData.append(std::to_string(Internal.Int));
+				append_number(strData, Internal.Int);
 				break;
 			case emJsonType::Uintegral:
-				strData.append(std::to_string(Internal.Uint64));
+				append_number(strData, Internal.Uint64);
 				break;
 			case emJsonType::Boolean:
 				strData.append(Internal.Bool ? "true" : "false");
@@ -624,11 +1656,45 @@ namespace Json
 		}
 
 		std::string load(const std::string_view &str) {
+			ShapeContext ctx;
+			return load(str, ctx);
+		}
+
+		//数组中对象形状的键驻留到pool中，pool的生命周期须长于解析结果
+		std::string load(const std::string_view &str, KeyPool& pool) {
+			ShapeContext ctx;
+			ctx.pPool = &pool;
+			return load(str, ctx);
+		}
+
+		//只解析projection中的字段，其它内容只匹配括号和字符串快速跳过，不检查格式
+		std::string load(const std::string_view &str, const Projection& projection) {
+			size_t offset = 0;
+			std::string strErr;
+			try
+			{
+				Value temJv;
+				consume_ws(str, offset);
+				parse_projected(str, offset, projection.root(), temJv);
+				consume_ws(str, offset);
+				if (offset < str.size())
+					throw std::out_of_range("more than one object.");
+				(*this) = std::move(temJv);
+			}
+			catch (const std::exception& e)
+			{
+				strErr = e.what() + error_position(str, offset);
+			}
+			return strErr;
+		}
+
+	private:
+		std::string load(const std::string_view &str, ShapeContext& ctx) {
 			size_t offset = 0;
 			std::string strErr;
 			try
 			{
-				Value temJv = parse_next(str, offset);//防止解析失败改变原有值
+				Value temJv = parse_next(str, offset, &ctx);//防止解析失败改变原有值
 				consume_ws(str, offset);
 				if (offset < str.size())
 					throw std::out_of_range("more than one object.");
@@ -636,35 +1702,41 @@ namespace Json
 			}
 			catch (const std::exception& e)
 			{
-				strErr = e.what();
-				uint32_t rowNum = 0;
-				uint32_t colNum = 0;
-				if (offset > 0)
+				strErr = e.what() + error_position(str, offset);
+			}
+			return strErr;
+		}
+
+	public:
+		//计算offset所在的行列号，用于解析失败时的错误信息
+		static std::string error_position(const std::string_view &str, size_t offset)
+		{
+			uint32_t rowNum = 0;
+			uint32_t colNum = 0;
+			if (offset > 0)
+			{
+				size_t posLineEnd = 0;//记录最后一个回车的offset
+				do
 				{
-					size_t posLineEnd = 0;//记录最后一个回车的offset
-					do
-					{
-						auto poslastEnd = str.find('\n', posLineEnd);
-						if (poslastEnd != std::string::npos) {
-							++poslastEnd;
-							++rowNum;
-							if (poslastEnd > offset) {
-								colNum = offset - posLineEnd + 1;
-								break;
-							}
-							else
-								posLineEnd = poslastEnd;
-						}
-						else {
+					auto poslastEnd = str.find('\n', posLineEnd);
+					if (poslastEnd != std::string::npos) {
+						++poslastEnd;
+						++rowNum;
+						if (poslastEnd > offset) {
 							colNum = offset - posLineEnd + 1;
 							break;
 						}
+						else
+							posLineEnd = poslastEnd;
+					}
+					else {
+						colNum = offset - posLineEnd + 1;
+						break;
+					}
 
-					} while (posLineEnd < offset);
-				}
-				strErr = strErr + " row:" + std::to_string(rowNum) + " col:" + std::to_string(colNum);
+				} while (posLineEnd < offset);
 			}
-			return strErr;
+			return " row:" + std::to_string(rowNum) + " col:" + std::to_string(colNum);
 		}
 
 		std::string load_from_file(const std::string& strFile) {
@@ -705,13 +1777,52 @@ namespace Json
 			return false;
 		}
 
+		//MessagePack编码，直接写入strOut，不经过Json文本；Integral使用最短的整数格式（非负数超过uint32时使用int64），
+		//Uintegral固定使用uint64格式，Floating固定使用float64格式，解码时类型不变；键和字符串写入转义前的内容
+		void toMsgPack(std::string& strOut) const { msgpack_write(strOut); }
+
+		std::string toMsgPack() const
+		{
+			std::string strRet;
+			strRet.reserve(256);
+			msgpack_write(strRet);
+			return strRet;
+		}
+
+		//解析MessagePack数据，失败时返回错误信息且不改变原有值；uint64格式为Uintegral，其它整数格式为Integral，
+		//bin格式转换为字符串，不支持ext格式，map的键必须为字符串
+		std::string loadMsgPack(const std::string_view& data) {
+			return load_binary(data, &Value::msgpack_read);
+		}
+
+		//CBOR（RFC 8949）编码，整数使用最短的长度，浮点数固定为双精度
+		void toCbor(std::string& strOut) const { cbor_write(strOut); }
+
+		std::string toCbor() const
+		{
+			std::string strRet;
+			strRet.reserve(256);
+			cbor_write(strRet);
+			return strRet;
+		}
+
+		//解析CBOR数据，失败时返回错误信息且不改变原有值；CBOR的整数没有有无符号之分，与Json文本一致，
+		//不超过int64范围时为Integral，否则为Uintegral；支持不定长度的字符串、数组和map，忽略标签，字节串转换为字符串
+		std::string loadCbor(const std::string_view& data) {
+			return load_binary(data, &Value::cbor_read);
+		}
+
 		static Value parse_next(const std::string_view &str, size_t &offset) {
+			return parse_next(str, offset, nullptr);
+		}
+	private:
+		static Value parse_next(const std::string_view &str, size_t &offset, ShapeContext* pCtx) {
 			char value;
 			consume_ws(str, offset);
 			value = str[offset];
 			switch (value) {
-			case '[': return parse_array(str, offset);
-			case '{': return parse_object(str, offset);
+			case '[': return parse_array(str, offset, pCtx);
+			case '{': return parse_object(str, offset, pCtx);
 			case '\"': return parse_string(str, offset);
 			case 't':
 			case 'f': return parse_bool(str, offset);
@@ -727,92 +1838,684 @@ namespace Json
 			}
 			return Value();
 		}
-	private:
-		void SetType(emJsonType type) {
-			if (type == Type)
-				return;
-			ClearInternal();
-			switch (type) {
-			case emJsonType::Null:      Internal.Map = nullptr;                break;
-			case emJsonType::Object:    Internal.Map = new std::map<std::string, Value>(); break;
-			case emJsonType::Array:     Internal.List = new std::deque<Value>();     break;
-			case emJsonType::String:    Internal.String = new std::string();           break;
-			case emJsonType::Floating:  Internal.Float = 0.0;                    break;
-			case emJsonType::Integral:  Internal.Int = 0;                      break;
-			case emJsonType::Uintegral:  Internal.Uint64 = 0;                      break;
-			case emJsonType::Boolean:   Internal.Bool = false;                  break;
+
+		//二进制格式中嵌套的最大层数，防止恶意数据导致栈溢出
+		static constexpr size_t kMaxBinaryDepth = 1024;
+
+		std::string load_binary(const std::string_view& data, Value(*funcRead)(const std::string_view&, size_t&, size_t)) {
+			size_t offset = 0;
+			std::string strErr;
+			try
+			{
+				Value temJv = funcRead(data, offset, 0);
+				if (offset < data.size())
+					throw std::out_of_range("more than one object.");
+				(*this) = std::move(temJv);
 			}
-			Type = type;
+			catch (const std::exception& e)
+			{
+				strErr = e.what() + std::string(" offset:") + std::to_string(offset);
+			}
+			return strErr;
 		}
 
-		void ClearInternal() {
-			switch (Type) {
-			case emJsonType::Object: delete Internal.Map;    break;
-			case emJsonType::Array:  delete Internal.List;   break;
-			case emJsonType::String: delete Internal.String; break;
-			default:;
-			}
+		static void append_be(std::string& strOut, uint64_t value, int bytes) {
+			for (int i = bytes - 1; i >= 0; --i)
+				strOut.push_back(static_cast<char>(value >> (i * 8)));
 		}
 
-		static std::string json_escape(const std::string &str) {//转义输出
-			std::string output;
-			output.reserve(str.capacity());
-			for (const auto iter : str)
-				switch (iter) {
-				case '\"': output += "\\\""; break;
-				case '\\': output += "\\\\"; break;
-				case '\b': output += "\\b";  break;
-				case '\f': output += "\\f";  break;
-				case '\n': output += "\\n";  break;
-				case '\r': output += "\\r";  break;
-				case '\t': output += "\\t";  break;
-				default: output += iter; break;
-				}
-			return output;
+		static uint64_t read_be(const std::string_view& data, size_t& offset, int bytes) {
+			if (data.size() - offset < static_cast<size_t>(bytes))
+				throw std::out_of_range("binary data truncated.");
+			uint64_t value = 0;
+			for (int i = 0; i < bytes; ++i)
+				value = (value << 8) | static_cast<uint8_t>(data[offset++]);
+			return value;
 		}
 
-		static void consume_ws(const std::string_view &str, size_t &offset) {//去掉空格和注释
+		static std::string_view read_bytes(const std::string_view& data, size_t& offset, uint64_t len) {
+			if (data.size() - offset < len)
+				throw std::out_of_range("binary data truncated.");
+			std::string_view ret = data.substr(offset, static_cast<size_t>(len));
+			offset += static_cast<size_t>(len);
+			return ret;
+		}
 
-			static const std::string strEndLind = "\n";
-			static const std::string strEndComment = "*/";
-			while (isspace(str[offset])) ++offset;
+		//元素个数不能超过剩余的字节数，防止恶意数据申请大量内存
+		static size_t check_count(const std::string_view& data, size_t offset, uint64_t count) {
+			if (count > data.size() - offset)
+				throw std::out_of_range("binary element count out of range.");
+			return static_cast<size_t>(count);
+		}
 
-			if (str[offset] == '#')//使用“#”注释
+		//保存的键为转义后的形式，编码时还原
+		static std::string_view raw_key(const std::string& key, std::string& strBuf) {
+			if (key.find('\\') == std::string::npos)
+				return key;
+			std::string strQuoted = "\"" + key + "\"";
+			size_t offset = 0;
+			strBuf.clear();
+			parse_string_raw(strQuoted, offset, strBuf);
+			return strBuf;
+		}
+
+		static std::string escaped_key(const std::string_view& raw) {
+			std::string strKey(raw.data(), raw.size());
+			if (need_escape(strKey))
+				strKey = json_escape(strKey);
+			return strKey;
+		}
+
+		static double bits_to_double(uint64_t bits) { double dRet; memcpy(&dRet, &bits, sizeof(dRet)); return dRet; }
+		static uint64_t double_to_bits(double d) { uint64_t bits; memcpy(&bits, &d, sizeof(bits)); return bits; }
+		static double float_bits_to_double(uint32_t bits) { float fRet; memcpy(&fRet, &bits, sizeof(fRet)); return fRet; }
+
+		//数组元素达到16个且类型相同时与load一致使用紧凑存储
+		static Value make_array(std::deque<Value>&& dqList) {
+			Value Array = Value::Make(emJsonType::Array);
+			*Array.Internal.List = std::move(dqList);
+			if (Array.Internal.List->size() >= 16)
+				Array.pack();
+			return Array;
+		}
+
+		static void msgpack_head(std::string& strOut, uint8_t fixBase, size_t fixMax, uint8_t code8, uint8_t code16, size_t len) {
+			if (len <= fixMax)
+				strOut.push_back(static_cast<char>(fixBase | len));
+			else if (code8 && len <= 0xff)
 			{
-				size_t endPos = 0;
-				endPos = str.find(strEndLind, offset);
-				if (endPos != std::string::npos)
-				{
-					offset = endPos + 1;
-					consume_ws(str, offset);
-				}
+				strOut.push_back(static_cast<char>(code8));
+				append_be(strOut, len, 1);
 			}
-			else if (str[offset] == '/')
+			else if (len <= 0xffff)
 			{
-				size_t endPos = 0;
-				if (str[offset + 1] == '/')//使用“//”注释
+				strOut.push_back(static_cast<char>(code16));
+				append_be(strOut, len, 2);
+			}
+			else
+			{
+				strOut.push_back(static_cast<char>(code16 + 1));
+				append_be(strOut, len, 4);
+			}
+		}
+
+		static void msgpack_int(std::string& strOut, int64_t value) {
+			if (value >= -32 && value <= 127)
+				strOut.push_back(static_cast<char>(value));
+			else if (value >= 0)
+			{
+				int bytes = value <= 0xff ? 1 : (value <= 0xffff ? 2 : (value <= 0xffffffffll ? 4 : 8));
+				strOut.push_back(static_cast<char>(bytes == 1 ? 0xcc : (bytes == 2 ? 0xcd : (bytes == 4 ? 0xce : 0xd3))));
+				append_be(strOut, static_cast<uint64_t>(value), bytes);
+			}
+			else
+			{
+				int bytes = value >= -128 ? 1 : (value >= -32768 ? 2 : (value >= (std::numeric_limits<int32_t>::min)() ? 4 : 8));
+				strOut.push_back(static_cast<char>(bytes == 1 ? 0xd0 : (bytes == 2 ? 0xd1 : (bytes == 4 ? 0xd2 : 0xd3))));
+				append_be(strOut, static_cast<uint64_t>(value), bytes);
+			}
+		}
+
+		void msgpack_write(std::string& strOut) const {
+			switch (Type) {
+			case emJsonType::Null:
+				strOut.push_back(static_cast<char>(0xc0));
+				break;
+			case emJsonType::Boolean:
+				strOut.push_back(static_cast<char>(Internal.Bool ? 0xc3 : 0xc2));
+				break;
+			case emJsonType::Integral:
+				msgpack_int(strOut, Internal.Int);
+				break;
+			case emJsonType::Uintegral:
+				strOut.push_back(static_cast<char>(0xcf));
+				append_be(strOut, Internal.Uint64, 8);
+				break;
+			case emJsonType::Floating:
+				strOut.push_back(static_cast<char>(0xcb));
+				append_be(strOut, double_to_bits(Internal.Float), 8);
+				break;
+			case emJsonType::String:
+				msgpack_head(strOut, 0xa0, 31, 0xd9, 0xda, Internal.String->size());
+				strOut.append(*Internal.String);
+				break;
+			case emJsonType::Array:
+				if (Storage == emArrayStorage::Int64)
 				{
-					endPos = str.find(strEndLind, offset);
-					if (endPos != std::string::npos)
-					{
-						offset = endPos + 1;
-						consume_ws(str, offset);
-					}
+					msgpack_head(strOut, 0x90, 15, 0, 0xdc, Internal.IntList->size());
+					for (auto iter : *Internal.IntList)
+						msgpack_int(strOut, iter);
 				}
-				else if (str[offset + 1] == '*')//使用“/*  */”多行注注释
+				else if (Storage == emArrayStorage::Double)
 				{
-					endPos = str.find(strEndComment, offset);
-					if (endPos != std::string::npos)
+					msgpack_head(strOut, 0x90, 15, 0, 0xdc, Internal.FloatList->size());
+					for (auto iter : *Internal.FloatList)
 					{
-						offset = endPos + 2;
-						consume_ws(str, offset);
+						strOut.push_back(static_cast<char>(0xcb));
+						append_be(strOut, double_to_bits(iter), 8);
 					}
 				}
-			}
-		}
-
-		static Value parse_object(const std::string_view &str, size_t &offset) {
-			Value Object = Value::Make(emJsonType::Object);
+				else
+				{
+					msgpack_head(strOut, 0x90, 15, 0, 0xdc, Internal.List->size());
+					for (const auto& iter : *Internal.List)
+						iter.msgpack_write(strOut);
+				}
+				break;
+			case emJsonType::Object: {
+				msgpack_head(strOut, 0x80, 15, 0, 0xde, static_cast<size_t>(size()));
+				std::string strBuf;
+				for_each_member([&](const std::string& key, const Value& value) {
+					std::string_view raw = raw_key(key, strBuf);
+					msgpack_head(strOut, 0xa0, 31, 0xd9, 0xda, raw.size());
+					strOut.append(raw.data(), raw.size());
+					value.msgpack_write(strOut);
+				});
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		static std::string_view msgpack_read_str(const std::string_view& data, size_t& offset, uint8_t code) {
+			uint64_t len = 0;
+			if (code >= 0xa0 && code <= 0xbf)
+				len = code & 0x1f;
+			else if (code == 0xd9 || code == 0xc4)
+				len = read_be(data, offset, 1);
+			else if (code == 0xda || code == 0xc5)
+				len = read_be(data, offset, 2);
+			else if (code == 0xdb || code == 0xc6)
+				len = read_be(data, offset, 4);
+			else
+				throw std::invalid_argument("MsgPack: map key must be a string.");
+			return read_bytes(data, offset, len);
+		}
+
+		static Value msgpack_read(const std::string_view& data, size_t& offset, size_t depth) {
+			if (depth >= kMaxBinaryDepth)
+				throw std::out_of_range("binary data nested too deep.");
+			uint8_t code = static_cast<uint8_t>(read_be(data, offset, 1));
+			if (code <= 0x7f)
+				return Value(static_cast<int64_t>(code));
+			if (code >= 0xe0)
+				return Value(static_cast<int64_t>(static_cast<int8_t>(code)));
+			uint64_t count = 0;
+			switch (code) {
+			case 0xc0: return Value(nullptr);
+			case 0xc2: return Value(false);
+			case 0xc3: return Value(true);
+			case 0xca: return Value(float_bits_to_double(static_cast<uint32_t>(read_be(data, offset, 4))));
+			case 0xcb: return Value(bits_to_double(read_be(data, offset, 8)));
+			case 0xcc: return Value(static_cast<int64_t>(read_be(data, offset, 1)));
+			case 0xcd: return Value(static_cast<int64_t>(read_be(data, offset, 2)));
+			case 0xce: return Value(static_cast<int64_t>(read_be(data, offset, 4)));
+			case 0xcf: return Value(read_be(data, offset, 8));
+			case 0xd0: return Value(static_cast<int64_t>(static_cast<int8_t>(read_be(data, offset, 1))));
+			case 0xd1: return Value(static_cast<int64_t>(static_cast<int16_t>(read_be(data, offset, 2))));
+			case 0xd2: return Value(static_cast<int64_t>(static_cast<int32_t>(read_be(data, offset, 4))));
+			case 0xd3: return Value(static_cast<int64_t>(read_be(data, offset, 8)));
+			case 0xdc: count = read_be(data, offset, 2); break;
+			case 0xdd: count = read_be(data, offset, 4); break;
+			case 0xde: count = read_be(data, offset, 2); break;
+			case 0xdf: count = read_be(data, offset, 4); break;
+			default:
+				if (code >= 0x80 && code <= 0x9f)
+				{
+					count = code & 0x0f;
+					break;
+				}
+				if ((code >= 0xa0 && code <= 0xbf) || (code >= 0xc4 && code <= 0xc6) || (code >= 0xd9 && code <= 0xdb))
+				{
+					std::string_view view = msgpack_read_str(data, offset, code);
+					return Value(std::string(view.data(), view.size()));
+				}
+				{
+					std::stringstream ss;
+					ss << "MsgPack: unsupported type 0x" << std::hex << static_cast<int>(code) << ".";
+					throw std::invalid_argument(ss.str());
+				}
+			}
+			if ((code >= 0x90 && code <= 0x9f) || code == 0xdc || code == 0xdd)
+			{
+				std::deque<Value> dqList;
+				for (size_t i = check_count(data, offset, count); i > 0; --i)
+					dqList.push_back(msgpack_read(data, offset, depth + 1));
+				return make_array(std::move(dqList));
+			}
+			Value Object = Value::Make(emJsonType::Object);
+			for (size_t i = check_count(data, offset, count * 2) / 2; i > 0; --i)
+			{
+				std::string strKey = escaped_key(msgpack_read_str(data, offset, static_cast<uint8_t>(read_be(data, offset, 1))));
+				(*Object.Internal.Map)[std::move(strKey)] = msgpack_read(data, offset, depth + 1);
+			}
+			return Object;
+		}
+
+		static void cbor_head(std::string& strOut, uint8_t major, uint64_t value) {
+			uint8_t head = static_cast<uint8_t>(major << 5);
+			if (value < 24)
+				strOut.push_back(static_cast<char>(head | value));
+			else
+			{
+				int bytes = value <= 0xff ? 1 : (value <= 0xffff ? 2 : (value <= 0xffffffffull ? 4 : 8));
+				strOut.push_back(static_cast<char>(head | (bytes == 1 ? 24 : (bytes == 2 ? 25 : (bytes == 4 ? 26 : 27)))));
+				append_be(strOut, value, bytes);
+			}
+		}
+
+		static void cbor_int(std::string& strOut, int64_t value) {
+			if (value >= 0)
+				cbor_head(strOut, 0, static_cast<uint64_t>(value));
+			else
+				cbor_head(strOut, 1, ~static_cast<uint64_t>(value));
+		}
+
+		static void cbor_double(std::string& strOut, double value) {
+			strOut.push_back(static_cast<char>(0xfb));
+			append_be(strOut, double_to_bits(value), 8);
+		}
+
+		void cbor_write(std::string& strOut) const {
+			switch (Type) {
+			case emJsonType::Null:
+				strOut.push_back(static_cast<char>(0xf6));
+				break;
+			case emJsonType::Boolean:
+				strOut.push_back(static_cast<char>(Internal.Bool ? 0xf5 : 0xf4));
+				break;
+			case emJsonType::Integral:
+				cbor_int(strOut, Internal.Int);
+				break;
+			case emJsonType::Uintegral:
+				cbor_head(strOut, 0, Internal.Uint64);
+				break;
+			case emJsonType::Floating:
+				cbor_double(strOut, Internal.Float);
+				break;
+			case emJsonType::String:
+				cbor_head(strOut, 3, Internal.String->size());
+				strOut.append(*Internal.String);
+				break;
+			case emJsonType::Array:
+				if (Storage == emArrayStorage::Int64)
+				{
+					cbor_head(strOut, 4, Internal.IntList->size());
+					for (auto iter : *Internal.IntList)
+						cbor_int(strOut, iter);
+				}
+				else if (Storage == emArrayStorage::Double)
+				{
+					cbor_head(strOut, 4, Internal.FloatList->size());
+					for (auto iter : *Internal.FloatList)
+						cbor_double(strOut, iter);
+				}
+				else
+				{
+					cbor_head(strOut, 4, Internal.List->size());
+					for (const auto& iter : *Internal.List)
+						iter.cbor_write(strOut);
+				}
+				break;
+			case emJsonType::Object: {
+				cbor_head(strOut, 5, static_cast<uint64_t>(size()));
+				std::string strBuf;
+				for_each_member([&](const std::string& key, const Value& value) {
+					std::string_view raw = raw_key(key, strBuf);
+					cbor_head(strOut, 3, raw.size());
+					strOut.append(raw.data(), raw.size());
+					value.cbor_write(strOut);
+				});
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		//读取头部的参数，不定长度时返回false
+		static bool cbor_argument(const std::string_view& data, size_t& offset, uint8_t info, uint64_t& value) {
+			if (info < 24)
+				value = info;
+			else if (info <= 27)
+				value = read_be(data, offset, 1 << (info - 24));
+			else if (info == 31)
+				return false;
+			else
+				throw std::invalid_argument("CBOR: reserved additional information.");
+			return true;
+		}
+
+		static double cbor_half(uint16_t bits) {
+			int exp = (bits >> 10) & 0x1f;
+			int mant = bits & 0x3ff;
+			double dRet = exp == 0 ? std::ldexp(mant, -24)
+				: (exp != 31 ? std::ldexp(mant + 1024, exp - 25) : (mant == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN()));
+			return (bits & 0x8000) ? -dRet : dRet;
+		}
+
+		//字节串或文本串，不定长度时拼接各个分段
+		static void cbor_read_str(const std::string_view& data, size_t& offset, uint8_t head, std::string& strOut) {
+			uint8_t major = head >> 5;
+			if (major != 2 && major != 3)
+				throw std::invalid_argument("CBOR: map key must be a string.");
+			uint64_t len = 0;
+			if (cbor_argument(data, offset, head & 0x1f, len))
+			{
+				std::string_view bytes = read_bytes(data, offset, len);
+				strOut.append(bytes.data(), bytes.size());
+				return;
+			}
+			while (true)
+			{
+				uint8_t chunk = static_cast<uint8_t>(read_be(data, offset, 1));
+				if (chunk == 0xff)
+					break;
+				if ((chunk >> 5) != major || !cbor_argument(data, offset, chunk & 0x1f, len))
+					throw std::invalid_argument("CBOR: invalid indefinite-length string chunk.");
+				std::string_view bytes = read_bytes(data, offset, len);
+				strOut.append(bytes.data(), bytes.size());
+			}
+		}
+
+		//不定长度时读取到结束符0xff
+		static bool cbor_next(const std::string_view& data, size_t& offset, bool bIndefinite, size_t& count) {
+			if (!bIndefinite)
+				return count-- > 0;
+			if (offset < data.size() && static_cast<uint8_t>(data[offset]) == 0xff)
+			{
+				++offset;
+				return false;
+			}
+			return true;
+		}
+
+		static Value cbor_read(const std::string_view& data, size_t& offset, size_t depth) {
+			if (depth >= kMaxBinaryDepth)
+				throw std::out_of_range("binary data nested too deep.");
+			uint8_t head = static_cast<uint8_t>(read_be(data, offset, 1));
+			uint8_t major = head >> 5;
+			uint8_t info = head & 0x1f;
+			if (major == 7)
+			{
+				switch (info) {
+				case 20: return Value(false);
+				case 21: return Value(true);
+				case 22:
+				case 23: return Value(nullptr);
+				case 25: return Value(cbor_half(static_cast<uint16_t>(read_be(data, offset, 2))));
+				case 26: return Value(float_bits_to_double(static_cast<uint32_t>(read_be(data, offset, 4))));
+				case 27: return Value(bits_to_double(read_be(data, offset, 8)));
+				default:
+					throw std::invalid_argument("CBOR: unsupported simple value " + std::to_string(info) + ".");
+				}
+			}
+			if (major == 2 || major == 3)
+			{
+				Value String = Value::Make(emJsonType::String);
+				cbor_read_str(data, offset, head, *String.Internal.String);
+				return String;
+			}
+			uint64_t arg = 0;
+			bool bIndefinite = !cbor_argument(data, offset, info, arg);
+			if (bIndefinite && major != 4 && major != 5)
+				throw std::invalid_argument("CBOR: indefinite length is only allowed for strings, arrays and maps.");
+			switch (major) {
+			case 0:
+				return arg <= static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()) ? Value(static_cast<int64_t>(arg)) : Value(arg);
+			case 1:
+				if (arg > static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()))
+					throw std::out_of_range("CBOR: negative integer out of int64 range.");
+				return Value(-1 - static_cast<int64_t>(arg));
+			case 4: {
+				std::deque<Value> dqList;
+				size_t count = bIndefinite ? 0 : check_count(data, offset, arg);
+				while (cbor_next(data, offset, bIndefinite, count))
+					dqList.push_back(cbor_read(data, offset, depth + 1));
+				return make_array(std::move(dqList));
+			}
+			case 5: {
+				Value Object = Value::Make(emJsonType::Object);
+				size_t count = bIndefinite ? 0 : check_count(data, offset, arg * 2) / 2;
+				std::string strRaw;
+				while (cbor_next(data, offset, bIndefinite, count))
+				{
+					strRaw.clear();
+					cbor_read_str(data, offset, static_cast<uint8_t>(read_be(data, offset, 1)), strRaw);
+					(*Object.Internal.Map)[escaped_key(strRaw)] = cbor_read(data, offset, depth + 1);
+				}
+				return Object;
+			}
+			default://标签，忽略标签的含义
+				return cbor_read(data, offset, depth + 1);
+			}
+		}
+
+		void SetType(emJsonType type) {
+			if (type == Type)
+				return;
+			ClearInternal();
+			switch (type) {
+			case emJsonType::Null:      Internal.Map = nullptr;                break;
+			case emJsonType::Object:    Internal.Map = new ObjectType(); ObjStorage = emObjectStorage::Generic; break;
+			case emJsonType::Array:     Internal.List = new std::deque<Value>(); Storage = emArrayStorage::Generic; break;
+			case emJsonType::String:    Internal.String = new std::string();           break;
+			case emJsonType::Floating:  Internal.Float = 0.0;                    break;
+			case emJsonType::Integral:  Internal.Int = 0;                      break;
+			case emJsonType::Uintegral:  Internal.Uint64 = 0;                      break;
+			case emJsonType::Boolean:   Internal.Bool = false;                  break;
+			}
+			Type = type;
+		}
+
+		void ClearInternal() {
+			switch (Type) {
+			case emJsonType::Object:
+				if (ObjStorage == emObjectStorage::Shaped)
+					delete Internal.Record;
+				else
+					delete Internal.Map;
+				ObjStorage = emObjectStorage::Generic;
+				break;
+			case emJsonType::Array:
+				if (Storage == emArrayStorage::Int64)
+					delete Internal.IntList;
+				else if (Storage == emArrayStorage::Double)
+					delete Internal.FloatList;
+				else
+					delete Internal.List;
+				Storage = emArrayStorage::Generic;
+				break;
+			case emJsonType::String: delete Internal.String; break;
+			default:;
+			}
+		}
+
+		void CopyObject(const Value &other) {
+			if (other.ObjStorage == emObjectStorage::Shaped)
+				Internal.Record = new ShapedRecord(*other.Internal.Record);
+			else
+				Internal.Map =
+					new ObjectType(other.Internal.Map->begin(),
+						other.Internal.Map->end());
+		}
+
+		//按形状保存的对象查找键对应的值，不存在或为通用存储时返回nullptr
+		Value* find_slot(const std::string &key) const {
+			if (Type != emJsonType::Object || ObjStorage != emObjectStorage::Shaped)
+				return nullptr;
+			uint32_t slot = Internal.Record->Shape->slot(key);
+			return slot == ObjectShape::npos ? nullptr : &Internal.Record->Slots[slot];
+		}
+
+		void CopyArray(const Value &other) {
+			switch (other.Storage) {
+			case emArrayStorage::Int64: Internal.IntList = new PackedList<int64_t>(*other.Internal.IntList); break;
+			case emArrayStorage::Double: Internal.FloatList = new PackedList<double>(*other.Internal.FloatList); break;
+			default:
+				Internal.List =
+					new std::deque<Value>(other.Internal.List->begin(),
+						other.Internal.List->end());
+				break;
+			}
+		}
+
+		//数组元素的只读视图，紧凑存储时为只读副本
+		const std::deque<Value>& array_values() const {
+			switch (Storage) {
+			case emArrayStorage::Int64: return Internal.IntList->values();
+			case emArrayStorage::Double: return Internal.FloatList->values();
+			default: return *Internal.List;
+			}
+		}
+
+		int array_size() const {
+			switch (Storage) {
+			case emArrayStorage::Int64: return Internal.IntList->size();
+			case emArrayStorage::Double: return Internal.FloatList->size();
+			default: return Internal.List->size();
+			}
+		}
+
+		template <typename T>
+		typename std::enable_if<is_int_v<T>, bool>::type AppendPacked(T arg) {
+			if (Storage != emArrayStorage::Int64)
+				return false;
+			Internal.IntList->push_back(arg);
+			return true;
+		}
+
+		template <typename T>
+		typename std::enable_if<is_double_v<T>, bool>::type AppendPacked(T arg) {
+			if (Storage != emArrayStorage::Double)
+				return false;
+			Internal.FloatList->push_back(arg);
+			return true;
+		}
+
+		template <typename T>
+		typename std::enable_if<!is_int_v<T> && !is_double_v<T>, bool>::type AppendPacked(const T&) {
+			return false;
+		}
+
+		//数字输出，与std::to_string格式一致，不生成临时字符串
+		template<typename _outType>
+		static void append_number(_outType& strR, int64_t lData) {
+			char buf[24];
+			uint64_t ulData = lData < 0 ? 0 - static_cast<uint64_t>(lData) : static_cast<uint64_t>(lData);
+			char* pBegin = format_uint(buf + sizeof(buf), ulData);
+			if (lData < 0)
+				*(--pBegin) = '-';
+			strR.append(pBegin);
+		}
+
+		template<typename _outType>
+		static void append_number(_outType& strR, uint64_t ulData) {
+			char buf[24];
+			strR.append(format_uint(buf + sizeof(buf), ulData));
+		}
+
+		template<typename _outType>
+		static void append_number(_outType& strR, double dData) {
+			char buf[512];
+			snprintf(buf, sizeof(buf), "%f", dData);
+			strR.append(buf);
+		}
+
+		//从pEnd向前写入数字，末尾写入'\0'，返回起始位置
+		static char* format_uint(char* pEnd, uint64_t ulData) {
+			*(--pEnd) = '\0';
+			do
+			{
+				*(--pEnd) = static_cast<char>('0' + ulData % 10);
+				ulData /= 10;
+			} while (ulData != 0);
+			return pEnd;
+		}
+
+		template<typename _outType, typename T>
+		static void append_packed(_outType& strR, const std::vector<T>& vecData, const char* sep) {
+			bool skip = true;
+			for (auto iter : vecData)
+			{
+				if (!skip) strR.append(sep);
+				append_number(strR, iter);
+				skip = false;
+			}
+		}
+
+		static bool need_escape(const std::string &str) {
+			for (const auto iter : str)
+			{
+				switch (iter) {
+				case '\"': case '\\': case '\b': case '\f': case '\n': case '\r': case '\t':
+					return true;
+				default: break;
+				}
+			}
+			return false;
+		}
+
+		static std::string json_escape(const std::string &str) {//转义输出
+			std::string output;
+			output.reserve(str.capacity());
+			for (const auto iter : str)
+				switch (iter) {
+				case '\"': output += "\\\""; break;
+				case '\\': output += "\\\\"; break;
+				case '\b': output += "\\b";  break;
+				case '\f': output += "\\f";  break;
+				case '\n': output += "\\n";  break;
+				case '\r': output += "\\r";  break;
+				case '\t': output += "\\t";  break;
+				default: output += iter; break;
+				}
+			return output;
+		}
+
+		static void consume_ws(const std::string_view &str, size_t &offset) {//去掉空格和注释
+
+			static const std::string strEndLind = "\n";
+			static const std::string strEndComment = "*/";
+			while (isspace(str[offset])) ++offset;
+
+			if (str[offset] == '#')//使用“#”注释
+			{
+				size_t endPos = 0;
+				endPos = str.find(strEndLind, offset);
+				if (endPos != std::string::npos)
+				{
+					offset = endPos + 1;
+					consume_ws(str, offset);
+				}
+			}
+			else if (str[offset] == '/')
+			{
+				size_t endPos = 0;
+				if (str[offset + 1] == '/')//使用“//”注释
+				{
+					endPos = str.find(strEndLind, offset);
+					if (endPos != std::string::npos)
+					{
+						offset = endPos + 1;
+						consume_ws(str, offset);
+					}
+				}
+				else if (str[offset + 1] == '*')//使用“/*  */”多行注注释
+				{
+					endPos = str.find(strEndComment, offset);
+					if (endPos != std::string::npos)
+					{
+						offset = endPos + 2;
+						consume_ws(str, offset);
+					}
+				}
+			}
+		}
+
+		static Value parse_object(const std::string_view &str, size_t &offset, ShapeContext* pCtx) {
+			Value Object = Value::Make(emJsonType::Object);
 
 			do
 			{
@@ -824,9 +2527,10 @@ namespace Json
 					break;;
 				}
 
+				std::string strKey;//复用键的缓冲区
 				while (true)
 				{
-					Value Key = parse_next(str, offset);
+					parse_key(str, offset, strKey);
 					consume_ws(str, offset);
 					if (str[offset] != ':')
 					{
@@ -836,8 +2540,7 @@ namespace Json
 						//break;
 					}
 					consume_ws(str, ++offset);
-					Value Value = parse_next(str, offset);
-					Object[Key.get<std::string>()] = Value;
+					Object.Internal.Map->operator[](strKey) = parse_next(str, offset, pCtx);
 
 					consume_ws(str, offset);
 					if (str[offset] == ',')
@@ -863,7 +2566,7 @@ namespace Json
 			return Object;
 		}
 
-		static Value parse_array(const std::string_view &str, size_t &offset) {
+		static Value parse_array(const std::string_view &str, size_t &offset, ShapeContext* pCtx) {
 			Value Array = Value::Make(emJsonType::Array);
 			unsigned index = 0;
 
@@ -877,9 +2580,26 @@ namespace Json
 					break;;
 				}
 
+				bool bResume = false;//紧凑解析中断时，已经解析了一个元素
+				if ((str[offset] <= '9' && str[offset] >= '0') || str[offset] == '-')
+				{
+					if (parse_packed_array(str, offset, Array))
+						break;
+					index = Array.Internal.List->size();
+					bResume = true;
+				}
+
 				while (true)
 				{
-					Array[index++] = parse_next(str, offset);
+					if (!bResume)
+					{
+						consume_ws(str, offset);
+						if (pCtx && str[offset] == '{')
+							Array[index++] = parse_record(str, offset, *pCtx);
+						else
+							Array[index++] = parse_next(str, offset, pCtx);
+					}
+					bResume = false;
 					consume_ws(str, offset);
 
 					if (str[offset] == ',')
@@ -899,58 +2619,606 @@ namespace Json
 						throw std::invalid_argument(ss.str());
 					}
 				}
-			} while (false);
-			return Array;
+			} while (false);
+			return Array;
+		}
+
+		//数组中的对象按形状保存，键序列与已有形状一致时共享形状
+		static Value parse_record(const std::string_view &str, size_t &offset, ShapeContext &ctx) {
+			if (ctx.depth == ctx.dqEntries.size())
+				ctx.dqEntries.emplace_back();
+			auto& vecEntries = ctx.dqEntries[ctx.depth];
+			size_t count = 0;
+
+			++offset;
+			consume_ws(str, offset);
+			if (str[offset] == '}')
+			{
+				++offset;
+				return Value::Make(emJsonType::Object);
+			}
+
+			while (true)
+			{
+				if (count == vecEntries.size())
+					vecEntries.emplace_back();
+				auto& entry = vecEntries[count];
+				parse_key(str, offset, entry.first);
+				consume_ws(str, offset);
+				if (str[offset] != ':')
+				{
+					std::stringstream ss;
+					ss << "Error: Object: Expected ':', found '" << str[offset] << "'.";
+					throw std::invalid_argument(ss.str());
+				}
+				consume_ws(str, ++offset);
+				++ctx.depth;
+				entry.second = parse_next(str, offset, &ctx);
+				--ctx.depth;
+				++count;
+
+				consume_ws(str, offset);
+				if (str[offset] == ',')
+				{
+					++offset;
+					continue;
+				}
+				else if (str[offset] == '}')
+				{
+					++offset;
+					break;
+				}
+				else
+				{
+					std::stringstream ss;
+					ss << "ERROR: Object: Expected ',' or '}', found '" << str[offset] << "'.";
+					throw std::invalid_argument(ss.str());
+				}
+			}
+
+			Value Object;
+			std::shared_ptr<const ObjectShape> pShape = find_shape(ctx, vecEntries, count);
+			if (!pShape)
+			{
+				Object.SetType(emJsonType::Object);
+				for (size_t i = 0; i < count; ++i)
+					Object.Internal.Map->operator[](vecEntries[i].first) = std::move(vecEntries[i].second);
+				return Object;
+			}
+			ShapedRecord* pRecord = new ShapedRecord{ std::move(pShape), {} };
+			pRecord->Slots.reserve(count);
+			for (size_t i = 0; i < count; ++i)
+				pRecord->Slots.emplace_back(std::move(vecEntries[i].second));
+			Object.Internal.Record = pRecord;
+			Object.Type = emJsonType::Object;
+			Object.ObjStorage = emObjectStorage::Shaped;
+			return Object;
+		}
+
+		//查找键序列一致的形状，没有时新建，键重复或过多时返回空
+		static std::shared_ptr<const ObjectShape> find_shape(ShapeContext &ctx,
+			const std::vector<std::pair<std::string, Value>> &vecEntries, size_t count) {
+			if (count > SHAPE_KEYS_MAX)
+				return nullptr;
+			for (size_t i = ctx.vecShapes.size(); i > 0; --i)
+			{
+				const auto& pShape = ctx.vecShapes[i - 1];
+				if (pShape->size() != count)
+					continue;
+				size_t index = 0;
+				while (index < count && pShape->key(index).str() == vecEntries[index].first)
+					++index;
+				if (index == count)
+					return pShape;
+			}
+
+			KeyPool* pPool = ctx.pPool;
+			if (nullptr == pPool)
+			{
+				if (!ctx.pOwnPool)
+					ctx.pOwnPool = std::make_shared<KeyPool>();
+				pPool = ctx.pOwnPool.get();
+			}
+			std::vector<InternedKey> vecKeys;
+			vecKeys.reserve(count);
+			for (size_t i = 0; i < count; ++i)
+				vecKeys.push_back(pPool->intern(vecEntries[i].first));
+			auto pShape = std::make_shared<const ObjectShape>(std::move(vecKeys), ctx.pPool ? nullptr : ctx.pOwnPool);
+			const auto& vecSorted = pShape->sorted_slots();
+			for (size_t i = 1; i < vecSorted.size(); ++i)
+			{
+				if (pShape->key(vecSorted[i]) == pShape->key(vecSorted[i - 1]))
+					return nullptr;//重复的键按通用存储处理，后出现的值生效
+			}
+			if (ctx.vecShapes.size() >= SHAPE_CACHE_MAX)
+				ctx.vecShapes.erase(ctx.vecShapes.begin());
+			ctx.vecShapes.push_back(pShape);
+			return pShape;
+		}
+
+		//数字数组优先按紧凑存储解析，返回true表示数组解析完成
+		//遇到其它类型的元素时，已解析的元素转为通用存储，并解析该元素后返回false
+		static bool parse_packed_array(const std::string_view &str, size_t &offset, Value &Array) {
+			std::vector<int64_t> vecInt;
+			std::vector<double> vecFloat;
+			emJsonType numType = emJsonType::Null;
+			Value Pending;
+			bool bDone = false;
+			while (true)
+			{
+				Value Number = parse_number(str, offset);
+				if (numType == emJsonType::Null)
+					numType = Number.Type;
+				if (Number.Type != numType || numType == emJsonType::Uintegral)
+				{
+					Pending = std::move(Number);
+					break;
+				}
+				if (numType == emJsonType::Integral)
+					vecInt.push_back(Number.Internal.Int);
+				else
+					vecFloat.push_back(Number.Internal.Float);
+
+				consume_ws(str, offset);
+				if (str[offset] == ']')
+				{
+					++offset;
+					bDone = true;
+					break;
+				}
+				else if (str[offset] != ',')
+				{
+					std::stringstream ss;
+					ss << "ERROR: Array: Expected ',' or ']', found '" << str[offset] << "'.";
+					throw std::invalid_argument(ss.str());
+				}
+				consume_ws(str, ++offset);
+				if (!((str[offset] <= '9' && str[offset] >= '0') || str[offset] == '-'))
+				{
+					Pending = parse_next(str, offset);
+					break;
+				}
+			}
+
+			if (bDone && vecInt.size() + vecFloat.size() >= PACKED_ARRAY_MIN)
+			{
+				Array.ClearInternal();
+				if (numType == emJsonType::Integral)
+				{
+					Array.Internal.IntList = new PackedList<int64_t>(std::move(vecInt));
+					Array.Storage = emArrayStorage::Int64;
+				}
+				else
+				{
+					Array.Internal.FloatList = new PackedList<double>(std::move(vecFloat));
+					Array.Storage = emArrayStorage::Double;
+				}
+				return true;
+			}
+
+			for (auto iter : vecInt)
+				Array.Internal.List->emplace_back(iter);
+			for (auto iter : vecFloat)
+				Array.Internal.List->emplace_back(iter);
+			if (!bDone)
+				Array.Internal.List->emplace_back(std::move(Pending));
+			return bDone;
+		}
+
+		//解析对象的键，与get<std::string>()一致保存转义后的形式
+		static void parse_key(const std::string_view &str, size_t &offset, std::string &strKey) {
+			consume_ws(str, offset);
+			if (str[offset] != '\"')
+			{
+				strKey = parse_next(str, offset).get<std::string>();//非字符串的键抛出异常
+				return;
+			}
+			strKey.clear();
+			parse_string_raw(str, offset, strKey);
+			if (need_escape(strKey))
+				strKey = json_escape(strKey);
+		}
+
+		static Value parse_string(const std::string_view &str, size_t &offset) {
+			Value String = Value::Make(emJsonType::String);
+			parse_string_raw(str, offset, *String.Internal.String);
+			return String;
+		}
+
+		//解析字符串内容到val中，offset指向起始引号，解析后指向结束引号的下一个字符；没有结束引号时抛出异常
+		static void parse_string_raw(const std::string_view &str, size_t &offset, std::string &val) {
+			const size_t size = str.size();
+			for (++offset; offset < size && str[offset] != '\"'; ++offset)
+			{
+				char c = str[offset];
+				if (c == '\\') {
+					if (++offset == size)
+						break;
+					switch (str[offset]) {
+					case '\"': val += '\"'; break;
+					case '\\': val += '\\'; break;
+					case '/': val += '/'; break;
+					case 'b': val += '\b'; break;
+					case 'f': val += '\f'; break;
+					case 'n': val += '\n'; break;
+					case 'r': val += '\r'; break;
+					case 't': val += '\t'; break;
+					case 'u': {
+						val += "\\u";
+						for (unsigned i = 1; i <= 4; ++i) {
+							c = offset + i < size ? str[offset + i] : '\0';
+							if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))
+								val += c;
+							else {
+								std::stringstream ss;
+								ss << "ERROR: String: Expected hex character in unicode escape, found '" << c << "'.";
+								throw std::invalid_argument(ss.str());
+							}
+						}
+						offset += 4;
+					} break;
+					default: val += '\\'; break;
+					}
+				}
+				else
+					val += c;
+			}
+			if (offset >= size)
+			{
+				offset = size;
+				throw std::invalid_argument("ERROR: String: Expected '\"', found end of input.");
+			}
+			++offset;
+		}
+
+		//跳过一个Json值，不构建Value
+		static void skip_next(const std::string_view &str, size_t &offset) {
+			consume_ws(str, offset);
+			char value = offset < str.size() ? str[offset] : '\0';
+			switch (value) {
+			case '\"': skip_string(str, offset); return;
+			case '{':
+			case '[': {
+				char close = value == '{' ? '}' : ']';
+				consume_ws(str, ++offset);
+				if (str[offset] == close)
+				{
+					++offset;
+					return;
+				}
+				while (true)
+				{
+					if (value == '{')
+					{
+						consume_ws(str, offset);
+						if (str[offset] != '\"')
+						{
+							std::stringstream ss;
+							ss << "ERROR: Object: Expected '\"', found '" << str[offset] << "'.";
+							throw std::invalid_argument(ss.str());
+						}
+						skip_string(str, offset);
+						consume_ws(str, offset);
+						if (str[offset] != ':')
+						{
+							std::stringstream ss;
+							ss << "Error: Object: Expected ':', found '" << str[offset] << "'.";
+							throw std::invalid_argument(ss.str());
+						}
+						++offset;
+					}
+					skip_next(str, offset);
+					consume_ws(str, offset);
+					if (str[offset] == ',')
+						++offset;
+					else if (str[offset] == close)
+					{
+						++offset;
+						return;
+					}
+					else
+					{
+						std::stringstream ss;
+						ss << "ERROR: Expected ',' or '" << close << "', found '" << str[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+				}
+			}
+			case 't':
+			case 'f': parse_bool(str, offset); return;
+			case 'n': parse_null(str, offset); return;
+			default: if ((value <= '9' && value >= '0') || value == '-')
+			{
+				parse_number(str, offset);
+				return;
+			}
+			}
+
+			std::stringstream ss;
+			ss << "ERROR: Parse: Unknown starting character '" << value << "'.";
+			throw std::invalid_argument(ss.str());
+		}
+
+		static void skip_string(const std::string_view &str, size_t &offset) {
+			for (size_t pos = offset + 1; pos < str.size(); ++pos)
+			{
+				if (str[pos] == '\\')
+					++pos;
+				else if (str[pos] == '\"')
+				{
+					offset = pos + 1;
+					return;
+				}
+			}
+			offset = str.size();
+			throw std::invalid_argument("ERROR: String: Expected '\"', found end of input.");
+		}
+
+		//按投影解析一个值，值的类型与投影不符（需要子字段的位置为数字、字符串等）时跳过并返回false
+		static bool parse_projected(const std::string_view &str, size_t &offset, const Projection::Node& node, Value& out) {
+			if (node.all)
+			{
+				out = parse_next(str, offset, nullptr);
+				return true;
+			}
+			char c = str[offset];
+			if (c == '{')
+			{
+				out = Value::Make(emJsonType::Object);
+				consume_ws(str, ++offset);
+				if (str[offset] == '}')
+				{
+					++offset;
+					return true;
+				}
+				std::string strKey;
+				while (true)
+				{
+					//不含转义字符的键直接与投影比较，不复制
+					const Projection::Node* pChild = nullptr;
+					size_t keyEnd = str[offset] == '\"' ? string_end(str.data(), str.size(), offset) : offset;
+					std::string_view rawKey = str.substr(offset + 1, keyEnd > offset ? keyEnd - offset - 2 : 0);
+					if (keyEnd > offset && rawKey.find('\\') == std::string_view::npos)
+					{
+						pChild = node.find(rawKey);
+						if (pChild != nullptr)
+							strKey.assign(rawKey.data(), rawKey.size());
+						offset = keyEnd;
+					}
+					else
+					{
+						parse_key(str, offset, strKey);
+						pChild = node.find(strKey);
+					}
+					consume_ws(str, offset);
+					if (str[offset] != ':')
+					{
+						std::stringstream ss;
+						ss << "Error: Object: Expected ':', found '" << str[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+					consume_ws(str, ++offset);
+					Value child;
+					if (pChild == nullptr)
+						skip_fast(str, offset);
+					else if (parse_projected(str, offset, *pChild, child))
+						(*out.Internal.Map)[strKey] = std::move(child);
+
+					consume_ws(str, offset);
+					if (str[offset] == ',')
+						consume_ws(str, ++offset);
+					else if (str[offset] == '}')
+					{
+						++offset;
+						return true;
+					}
+					else
+					{
+						std::stringstream ss;
+						ss << "ERROR: Object: Expected ',' or '}', found '" << str[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+				}
+			}
+			if (c == '[')
+			{
+				out = Value::Make(emJsonType::Array);
+				consume_ws(str, ++offset);
+				if (str[offset] == ']')
+				{
+					++offset;
+					return true;
+				}
+				while (true)
+				{
+					Value child;
+					if (parse_projected(str, offset, node, child))
+						out.Internal.List->push_back(std::move(child));
+
+					consume_ws(str, offset);
+					if (str[offset] == ',')
+						consume_ws(str, ++offset);
+					else if (str[offset] == ']')
+					{
+						++offset;
+						return true;
+					}
+					else
+					{
+						std::stringstream ss;
+						ss << "ERROR: Array: Expected ',' or ']', found '" << str[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+				}
+			}
+			skip_fast(str, offset);
+			return false;
+		}
+
+		//跳过一个值；对象和数组只匹配括号、字符串和注释，不检查内容的格式，用于跳过不需要的子树
+		static void skip_fast(const std::string_view &str, size_t &offset) {
+			consume_ws(str, offset);
+			char c = offset < str.size() ? str[offset] : '\0';
+			if (c == '{' || c == '[')
+				skip_container(str, offset);
+			else if (c == '\"')
+				offset = string_end(str.data(), str.size(), offset);
+			else if ((c >= '0' && c <= '9') || c == '-' || c == 't' || c == 'f' || c == 'n')
+			{
+				//数字、true、false、null直接找到分隔符
+				while (offset < str.size() && !isspace(static_cast<unsigned char>(str[offset])) && str[offset] != ','
+					&& str[offset] != ']' && str[offset] != '}' && str[offset] != '/' && str[offset] != '#')
+					++offset;
+			}
+			else
+				skip_next(str, offset);
+		}
+
+		static void skip_container(const std::string_view &str, size_t &offset) {
+			const char* pData = str.data();
+			size_t size = str.size();
+			size_t pos = offset;
+			size_t depth = 0;
+			while (pos < size)
+			{
+#if defined(MMR_JSON_SIMD_SSE2)
+				//16字节中没有引号、括号和注释时整体跳过；'['、']'与0x20或运算后分别为'{'、'}'
+				const __m128i lowerBit = _mm_set1_epi8(0x20);
+				while (pos + 16 <= size)
+				{
+					__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + pos));
+					__m128i lower = _mm_or_si128(chunk, lowerBit);
+					__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}')));
+					hit = _mm_or_si128(hit, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\"')));
+					hit = _mm_or_si128(hit, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('/')));
+					hit = _mm_or_si128(hit, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('#')));
+					unsigned bits = static_cast<unsigned>(_mm_movemask_epi8(hit));
+					if (bits == 0)
+					{
+						pos += 16;
+						continue;
+					}
+					while ((bits & 1) == 0)
+					{
+						bits >>= 1;
+						++pos;
+					}
+					break;
+				}
+				if (pos >= size)
+					break;
+#endif
+				switch (pData[pos]) {
+				case '{':
+				case '[':
+					++depth;
+					break;
+				case '}':
+				case ']':
+					if (--depth == 0)
+					{
+						offset = pos + 1;
+						return;
+					}
+					break;
+				case '\"':
+					pos = string_end(pData, size, pos);
+					continue;
+				case '#':
+					pos = find_end(str, pos, "\n", 1);
+					continue;
+				case '/':
+					if (pos + 1 < size && pData[pos + 1] == '/')
+					{
+						pos = find_end(str, pos, "\n", 1);
+						continue;
+					}
+					if (pos + 1 < size && pData[pos + 1] == '*')
+					{
+						pos = find_end(str, pos + 2, "*/", 2);
+						continue;
+					}
+					break;
+				default:
+					break;
+				}
+				++pos;
+			}
+			offset = size;
+			throw std::invalid_argument("ERROR: Expected ']' or '}', found end of input.");
 		}
 
-		static Value parse_string(const std::string_view &str, size_t &offset) {
-			Value String;
-			std::string val;
-			for (char c = str[++offset]; c != '\"'; c = str[++offset])
+		//pos指向起始引号，返回结束引号的下一个位置；引号前连续的反斜杠为奇数个时为转义
+		static size_t string_end(const char* pData, size_t size, size_t pos) {
+			for (size_t cur = pos + 1; cur < size; ++cur)
 			{
-				if (c == '\\') {
-					switch (str[++offset]) {
-					case '\"': val += '\"'; break;
-					case '\\': val += '\\'; break;
-					case '/': val += '/'; break;
-					case 'b': val += '\b'; break;
-					case 'f': val += '\f'; break;
-					case 'n': val += '\n'; break;
-					case 'r': val += '\r'; break;
-					case 't': val += '\t'; break;
-					case 'u': {
-						val += "\\u";
-						for (unsigned i = 1; i <= 4; ++i) {
-							c = str[offset + i];
-							if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))
-								val += c;
-							else {
-								std::stringstream ss;
-								ss << "ERROR: String: Expected hex character in unicode escape, found '" << c << "'.";
-								throw std::invalid_argument(ss.str());
-							}
-						}
-						offset += 4;
-					} break;
-					default: val += '\\'; break;
-					}
-				}
-				else
-					val += c;
+				const char* pQuote = static_cast<const char*>(memchr(pData + cur, '\"', size - cur));
+				if (pQuote == nullptr)
+					break;
+				cur = static_cast<size_t>(pQuote - pData);
+				size_t slash = 0;
+				while (cur - slash > pos + 1 && pData[cur - slash - 1] == '\\')
+					++slash;
+				if (slash % 2 == 0)
+					return cur + 1;
 			}
-			++offset;
-			String = val;
-			return String;
+			throw std::invalid_argument("ERROR: String: Expected '\"', found end of input.");
+		}
+
+		static size_t find_end(const std::string_view &str, size_t pos, const char* pEnd, size_t len) {
+			size_t found = str.find(pEnd, pos, len);
+			return found == std::string_view::npos ? str.size() : found + len;
 		}
 
 		static Value parse_number(const std::string_view &str, size_t &offset) {
+			auto at = [&str](size_t pos) { return pos < str.size() ? str[pos] : '\0'; };//超出末尾时与'\0'结尾的字符串一致
+			//常见格式（-?[0-9]+、-?[0-9]+.[0-9]+）直接转换，不生成临时字符串
+			{
+				size_t pos = offset;
+				bool bNeg = at(pos) == '-';
+				if (bNeg)
+					++pos;
+				size_t intBegin = pos;
+				while (at(pos) >= '0' && at(pos) <= '9') ++pos;
+				size_t intDigits = pos - intBegin;
+				bool bFrac = false;
+				if (intDigits > 0 && at(pos) == '.')
+				{
+					size_t fracBegin = ++pos;
+					while (at(pos) >= '0' && at(pos) <= '9') ++pos;
+					bFrac = pos > fracBegin;
+					if (!bFrac)
+						intDigits = 0;//交给通用流程处理
+				}
+				char c = at(pos);
+				if (intDigits > 0 && (isspace(c) || c == ',' || c == ']' || c == '}' || c == '#' || c == '/'))
+				{
+					if (!bFrac && intDigits <= 18)
+					{
+						int64_t lData = 0;
+						for (size_t i = intBegin; i < pos; ++i)
+							lData = lData * 10 + (str[i] - '0');
+						offset = pos;
+						return Value(bNeg ? -lData : lData);
+					}
+					if (bFrac && pos - offset < 64)
+					{
+						char buf[64];
+						memcpy(buf, str.data() + offset, pos - offset);
+						buf[pos - offset] = '\0';
+						offset = pos;
+						return Value(strtod(buf, nullptr));
+					}
+				}
+			}
+
 			Value Number;
 			std::string val, exp_str;
 			char c;
 			bool isDouble = false;
 			int64_t exp = 0;
 			while (true) {
-				c = str[offset++];
+				c = at(offset++);
 				if ((c == '-') || (c >= '0' && c <= '9'))
 					val += c;
 				else if (c == '.') {
@@ -961,10 +3229,10 @@ namespace Json
 					break;
 			}
 			if (c == 'E' || c == 'e') {
-				c = str[offset++];
+				c = at(offset++);
 				if (c == '-') { ++offset; exp_str += '-'; }
 				while (true) {
-					c = str[offset++];
+					c = at(offset++);
 					if (c >= '0' && c <= '9')
 						exp_str += c;
 					else if (!isspace(c) && c != ',' && c != ']' && c != '}') {
@@ -1030,8 +3298,613 @@ namespace Json
 			return Null;
 		}
 	private:
+		static constexpr size_t PACKED_ARRAY_MIN = 16;//解析时元素个数达到该值的数字数组使用紧凑存储
+		static constexpr size_t SHAPE_KEYS_MAX = 64;//键个数超过该值的对象不使用形状
+		static constexpr size_t SHAPE_CACHE_MAX = 8;//一次解析中缓存的形状个数
+
 		BackingData Internal;	//internal data
 		emJsonType Type = emJsonType::Null;
+		emArrayStorage Storage = emArrayStorage::Generic;//Type为Array时有效
+		emObjectStorage ObjStorage = emObjectStorage::Generic;//Type为Object时有效
+
+		//const接口中不存在的元素
+		static const Value& null_value() {
+			static const Value s_null;
+			return s_null;
+		}
+	};
+
+	//只读对象迭代器，解引用得到键和值的引用，与std::map的遍历顺序一致
+	//解引用返回const的pair，for (auto& kv : ...)、for (const auto& kv : ...)都可以绑定
+	class Value::ConstObjectIterator
+	{
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = std::pair<const std::string&, const Value&>;
+		using difference_type = std::ptrdiff_t;
+		using reference = const value_type;
+
+		struct pointer {//operator->返回的代理
+			value_type member;
+			const value_type* operator->() const { return &member; }
+		};
+
+		ConstObjectIterator() = default;
+		explicit ConstObjectIterator(ObjectType::const_iterator iter) : m_iter(iter), m_bShaped(false) {}
+		ConstObjectIterator(const ShapedRecord* pRecord, size_t pos) : m_pRecord(pRecord), m_pos(pos) {}
+
+		reference operator*() const {
+			if (!m_bShaped)
+				return value_type(m_iter->first, m_iter->second);
+			const ObjectShape& shape = *m_pRecord->Shape;
+			uint32_t slot = shape.sorted_slots()[m_pos];
+			return value_type(shape.key(slot).str(), m_pRecord->Slots[slot]);
+		}
+		pointer operator->() const { return pointer{ **this }; }
+
+		ConstObjectIterator& operator++() { if (m_bShaped) ++m_pos; else ++m_iter; return *this; }
+		ConstObjectIterator operator++(int) { ConstObjectIterator tmp(*this); ++(*this); return tmp; }
+		ConstObjectIterator& operator--() { if (m_bShaped) --m_pos; else --m_iter; return *this; }
+		ConstObjectIterator operator--(int) { ConstObjectIterator tmp(*this); --(*this); return tmp; }
+
+		bool operator==(const ConstObjectIterator& other) const { return m_bShaped ? m_pos == other.m_pos : m_iter == other.m_iter; }
+		bool operator!=(const ConstObjectIterator& other) const { return !(*this == other); }
+
+	private:
+		ObjectType::const_iterator m_iter;
+		const ShapedRecord* m_pRecord = nullptr;
+		size_t m_pos = 0;
+		bool m_bShaped = true;//不是对象时为空的形状范围
+	};
+
+	class Value::ConstObjectRange
+	{
+	public:
+		explicit ConstObjectRange(const Value* pObject) : m_pObject(pObject) {}//不是对象时为nullptr，范围为空
+
+		ConstObjectIterator begin() const {
+			if (m_pObject == nullptr)
+				return ConstObjectIterator();
+			if (m_pObject->ObjStorage == emObjectStorage::Shaped)
+				return ConstObjectIterator(m_pObject->Internal.Record, 0);
+			return ConstObjectIterator(m_pObject->Internal.Map->cbegin());
+		}
+		ConstObjectIterator end() const {
+			if (m_pObject == nullptr)
+				return ConstObjectIterator();
+			if (m_pObject->ObjStorage == emObjectStorage::Shaped)
+				return ConstObjectIterator(m_pObject->Internal.Record, m_pObject->Internal.Record->Slots.size());
+			return ConstObjectIterator(m_pObject->Internal.Map->cend());
+		}
+		size_t size() const { return m_pObject != nullptr ? static_cast<size_t>(m_pObject->size()) : 0; }
+		bool empty() const { return size() == 0; }
+
+	private:
+		const Value* m_pObject;
+	};
+
+	inline Value::ConstObjectRange Value::ObjectRange() const {
+		return ConstObjectRange(Type == emJsonType::Object ? this : nullptr);
+	}
+
+	//直接输出Json文本，不构建Json::Value，输出格式与dumpFast一致
+	class Writer
+	{
+	public:
+		explicit Writer(std::string& strOut) : m_strOut(strOut), m_bFirst(true) {}
+
+		std::string& str() { return m_strOut; }
+
+		void beginObject() { separate(); m_strOut.push_back('{'); m_bFirst = true; }
+		void endObject() { m_strOut.push_back('}'); m_bFirst = false; }
+		void beginArray() { separate(); m_strOut.push_back('['); m_bFirst = true; }
+		void endArray() { m_strOut.push_back(']'); m_bFirst = false; }
+
+		//键不需要转义时使用，如结构体成员名称
+		void writeKey(const char* data, size_t len) {
+			separate();
+			m_strOut.push_back('\"');
+			m_strOut.append(data, len);
+			m_strOut.append("\":");
+			m_bFirst = true;//键后的值前面不加逗号
+		}
+
+		void writeKey(const std::string& key) {
+			if (Value::need_escape(key))
+			{
+				std::string strKey = Value::json_escape(key);
+				writeKey(strKey.data(), strKey.size());
+			}
+			else
+				writeKey(key.data(), key.size());
+		}
+
+		void writeNull() { separate(); m_strOut.append("null"); }
+
+		template <typename T>
+		typename std::enable_if<is_bool_v<T>>::type writeValue(T b) {
+			separate(); m_strOut.append(b ? "true" : "false");
+		}
+
+		template <typename T>
+		typename std::enable_if<is_int_v<T>>::type writeValue(T i) {
+			separate(); Value::append_number(m_strOut, static_cast<int64_t>(i));
+		}
+
+		template <typename T>
+		typename std::enable_if<is_uint64_v<T>>::type writeValue(T i) {
+			separate(); Value::append_number(m_strOut, static_cast<uint64_t>(i));
+		}
+
+		template <typename T>
+		typename std::enable_if<is_double_v<T>>::type writeValue(T f) {
+			separate(); Value::append_number(m_strOut, static_cast<double>(f));
+		}
+
+		void writeValue(const std::string& str) {
+			separate();
+			m_strOut.push_back('\"');
+			if (Value::need_escape(str))
+				m_strOut.append(Value::json_escape(str));
+			else
+				m_strOut.append(str);
+			m_strOut.push_back('\"');
+		}
+
+		void writeValue(const char* str) { writeValue(std::string(str)); }
+
+		//字符串不需要转义时使用，如格式化的时间，不构造std::string
+		void writeString(const char* data, size_t len) {
+			separate();
+			m_strOut.push_back('\"');
+			m_strOut.append(data, len);
+			m_strOut.push_back('\"');
+		}
+
+		void writeValue(const Value& jvData) { separate(); jvData.dumpFast(m_strOut); }
+
+		//二进制数据按Base64字符串输出，直接编码到输出缓冲区
+		void writeBase64(const void* pData, size_t len) {
+			separate();
+			m_strOut.push_back('\"');
+			size_t offset = m_strOut.size();
+			m_strOut.resize(offset + base64::encoded_size(len));
+			base64::encode(static_cast<const uint8_t*>(pData), len, &m_strOut[offset]);
+			m_strOut.push_back('\"');
+		}
+
+		//写入已经生成的Json文本，可以是逗号分隔的多个值，用于拼接分块输出的数组，空文本时不写入
+		void writeRaw(const std::string& strJson) {
+			if (strJson.empty())
+				return;
+			separate();
+			m_strOut.append(strJson);
+		}
+
+	private:
+		void separate() {
+			if (!m_bFirst)
+				m_strOut.push_back(',');
+			m_bFirst = false;
+		}
+
+		std::string& m_strOut;
+		bool m_bFirst;//当前对象或数组中还没有输出元素
+	};
+
+	//按顺序读取Json文本，不构建Json::Value，用于直接解析到结构体
+	class Reader
+	{
+	public:
+		explicit Reader(const std::string_view& str) : m_str(str), m_offset(0) {}
+
+		const std::string_view& str() const { return m_str; }
+		size_t offset() const { return m_offset; }
+
+		//回到之前通过offset()得到的位置，用于先查找对象中的某个键再从头读取
+		void seek(size_t offset) { m_offset = offset; }
+
+		//跳过空白及注释，返回下一个字符，结束时返回'\0'
+		char peek() {
+			Value::consume_ws(m_str, m_offset);
+			return m_offset < m_str.size() ? m_str[m_offset] : '\0';
+		}
+
+		//下一个值为null时读取并返回true
+		bool readNull() {
+			if (peek() != 'n')
+				return false;
+			Value::parse_null(m_str, m_offset);
+			return true;
+		}
+
+		//读取'{'，对象为空时同时读取'}'并返回false
+		bool beginObject() { return begin('{', '}'); }
+		bool beginArray() { return begin('[', ']'); }
+
+		//读取对象的键及':'，键与Json::Value一致保存转义后的形式
+		void readKey(std::string& strKey) {
+			Value::parse_key(m_str, m_offset, strKey);
+			char c = peek();
+			if (c != ':')
+			{
+				std::stringstream ss;
+				ss << "Error: Object: Expected ':', found '" << c << "'.";
+				throw std::invalid_argument(ss.str());
+			}
+			++m_offset;
+		}
+
+		//读取','返回true，读取结束符返回false
+		bool nextElement(char close) {
+			char c = peek();
+			if (c == ',')
+			{
+				++m_offset;
+				return true;
+			}
+			if (c == close)
+			{
+				++m_offset;
+				return false;
+			}
+			std::stringstream ss;
+			ss << "ERROR: Expected ',' or '" << close << "', found '" << c << "'.";
+			throw std::invalid_argument(ss.str());
+		}
+
+		Value readValue() { return Value::parse_next(m_str, m_offset); }
+
+		//下一个值须为字符串，与Value::get<std::string>()一致返回转义后的形式
+		void readString(std::string& strVal) {
+			peek();
+			strVal.clear();
+			Value::parse_string_raw(m_str, m_offset, strVal);
+			if (Value::need_escape(strVal))
+				strVal = Value::json_escape(strVal);
+		}
+
+		//下一个值须为字符串，与Value::str_view()一致返回未转义的内容
+		void readStringRaw(std::string& strVal) {
+			peek();
+			strVal.clear();
+			Value::parse_string_raw(m_str, m_offset, strVal);
+		}
+
+		//下一个值为不含转义字符的字符串时返回原文中的内容，不复制；含转义字符时不读取并返回false
+		bool readStringView(std::string_view& view) {
+			char c = peek();
+			if (c != '\"')
+			{
+				std::stringstream ss;
+				ss << "ERROR: Expected '\"', found '" << c << "'.";
+				throw std::invalid_argument(ss.str());
+			}
+			size_t end = m_str.find('\"', m_offset + 1);
+			if (end == std::string_view::npos)
+				throw std::invalid_argument("ERROR: String: Expected '\"', found end of input.");
+			std::string_view content = m_str.substr(m_offset + 1, end - m_offset - 1);
+			if (content.find('\\') != std::string_view::npos)
+				return false;
+			view = content;
+			m_offset = end + 1;
+			return true;
+		}
+
+		void skipValue() { Value::skip_next(m_str, m_offset); }
+
+		//检查是否还有多余的内容
+		void finish() {
+			if (peek() != '\0')
+				throw std::out_of_range("more than one object.");
+		}
+
+	private:
+		bool begin(char open, char close) {
+			char c = peek();
+			if (c != open)
+			{
+				std::stringstream ss;
+				ss << "ERROR: Expected '" << open << "', found '" << c << "'.";
+				throw std::invalid_argument(ss.str());
+			}
+			++m_offset;
+			if (peek() == close)
+			{
+				++m_offset;
+				return false;
+			}
+			return true;
+		}
+
+		std::string_view m_str;
+		size_t m_offset;
+	};
+
+	//JSON Pointer（RFC 6901），构造时解析路径并预先计算每一级键的哈希，重复查找时不再构造临时字符串
+	class Pointer
+	{
+	public:
+		struct Segment
+		{
+			static constexpr uint32_t npos = 0xFFFFFFFF;
+
+			std::string key;		//与Json::Value中保存的键形式一致（转义后的形式）
+			uint64_t hash = 0;		//key_hash(key)
+			uint32_t index = npos;	//可作为数组下标时的值，"-"或非数字时为npos
+			bool append = false;	//"-"，表示数组末尾之后的位置
+
+			bool operator==(const Segment& other) const { return key == other.key; }
+		};
+
+		Pointer() = default;//空路径，指向根节点
+
+		//路径格式错误时抛出std::invalid_argument
+		explicit Pointer(const std::string_view& path) {
+			std::string strErr = load(path);
+			if (!strErr.empty())
+				throw std::invalid_argument(strErr);
+		}
+
+		//解析路径，失败时返回错误信息且不改变原有路径
+		std::string load(const std::string_view& path) {
+			std::vector<Segment> vecSegments;
+			if (!path.empty() && path[0] != '/')
+				return "JSON pointer must be empty or start with '/'.";
+			size_t pos = 0;
+			while (pos < path.size())
+			{
+				size_t end = path.find('/', pos + 1);
+				if (end == std::string_view::npos)
+					end = path.size();
+				Segment seg;
+				for (size_t i = pos + 1; i < end; ++i)
+				{
+					if (path[i] != '~')
+					{
+						seg.key.push_back(path[i]);
+						continue;
+					}
+					if (i + 1 < end && (path[i + 1] == '0' || path[i + 1] == '1'))
+						seg.key.push_back(path[++i] == '0' ? '~' : '/');
+					else
+						return "JSON pointer has invalid escape at offset " + std::to_string(i) + ".";
+				}
+				seg.index = parse_index(seg.key);
+				seg.append = seg.key == "-";
+				if (Value::need_escape(seg.key))
+					seg.key = Value::json_escape(seg.key);
+				seg.hash = key_hash(seg.key.data(), seg.key.size());
+				vecSegments.push_back(std::move(seg));
+				pos = end;
+			}
+			m_vecSegments = std::move(vecSegments);
+			return std::string();
+		}
+
+		size_t size() const { return m_vecSegments.size(); }
+		bool empty() const { return m_vecSegments.empty(); }
+		const Segment& operator[](size_t idx) const { return m_vecSegments[idx]; }
+		const std::vector<Segment>& segments() const { return m_vecSegments; }
+
+		//还原为路径字符串
+		std::string toString() const {
+			std::string strRet;
+			for (const auto& seg : m_vecSegments)
+			{
+				strRet.push_back('/');
+				std::string strRaw = seg.key;
+				if (strRaw.find('\\') != std::string::npos)
+				{
+					std::string strQuoted = "\"" + strRaw + "\"";
+					size_t offset = 0;
+					strRaw.clear();
+					Value::parse_string_raw(strQuoted, offset, strRaw);
+				}
+				for (char c : strRaw)
+				{
+					if (c == '~')
+						strRet.append("~0");
+					else if (c == '/')
+						strRet.append("~1");
+					else
+						strRet.push_back(c);
+				}
+			}
+			return strRet;
+		}
+
+		//查找路径指向的值，不存在时返回nullptr，不会插入数据；与const operator[]一致不展开紧凑存储的数组，多线程只读访问安全
+		const Value* resolve(const Value& root) const {
+			return resolve_from(&root, 0, m_vecSegments.size());
+		}
+
+		//非const查找，经过紧凑存储的数组时转换为通用存储，返回的指针可以修改
+		Value* resolve(Value& root) const {
+			return resolve_from(&root, 0, m_vecSegments.size());
+		}
+
+		//与非const的operator[]一致，不存在的键或下标自动创建，其它类型的节点转换为对象
+		//数组以及值为null的节点上的数字下标和"-"按数组处理，"-"在数组末尾追加一个元素
+		Value& resolveOrCreate(Value& root) const {
+			Value* pCur = &root;
+			for (const auto& seg : m_vecSegments)
+			{
+				bool isArray = pCur->Type == emJsonType::Array
+					|| (pCur->Type == emJsonType::Null && (seg.append || seg.index != Segment::npos));
+				if (isArray && (seg.append || seg.index != Segment::npos))
+				{
+					pCur->SetType(emJsonType::Array);
+					pCur->unpack_array();
+					if (seg.append)
+					{
+						pCur->Internal.List->emplace_back();
+						pCur = &pCur->Internal.List->back();
+					}
+					else
+						pCur = &(*pCur)[seg.index];
+				}
+				else if (Value* pNext = find_child(*pCur, seg))
+					pCur = pNext;
+				else
+					pCur = &(*pCur)[seg.key];
+			}
+			return *pCur;
+		}
+
+		//从pStart开始依次查找[first, last)中的各级；紧凑存储的数组元素是数字，只会是最后一级
+		const Value* resolve_from(const Value* pStart, size_t first, size_t last) const {
+			const Value* pCur = pStart;
+			for (size_t i = first; i < last && pCur != nullptr; ++i)
+				pCur = find_child(*pCur, m_vecSegments[i]);
+			return pCur;
+		}
+
+		Value* resolve_from(Value* pStart, size_t first, size_t last) const {
+			Value* pCur = pStart;
+			for (size_t i = first; i < last && pCur != nullptr; ++i)
+				pCur = find_child(*pCur, m_vecSegments[i]);
+			return pCur;
+		}
+
+		bool operator==(const Pointer& other) const { return m_vecSegments == other.m_vecSegments; }
+		bool operator!=(const Pointer& other) const { return !(*this == other); }
+
+		//查找一级，对象按键查找，数组按下标查找；紧凑存储的数组与const operator[]一致返回只读副本中的元素
+		static const Value* find_child(const Value& jvData, const Segment& seg) {
+			if (jvData.Type == emJsonType::Array)
+				return seg.index != Segment::npos && seg.index < static_cast<uint32_t>(jvData.array_size()) ? &jvData[seg.index] : nullptr;
+			return find_key(jvData, seg);
+		}
+
+		static Value* find_child(Value& jvData, const Segment& seg) {
+			if (jvData.Type == emJsonType::Array)
+			{
+				if (seg.index == Segment::npos || seg.index >= static_cast<uint32_t>(jvData.array_size()))
+					return nullptr;
+				jvData.unpack_array();
+				return &(*jvData.Internal.List)[seg.index];
+			}
+			return find_key(jvData, seg);
+		}
+
+	private:
+		template<typename _Value>
+		static _Value* find_key(_Value& jvData, const Segment& seg) {
+			if (jvData.Type != emJsonType::Object)
+				return nullptr;
+			if (jvData.ObjStorage == emObjectStorage::Shaped)
+			{
+				uint32_t slot = jvData.Internal.Record->Shape->slot(seg.key, seg.hash);
+				return slot == ObjectShape::npos ? nullptr : &jvData.Internal.Record->Slots[slot];
+			}
+			auto iter = jvData.Internal.Map->find(seg.key);
+			return iter == jvData.Internal.Map->end() ? nullptr : &iter->second;
+		}
+
+		//RFC 6901的数组下标：十进制数字，除"0"外不能以0开头
+		static uint32_t parse_index(const std::string& key) {
+			if (key.empty() || key.size() > 9 || (key.size() > 1 && key[0] == '0'))
+				return Segment::npos;
+			uint32_t index = 0;
+			for (char c : key)
+			{
+				if (c < '0' || c > '9')
+					return Segment::npos;
+				index = index * 10 + static_cast<uint32_t>(c - '0');
+			}
+			return index;
+		}
+
+		std::vector<Segment> m_vecSegments;
+	};
+
+	inline void Projection::add(const std::string_view& path) {
+		std::vector<std::string> vecKeys;
+		if (!path.empty() && path[0] == '/')
+		{
+			Pointer ptr(path);
+			for (const auto& seg : ptr.segments())
+				vecKeys.push_back(seg.key);
+		}
+		else
+		{
+			size_t pos = 0;
+			while (pos <= path.size())
+			{
+				size_t end = path.find('.', pos);
+				if (end == std::string_view::npos)
+					end = path.size();
+				std::string strKey(path.data() + pos, end - pos);
+				vecKeys.push_back(Value::need_escape(strKey) ? Value::json_escape(strKey) : strKey);
+				pos = end + 1;
+			}
+		}
+		add_keys(vecKeys);
+	}
+
+	//批量查找多个路径，路径按各级排序，相同的前缀只查找一次
+	class PointerBatch
+	{
+	public:
+		PointerBatch() = default;
+
+		explicit PointerBatch(std::vector<Pointer> vecPointers) : m_vecPointers(std::move(vecPointers)) {
+			m_vecOrder.resize(m_vecPointers.size());
+			for (size_t i = 0; i < m_vecOrder.size(); ++i)
+				m_vecOrder[i] = i;
+			std::sort(m_vecOrder.begin(), m_vecOrder.end(), [this](size_t lhs, size_t rhs) {
+				const auto& lSegs = m_vecPointers[lhs].segments();
+				const auto& rSegs = m_vecPointers[rhs].segments();
+				return std::lexicographical_compare(lSegs.begin(), lSegs.end(), rSegs.begin(), rSegs.end(),
+					[](const Pointer::Segment& l, const Pointer::Segment& r) { return l.key < r.key; });
+			});
+			m_vecShared.resize(m_vecOrder.size(), 0);
+			for (size_t i = 1; i < m_vecOrder.size(); ++i)
+			{
+				const auto& prev = m_vecPointers[m_vecOrder[i - 1]].segments();
+				const auto& cur = m_vecPointers[m_vecOrder[i]].segments();
+				size_t shared = 0;
+				while (shared < prev.size() && shared < cur.size() && prev[shared] == cur[shared])
+					++shared;
+				m_vecShared[i] = shared;
+			}
+		}
+
+		size_t size() const { return m_vecPointers.size(); }
+		const Pointer& operator[](size_t idx) const { return m_vecPointers[idx]; }
+
+		//结果与构造时的路径一一对应，不存在的路径为nullptr；与Pointer::resolve一致不展开紧凑存储的数组
+		void resolve(const Value& root, std::vector<const Value*>& vecOut) const {
+			vecOut.assign(m_vecPointers.size(), nullptr);
+			std::vector<const Value*> vecPath(1, &root);//vecPath[i]为前一个路径前i级指向的值
+			for (size_t i = 0; i < m_vecOrder.size(); ++i)
+			{
+				const Pointer& ptr = m_vecPointers[m_vecOrder[i]];
+				size_t depth = (std::min)(m_vecShared[i], vecPath.size() - 1);
+				vecPath.resize(depth + 1);
+				for (size_t level = depth; level < ptr.size(); ++level)
+				{
+					const Value* pNext = Pointer::find_child(*vecPath.back(), ptr[level]);
+					if (pNext == nullptr)
+						break;
+					vecPath.push_back(pNext);
+				}
+				if (vecPath.size() == ptr.size() + 1)
+					vecOut[m_vecOrder[i]] = vecPath.back();
+			}
+		}
+
+		std::vector<const Value*> resolve(const Value& root) const {
+			std::vector<const Value*> vecOut;
+			resolve(root, vecOut);
+			return vecOut;
+		}
+
+	private:
+		std::vector<Pointer> m_vecPointers;
+		std::vector<size_t> m_vecOrder;		//按路径排序后的下标
+		std::vector<size_t> m_vecShared;	//与排序后前一个路径相同的级数
 	};
 
 }
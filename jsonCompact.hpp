@@ -0,0 +1,497 @@
+/**
+ * @file jsonCompact.hpp
+ * @brief 紧凑型Json值，类型标记与数据共同保存在一个8字节的字中
+ * @author Mounmory (237628106@qq.com) https://github.com/Mounmory
+ * @date
+ *
+ *
+ * Json::Value由16字节的联合体和类型字节组成，数组使用std::deque保存，大数字数组中每个元素都有额外开销
+ * CompactValue采用NaN-boxing方式：
+ * - double直接保存，NaN统一规范为正的quiet NaN
+ * - 其它类型保存在负的quiet NaN空间中，3位类型标记加48位负载
+ * - 48位能表示的整数直接保存，超出范围的int64/uint64保存在额外分配的槽中
+ * - 字符串、数组、对象保存为带标记的指针，数组使用std::vector<CompactValue>
+ */
+
+#ifndef MMR_UTIL_JSON_COMPACT_HPP
+#define MMR_UTIL_JSON_COMPACT_HPP
+#include "json.hpp"
+
+#include <vector>
+#include <cstring>
+
+namespace Json
+{
+	class CompactValue
+	{
+		static constexpr uint64_t BOX_PREFIX = 0xFFF8000000000000ull;//负的quiet NaN
+		static constexpr uint64_t CANONICAL_NAN = 0x7FF8000000000000ull;
+		static constexpr uint64_t PAYLOAD_MASK = 0x0000FFFFFFFFFFFFull;
+		static constexpr int TAG_SHIFT = 48;
+		static constexpr int64_t INLINE_INT_MIN = -(int64_t(1) << 47);
+		static constexpr int64_t INLINE_INT_MAX = (int64_t(1) << 47) - 1;
+
+		enum emTag : uint64_t {
+			TAG_NULL = 0,
+			TAG_BOOL,
+			TAG_INT,//48位有符号整数
+			TAG_UINT,//48位无符号整数
+			TAG_WIDE,//超出48位的整数，指向WideInt
+			TAG_STRING,
+			TAG_ARRAY,
+			TAG_OBJECT
+		};
+
+		struct WideInt {
+			emJsonType Type;
+			union {
+				int64_t Int;
+				uint64_t Uint64;
+			};
+		};
+
+	public:
+		using ArrayType = std::vector<CompactValue>;
+		using ObjectType = std::map<std::string, CompactValue>;
+
+		CompactValue() : m_bits(box(TAG_NULL, 0)) {}
+
+		CompactValue(std::nullptr_t) : CompactValue() {}
+
+		template <typename T>
+		CompactValue(T b, typename std::enable_if<is_bool_v<T>>::type* = 0)
+			: m_bits(box(TAG_BOOL, b ? 1 : 0)) {}
+
+		template <typename T>
+		CompactValue(T i, typename std::enable_if<is_int_v<T>>::type* = 0)
+			: m_bits(0) { setInt(static_cast<int64_t>(i)); }
+
+		template <typename T>
+		CompactValue(T i, typename std::enable_if<is_uint64_v<T>>::type* = 0)
+			: m_bits(0) { setUint(i); }
+
+		template <typename T>
+		CompactValue(T f, typename std::enable_if<is_double_v<T>>::type* = 0)
+			: m_bits(0) { setDouble(static_cast<double>(f)); }
+
+		template <typename T>
+		CompactValue(T&& s, typename std::enable_if<std::is_convertible<T, std::string>::value>::type* = 0)
+			: m_bits(boxPtr(TAG_STRING, std::make_unique<std::string>(std::forward<T>(s)))) {}
+
+		//由Json::Value转换
+		explicit CompactValue(const Value& jvData) : CompactValue() {
+			switch (jvData.Type) {
+			case emJsonType::Object: {
+				m_bits = boxPtr(TAG_OBJECT, std::make_unique<ObjectType>());
+				ObjectType* pMap = objectPtr();
+				jvData.for_each_member([pMap](const std::string& key, const Value& value) {
+					pMap->emplace_hint(pMap->end(), key, CompactValue(value));
+				});
+			}break;
+			case emJsonType::Array: {
+				m_bits = boxPtr(TAG_ARRAY, std::make_unique<ArrayType>());
+				ArrayType* pList = arrayPtr();
+				pList->reserve(jvData.size());
+				if (jvData.Storage == emArrayStorage::Int64)
+				{
+					for (auto iter : *jvData.Internal.IntList)
+						pList->emplace_back(iter);
+				}
+				else if (jvData.Storage == emArrayStorage::Double)
+				{
+					for (auto iter : *jvData.Internal.FloatList)
+						pList->emplace_back(iter);
+				}
+				else
+				{
+					for (const auto& iter : *jvData.Internal.List)
+						pList->emplace_back(iter);
+				}
+			}break;
+			case emJsonType::String: m_bits = boxPtr(TAG_STRING, std::make_unique<std::string>(*jvData.Internal.String)); break;
+			case emJsonType::Floating: setDouble(jvData.Internal.Float); break;
+			case emJsonType::Integral: setInt(jvData.Internal.Int); break;
+			case emJsonType::Uintegral: setUint(jvData.Internal.Uint64); break;
+			case emJsonType::Boolean: m_bits = box(TAG_BOOL, jvData.Internal.Bool ? 1 : 0); break;
+			default: break;
+			}
+		}
+
+		CompactValue(const CompactValue& other) : m_bits(box(TAG_NULL, 0)) {
+			copyFrom(other);
+		}
+
+		CompactValue(CompactValue&& other) noexcept : m_bits(std::exchange(other.m_bits, box(TAG_NULL, 0))) {}
+
+		CompactValue& operator = (const CompactValue& other) {
+			if (this != &other)
+			{
+				ClearInternal();
+				copyFrom(other);
+			}
+			return *this;
+		}
+
+		CompactValue& operator = (CompactValue&& other) noexcept {
+			if (this != &other)
+			{
+				ClearInternal();
+				m_bits = std::exchange(other.m_bits, box(TAG_NULL, 0));
+			}
+			return *this;
+		}
+
+		~CompactValue() {
+			ClearInternal();
+		}
+
+		void clear() {
+			ClearInternal();
+			m_bits = box(TAG_NULL, 0);
+		}
+
+		//转换为Json::Value
+		Value toValue() const {
+			switch (JSONType()) {
+			case emJsonType::Object: {
+				Value jvRet = Value::Make(emJsonType::Object);
+				for (const auto& iter : *objectPtr())
+					jvRet.Internal.Map->emplace_hint(jvRet.Internal.Map->end(), iter.first, iter.second.toValue());
+				return jvRet;
+			}
+			case emJsonType::Array: {
+				Value jvRet = Value::Make(emJsonType::Array);
+				for (const auto& iter : *arrayPtr())
+					jvRet.Internal.List->emplace_back(iter.toValue());
+				return jvRet;
+			}
+			case emJsonType::String: return Value(*stringPtr());
+			default: return scalar();
+			}
+		}
+
+		emJsonType JSONType() const {
+			if (!isBoxed())
+				return emJsonType::Floating;
+			switch (tag()) {
+			case TAG_BOOL: return emJsonType::Boolean;
+			case TAG_INT: return emJsonType::Integral;
+			case TAG_UINT: return emJsonType::Uintegral;
+			case TAG_WIDE: return static_cast<const WideInt*>(pointer())->Type;
+			case TAG_STRING: return emJsonType::String;
+			case TAG_ARRAY: return emJsonType::Array;
+			case TAG_OBJECT: return emJsonType::Object;
+			default: return emJsonType::Null;
+			}
+		}
+
+		bool IsNull() const { return m_bits == box(TAG_NULL, 0); }
+
+		template <typename T>
+		typename std::enable_if<is_bool_v<T>, CompactValue&>::type operator=(T b) {
+			ClearInternal(); m_bits = box(TAG_BOOL, b ? 1 : 0); return *this;
+		}
+
+		template <typename T>
+		typename std::enable_if<is_int_v<T>, CompactValue&>::type operator=(T i) {
+			ClearInternal(); setInt(static_cast<int64_t>(i)); return *this;
+		}
+
+		template <typename T>
+		typename std::enable_if<is_uint64_v<T>, CompactValue&>::type operator=(T i) {
+			ClearInternal(); setUint(i); return *this;
+		}
+
+		template <typename T>
+		typename std::enable_if<std::is_floating_point<T>::value, CompactValue&>::type operator=(T f) {
+			ClearInternal(); setDouble(static_cast<double>(f)); return *this;
+		}
+
+		template <typename T>
+		typename std::enable_if<std::is_convertible<T, std::string>::value, CompactValue&>::type operator=(T s) {
+			if (JSONType() == emJsonType::String)
+				*stringPtr() = std::string(s);
+			else
+			{
+				ClearInternal();
+				m_bits = boxPtr(TAG_STRING, std::make_unique<std::string>(s));
+			}
+			return *this;
+		}
+
+		template <typename T>
+		void append(T arg) {
+			SetType(emJsonType::Array); arrayPtr()->emplace_back(arg);
+		}
+
+		template <typename T, typename... U>
+		void append(T arg, U... args) {
+			append(arg); append(args...);
+		}
+
+		CompactValue& operator[](const std::string &key) {
+			SetType(emJsonType::Object); return objectPtr()->operator[](key);
+		}
+
+		CompactValue& operator[](unsigned index) {
+			SetType(emJsonType::Array);
+			if (index >= arrayPtr()->size()) arrayPtr()->resize(index + 1);
+			return arrayPtr()->operator[](index);
+		}
+
+		const CompactValue &at(const std::string &key) const {
+			if (JSONType() != emJsonType::Object)
+				throw std::out_of_range("key [" + key + "] do not exist.");
+			return objectPtr()->at(key);
+		}
+
+		const CompactValue &at(unsigned index) const {
+			if (JSONType() != emJsonType::Array)
+				throw std::out_of_range("index " + std::to_string(index) + " out of range.");
+			return arrayPtr()->at(index);
+		}
+
+		int length() const {
+			if (JSONType() == emJsonType::Array)
+				return arrayPtr()->size();
+			return -1;
+		}
+
+		bool hasKey(const std::string &key) const {
+			if (JSONType() == emJsonType::Object)
+				return objectPtr()->find(key) != objectPtr()->end();
+			return false;
+		}
+
+		int size() const {
+			switch (JSONType()) {
+			case emJsonType::Object: return objectPtr()->size();
+			case emJsonType::Array: return arrayPtr()->size();
+			default: return -1;
+			}
+		}
+
+		template<typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value, T>::type toNum() const { bool ret; return get<T>(ret); }
+
+		template<typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value || std::is_same<std::decay_t<T>, std::string>::value, T>::type get() const
+		{
+			bool bRet = false;
+			auto ret = get<std::decay_t<T>>(bRet);
+			if (false == bRet)
+			{
+				std::stringstream ss;
+				ss << "Json data [" << this->dumpFast() << "] convert to [" << typeid(T).name() << "] error." << std::endl;
+				throw std::runtime_error(ss.str());
+			}
+			return ret;
+		}
+
+		//转换规则与Json::Value一致
+		template<typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value, T>::type get(bool& bRet) const {
+			return scalar().template get<T>(bRet);
+		}
+
+		template<typename T>
+		typename std::enable_if<std::is_same<std::decay_t<T>, std::string>::value, std::string>::type
+			get(bool& bRet) const
+		{
+			bRet = JSONType() == emJsonType::String;
+			return bRet ? Value::json_escape(*stringPtr()) : std::string();
+		}
+
+		Value::JSONWrapper<ObjectType> ObjectRange() {
+			return Value::JSONWrapper<ObjectType>(JSONType() == emJsonType::Object ? objectPtr() : nullptr);
+		}
+
+		Value::JSONWrapper<ArrayType> ArrayRange() {
+			return Value::JSONWrapper<ArrayType>(JSONType() == emJsonType::Array ? arrayPtr() : nullptr);
+		}
+
+		Value::JSONConstWrapper<ObjectType> ObjectRange() const {
+			return Value::JSONConstWrapper<ObjectType>(JSONType() == emJsonType::Object ? objectPtr() : nullptr);
+		}
+
+		Value::JSONConstWrapper<ArrayType> ArrayRange() const {
+			return Value::JSONConstWrapper<ArrayType>(JSONType() == emJsonType::Array ? arrayPtr() : nullptr);
+		}
+
+		std::string dumpFast() const
+		{
+			std::string strRet;
+			strRet.reserve(256);
+			dumpFast(strRet);
+			return strRet;
+		}
+
+		//输出格式与Json::Value::dumpFast一致
+		template<typename _outType = std::string>
+		void dumpFast(_outType& strR) const {
+			switch (JSONType()) {
+			case emJsonType::Object: {
+				strR.append("{");
+				bool skip = true;
+				for (const auto& p : *objectPtr()) {
+					if (!skip)
+						strR.append(",");
+					strR.append("\"" + p.first + "\":");
+					p.second.dumpFast(strR);
+					skip = false;
+				}
+				strR.append("}");
+				break;
+			}
+			case emJsonType::Array: {
+				strR.append("[");
+				bool skip = true;
+				for (const auto& p : *arrayPtr())
+				{
+					if (!skip) strR.append(",");
+					p.dumpFast(strR);
+					skip = false;
+				}
+				strR.append("]");
+				break;
+			}
+			case emJsonType::String:
+				strR.append("\"" + Value::json_escape(*stringPtr()) + "\"");
+				break;
+			default:
+				scalar().dumpFast(strR);
+				break;
+			}
+		}
+
+	private:
+		static constexpr uint64_t box(uint64_t tag, uint64_t payload) {
+			return BOX_PREFIX | (tag << TAG_SHIFT) | (payload & PAYLOAD_MASK);
+		}
+
+		//检查通过后才释放所有权，地址超出48位时由unique_ptr释放内存
+		template <typename T>
+		static uint64_t boxPtr(uint64_t tag, std::unique_ptr<T> ptr) {
+			uint64_t addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr.get()));
+			if (addr & ~PAYLOAD_MASK)
+				throw std::runtime_error("CompactValue: pointer do not fit in 48 bits.");
+			ptr.release();
+			return box(tag, addr);
+		}
+
+		//非double值都保存在负的quiet NaN空间中
+		bool isBoxed() const { return (m_bits & BOX_PREFIX) == BOX_PREFIX; }
+
+		uint64_t tag() const { return (m_bits >> TAG_SHIFT) & 0x7; }
+
+		void* pointer() const { return reinterpret_cast<void*>(static_cast<uintptr_t>(m_bits & PAYLOAD_MASK)); }
+
+		std::string* stringPtr() const { return static_cast<std::string*>(pointer()); }
+		ArrayType* arrayPtr() const { return static_cast<ArrayType*>(pointer()); }
+		ObjectType* objectPtr() const { return static_cast<ObjectType*>(pointer()); }
+
+		void setDouble(double dData) {
+			if (dData != dData)
+				m_bits = CANONICAL_NAN;
+			else
+				memcpy(&m_bits, &dData, sizeof(m_bits));
+		}
+
+		void setInt(int64_t lData) {
+			if (lData >= INLINE_INT_MIN && lData <= INLINE_INT_MAX)
+				m_bits = box(TAG_INT, static_cast<uint64_t>(lData));
+			else
+			{
+				std::unique_ptr<WideInt> pWide = std::make_unique<WideInt>();
+				pWide->Type = emJsonType::Integral;
+				pWide->Int = lData;
+				m_bits = boxPtr(TAG_WIDE, std::move(pWide));
+			}
+		}
+
+		void setUint(uint64_t ulData) {
+			if (ulData <= PAYLOAD_MASK)
+				m_bits = box(TAG_UINT, ulData);
+			else
+			{
+				std::unique_ptr<WideInt> pWide = std::make_unique<WideInt>();
+				pWide->Type = emJsonType::Uintegral;
+				pWide->Uint64 = ulData;
+				m_bits = boxPtr(TAG_WIDE, std::move(pWide));
+			}
+		}
+
+		//48位有符号整数做符号扩展
+		int64_t inlineInt() const {
+			return static_cast<int64_t>((m_bits & PAYLOAD_MASK) << 16) >> 16;
+		}
+
+		//数字、布尔类型转为Json::Value，不涉及内存分配
+		Value scalar() const {
+			if (!isBoxed())
+			{
+				double dData = 0.0;
+				memcpy(&dData, &m_bits, sizeof(dData));
+				return Value(dData);
+			}
+			switch (tag()) {
+			case TAG_BOOL: return Value((m_bits & PAYLOAD_MASK) != 0);
+			case TAG_INT: return Value(inlineInt());
+			case TAG_UINT: return Value(static_cast<uint64_t>(m_bits & PAYLOAD_MASK));
+			case TAG_WIDE: {
+				const WideInt* pWide = static_cast<const WideInt*>(pointer());
+				if (pWide->Type == emJsonType::Uintegral)
+					return Value(pWide->Uint64);
+				return Value(pWide->Int);
+			}
+			default: return Value();
+			}
+		}
+
+		void copyFrom(const CompactValue& other) {
+			if (!other.isBoxed())
+			{
+				m_bits = other.m_bits;
+				return;
+			}
+			switch (other.tag()) {
+			case TAG_WIDE: m_bits = boxPtr(TAG_WIDE, std::make_unique<WideInt>(*static_cast<const WideInt*>(other.pointer()))); break;
+			case TAG_STRING: m_bits = boxPtr(TAG_STRING, std::make_unique<std::string>(*other.stringPtr())); break;
+			case TAG_ARRAY: m_bits = boxPtr(TAG_ARRAY, std::make_unique<ArrayType>(*other.arrayPtr())); break;
+			case TAG_OBJECT: m_bits = boxPtr(TAG_OBJECT, std::make_unique<ObjectType>(*other.objectPtr())); break;
+			default: m_bits = other.m_bits; break;
+			}
+		}
+
+		void SetType(emJsonType type) {
+			if (type == JSONType())
+				return;
+			ClearInternal();
+			switch (type) {
+			case emJsonType::Object: m_bits = boxPtr(TAG_OBJECT, std::make_unique<ObjectType>()); break;
+			case emJsonType::Array: m_bits = boxPtr(TAG_ARRAY, std::make_unique<ArrayType>()); break;
+			default: m_bits = box(TAG_NULL, 0); break;
+			}
+		}
+
+		void ClearInternal() {
+			if (!isBoxed())
+				return;
+			switch (tag()) {
+			case TAG_WIDE: delete static_cast<WideInt*>(pointer()); break;
+			case TAG_STRING: delete stringPtr(); break;
+			case TAG_ARRAY: delete arrayPtr(); break;
+			case TAG_OBJECT: delete objectPtr(); break;
+			default: break;
+			}
+			m_bits = box(TAG_NULL, 0);
+		}
+
+	private:
+		uint64_t m_bits;
+	};
+
+	static_assert(sizeof(CompactValue) == sizeof(uint64_t), "CompactValue must be 8 bytes");
+}
+
+#endif // !MMR_UTIL_JSON_COMPACT_HPP
@@ -12,8 +12,29 @@
 #include <memory>
 #include <string>
 #include <cstring>
+#include <cstddef>
 #include <vector>
 #include <list>
+#include <deque>
+#include <array>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <chrono>
+#include <utility>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <system_error>
+#include <stdexcept>
+#include <thread>
+
+//std::variant、std::byte需要C++17，C++14时不支持这两种类型的转换
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define MMR_JSON_CPP17
+#include <variant>
+#endif
 
 /*
 	JsonConverter实现通过宏定义，将结构体与Json之间实现轻松互转
@@ -24,8 +45,12 @@
 		- 已经定义了结构转化的其它结构体
 		- std::shared_ptr或std::unique_ptr类型，模板参数可以时基本数据类型及定义转换接口的结构体，对于继承类型，基类指针不会处理派生类数据类型
 		- std::optional，模板参数可以时基本数据类型及定义转换接口的结构体
-		- 数组（std::vector、std::list），模板参数可以时基本数据类型及定义转换接口的结构体
-		- std::map，key必须为std::string,value必须是可以时基本数据类型及定义转换接口的结构体
+		- 数组（std::vector、std::list、std::deque、std::set、std::unordered_set、std::array），模板参数可以时基本数据类型及定义转换接口的结构体
+		- std::map、std::unordered_map，key必须为std::string,value必须是可以时基本数据类型及定义转换接口的结构体
+		- std::pair、std::tuple，转换为Json数组，按顺序对应各个元素
+		- std::variant（C++17），按Json的类型选择第一个可以转换的类型，std::monostate对应null
+		- std::vector<uint8_t>、std::vector<std::byte>（C++17），转换为Base64字符串
+		- std::chrono::system_clock的time_point转换为RFC 3339时间字符串（UTC），duration转换为自身单位的数值
 	
 	多态支持方式
 	    使用宏“ADD_JSON_MEMBER_BASE_DEPL”注册顶层基类类型和成员
@@ -39,11 +64,31 @@
 #define FINAL_CLASS_TYPE "PolymorphicFinalClassType"
 #endif // FINAL_CLASS_TYPE
 
+//定义FINAL_CLASS_TYPE_NUMERIC时，类型字段写入由类名计算的数字标签，不写入类名，用于内部传输格式；读取时两种形式都支持
+#ifdef FINAL_CLASS_TYPE_NUMERIC
+#define FINAL_CLASS_TYPE_VALUE(Type) static_cast<int64_t>(std::integral_constant<uint32_t, mmrUtil::polymorphic_tag(#Type, sizeof(#Type) - 1)>::value)
+#else
+#define FINAL_CLASS_TYPE_VALUE(Type) #Type
+#endif // FINAL_CLASS_TYPE_NUMERIC
+
+//定义JSON_TIME_EPOCH_MILLIS时，time_point写入为1970-01-01起的毫秒数，不写入RFC 3339字符串；读取时两种形式都支持
+//#define JSON_TIME_EPOCH_MILLIS
+
 //内部的JSO成员实例名称，随机一些，和类成员重名后会出bug
 #ifndef JSON_INNER_MEMBER_NAME
 #define JSON_INNER_MEMBER_NAME ANameShouldNotBeSameWithStructMember23af00fa9
 #endif //JSON_INNER_MEMBER_NAME
 
+//ADD_JSON_MEMBER_TRACKED中记录已修改成员的位图名称
+#ifndef JSON_INNER_DIRTY_NAME
+#define JSON_INNER_DIRTY_NAME ADirtyMaskShouldNotBeSameWithStructMember7c41e2b05
+#endif //JSON_INNER_DIRTY_NAME
+
+//不抛出异常的转换中记录错误的参数名称
+#ifndef JSON_INNER_ERRORS_NAME
+#define JSON_INNER_ERRORS_NAME AnErrorListShouldNotBeSameWithStructMember3d90a6f14
+#endif //JSON_INNER_ERRORS_NAME
+
 namespace mmrUtil
 {
 
@@ -63,6 +108,16 @@ struct extract_value_type<std::optional<T>> { using type = T; };
 template<typename T>
 struct extract_value_type<std::map<std::string, T>> { using type = T; };
 template<typename T>
+struct extract_value_type<std::deque<T>> { using type = T; };
+template<typename T>
+struct extract_value_type<std::set<T>> { using type = T; };
+template<typename T>
+struct extract_value_type<std::unordered_set<T>> { using type = T; };
+template<typename T>
+struct extract_value_type<std::unordered_map<std::string, T>> { using type = T; };
+template<typename T, size_t N>
+struct extract_value_type<std::array<T, N>> { using type = T; };
+template<typename T>
 using extract_value_type_t = typename extract_value_type<T>::type;
 
 //获取多层模板嵌套的最底层类型
@@ -81,6 +136,16 @@ struct basic_value_type<std::optional<T>> { using type = typename basic_value_ty
 template<typename T>
 struct basic_value_type<std::map<std::string, T>> { using type = typename basic_value_type<T>::type; };
 template<typename T>
+struct basic_value_type<std::deque<T>> { using type = typename basic_value_type<T>::type; };
+template<typename T>
+struct basic_value_type<std::set<T>> { using type = typename basic_value_type<T>::type; };
+template<typename T>
+struct basic_value_type<std::unordered_set<T>> { using type = typename basic_value_type<T>::type; };
+template<typename T>
+struct basic_value_type<std::unordered_map<std::string, T>> { using type = typename basic_value_type<T>::type; };
+template<typename T, size_t N>
+struct basic_value_type<std::array<T, N>> { using type = typename basic_value_type<T>::type; };
+template<typename T>
 using basic_value_type_t = typename basic_value_type<T>::type;
 
 //去除前后空格
@@ -93,6 +158,349 @@ inline std::string trim(const char* start, const char* end)
 	return std::string(start, end);
 }
 
+//成员名称，由ADD_JSON_MEMBER*宏在编译期从#__VA_ARGS__中拆分
+struct MemberName
+{
+	const char* data;
+	size_t len;
+	uint64_t hash;//Json::key_hash的结果
+};
+
+template<size_t N>
+struct MemberNameTable
+{
+	MemberName names[N];
+	size_t sorted[N];//按哈希排序的成员序号，用于二分查找
+};
+
+constexpr bool is_name_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+constexpr size_t count_member_names(const char* str)
+{
+	size_t count = 1;
+	for (; *str; ++str)
+	{
+		if (*str == ',')
+			++count;
+	}
+	return count;
+}
+
+//按逗号拆分并去除前后空格
+template<size_t N>
+constexpr MemberNameTable<N> split_member_names(const char* str)
+{
+	MemberNameTable<N> table{};
+	for (size_t i = 0; i < N; ++i)
+	{
+		const char* end = str;
+		while (*end && *end != ',')
+			++end;
+		const char* next = *end ? end + 1 : end;
+		while (str < end && is_name_space(*str))
+			++str;
+		while (end > str && is_name_space(*(end - 1)))
+			--end;
+		table.names[i] = MemberName{ str, static_cast<size_t>(end - str), Json::key_hash(str, static_cast<size_t>(end - str)) };
+		str = next;
+	}
+	for (size_t i = 0; i < N; ++i)//插入排序
+	{
+		size_t pos = i;
+		while (pos > 0 && table.names[table.sorted[pos - 1]].hash > table.names[i].hash)
+		{
+			table.sorted[pos] = table.sorted[pos - 1];
+			--pos;
+		}
+		table.sorted[pos] = i;
+	}
+	return table;
+}
+
+//按哈希二分查找键对应的成员序号，不存在时返回N
+template<size_t N>
+inline size_t find_member(const MemberNameTable<N>& table, const std::string_view& key)
+{
+	uint64_t hash = Json::key_hash(key.data(), key.size());
+	size_t low = 0, high = N;
+	while (low < high)
+	{
+		size_t mid = (low + high) / 2;
+		if (table.names[table.sorted[mid]].hash < hash)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	for (; low < N && table.names[table.sorted[low]].hash == hash; ++low)
+	{
+		const MemberName& name = table.names[table.sorted[low]];
+		if (name.len == key.size() && 0 == memcmp(name.data, key.data(), key.size()))
+			return table.sorted[low];
+	}
+	return N;
+}
+
+//tryParse记录的错误类型
+enum class emParseError : uint8_t {
+	TypeMismatch,//Json类型与成员类型不符
+	OutOfRange,//数字超出成员类型的范围
+	MissingKey,//缺少必须的成员
+	UnknownType,//多态类型未注册
+	Exception//自定义转换接口抛出的异常
+};
+
+struct ParseError
+{
+	emParseError code;
+	std::string strPath;//Json路径，如$.items[2].name
+	const char* expected;//期望的类型，如int32、string、object
+	std::string strMessage;//自定义转换接口抛出的异常信息
+};
+
+//tryParse的错误列表，可重复使用，清空时保留已分配的内存
+class ErrorList
+{
+public:
+	enum class emPolicy : uint8_t {
+		Continue,//记录所有错误
+		Stop//遇到第一个错误后停止转换
+	};
+
+	explicit ErrorList(emPolicy policy = emPolicy::Continue) : m_policy(policy), m_count(0) {}
+
+	void setPolicy(emPolicy policy) { m_policy = policy; }
+
+	void clear() {
+		m_count = 0;
+		m_vecPath.clear();
+	}
+
+	bool empty() const { return m_count == 0; }
+	size_t size() const { return m_count; }
+	const ParseError& operator[](size_t index) const { return m_vecErrors[index]; }
+	const ParseError* begin() const { return m_vecErrors.data(); }
+	const ParseError* end() const { return m_vecErrors.data() + m_count; }
+
+	//按照策略是否停止转换
+	bool stopped() const { return m_policy == emPolicy::Stop && m_count > 0; }
+
+	//所有错误，每行一个
+	std::string toString() const {
+		std::string strRet;
+		for (const auto& iter : *this)
+		{
+			strRet.append(iter.strPath).append(": ").append(error_name(iter.code)).append(", expected ").append(iter.expected);
+			if (!iter.strMessage.empty())
+				strRet.append(", ").append(iter.strMessage);
+			strRet.push_back('\n');
+		}
+		return strRet;
+	}
+
+	//转换时记录当前位置，只在出错时生成路径字符串
+	void pushKey(const std::string_view& key) { m_vecPath.push_back(PathNode{ key, SIZE_MAX }); }
+	void pushIndex(size_t index) { m_vecPath.push_back(PathNode{ std::string_view(), index }); }
+	void popPath() { m_vecPath.pop_back(); }
+
+	void add(emParseError code, const char* expected, const std::string_view& message = std::string_view()) {
+		if (m_count == m_vecErrors.size())
+			m_vecErrors.emplace_back();
+		ParseError& error = m_vecErrors[m_count++];
+		error.code = code;
+		error.expected = expected;
+		size_t len = message.size();
+		while (len && (message[len - 1] == '\n' || message[len - 1] == '\r'))
+			--len;
+		error.strMessage.assign(message.data(), len);
+		error.strPath.assign(1, '$');
+		for (const auto& iter : m_vecPath)
+		{
+			if (iter.index == SIZE_MAX)
+				error.strPath.append(1, '.').append(iter.key.data(), iter.key.size());
+			else
+				error.strPath.append(1, '[').append(std::to_string(iter.index)).append(1, ']');
+		}
+	}
+
+	static const char* error_name(emParseError code) {
+		switch (code)
+		{
+		case emParseError::TypeMismatch: return "type mismatch";
+		case emParseError::OutOfRange: return "out of range";
+		case emParseError::MissingKey: return "missing key";
+		case emParseError::UnknownType: return "unknown type";
+		default: return "exception";
+		}
+	}
+
+private:
+	struct PathNode
+	{
+		std::string_view key;
+		size_t index;//数组下标，为SIZE_MAX时是对象的键
+	};
+
+	emPolicy m_policy;
+	size_t m_count;//m_vecErrors中有效的个数
+	std::vector<ParseError> m_vecErrors;
+	std::vector<PathNode> m_vecPath;
+};
+
+//Json对象转结构体时的状态，对象的每个成员分派到结构体成员
+struct MemberReadState
+{
+	Json::Reader* pReader;//解析Json文本时有效
+	const Json::Value* pValue;//解析Json::Value时有效，为当前键对应的值
+	Json::Value* pMoveValue;//解析右值Json::Value时有效，与pValue相同，成员从中转移
+	std::string strKey;//解析Json文本时键的缓冲区
+	std::string_view key;
+	uint64_t* pSeen;//已读取成员的位图，按成员序号（基类成员在前）
+	ErrorList* pErrors;//tryParse时有效，成员转换错误记录到其中，不抛出异常
+};
+
+inline void set_member_seen(uint64_t* pSeen, size_t index)
+{
+	pSeen[index / 64] |= uint64_t(1) << (index % 64);
+}
+
+inline bool is_member_seen(const uint64_t* pSeen, size_t index)
+{
+	return 0 != (pSeen[index / 64] & (uint64_t(1) << (index % 64)));
+}
+
+//多态类型的数字标签，由类名的哈希折叠为32位
+constexpr uint32_t polymorphic_tag(const char* name, size_t len)
+{
+	return static_cast<uint32_t>(Json::key_hash(name, len) ^ (Json::key_hash(name, len) >> 32));
+}
+
+//注册表中类名的哈希，只取长度和首尾各8个字节，类名较长且前缀相同时比逐字节的key_hash快；哈希相同时再比较类名
+inline uint64_t type_name_hash(const std::string_view& strType)
+{
+	uint64_t head = 0, tail = 0;
+	size_t len = strType.size();
+	memcpy(&head, strType.data(), len < 8 ? len : 8);
+	if (len > 8)
+		memcpy(&tail, strType.data() + (len < 16 ? 8 : len - 8), len < 16 ? len - 8 : 8);
+	uint64_t hash = (len ^ head) * 0x9e3779b97f4a7c15ull;
+	hash = (hash ^ (hash >> 29) ^ tail) * 0xbf58476d1ce4e5b9ull;
+	return hash ^ (hash >> 32);
+}
+
+//多态类型注册表，按类名哈希和数字标签排序，查找时二分查找
+//注册在静态初始化阶段完成，之后只读，查找不需要加锁
+template<typename _BasePtr>
+class PolymorphicRegistry
+{
+public:
+	using GenFunc = _BasePtr(*)();
+
+	//与std::map::insert一致，重复注册同一类名时保留第一个
+	//两个类名的数字标签相同时抛出std::logic_error，注册在静态初始化阶段完成，程序启动时即可发现
+	void add(const std::string& strType, GenFunc func)
+	{
+		uint64_t hash = type_name_hash(strType);
+		auto iter = std::lower_bound(m_vecNames.begin(), m_vecNames.end(), hash,
+			[](const NameEntry& entry, uint64_t value) { return entry.hash < value; });
+		for (auto iterSame = iter; iterSame != m_vecNames.end() && iterSame->hash == hash; ++iterSame)
+		{
+			if (iterSame->name == strType)
+				return;
+		}
+
+		uint32_t tag = polymorphic_tag(strType.data(), strType.size());
+		auto iterTag = std::lower_bound(m_vecTags.begin(), m_vecTags.end(), tag,
+			[](const TagEntry& entry, uint32_t value) { return entry.tag < value; });
+		if (iterTag != m_vecTags.end() && iterTag->tag == tag)
+		{
+			std::string strOther;
+			for (const auto& entry : m_vecNames)
+			{
+				if (polymorphic_tag(entry.name.data(), entry.name.size()) == tag)
+					strOther = entry.name;
+			}
+			throw std::logic_error("type [" + strType + "] has the same type tag " + std::to_string(tag) + " as [" + strOther + "], rename one of them.");
+		}
+		m_vecNames.insert(iter, NameEntry{ hash, strType, func });
+		m_vecTags.insert(iterTag, TagEntry{ tag, func });
+	}
+
+	GenFunc find(const std::string_view& strType) const
+	{
+		uint64_t hash = type_name_hash(strType);
+		auto iter = std::lower_bound(m_vecNames.begin(), m_vecNames.end(), hash,
+			[](const NameEntry& entry, uint64_t value) { return entry.hash < value; });
+		for (; iter != m_vecNames.end() && iter->hash == hash; ++iter)
+		{
+			if (iter->name == strType)
+				return iter->func;
+		}
+		return nullptr;
+	}
+
+	GenFunc find(uint32_t tag) const
+	{
+		auto iter = std::lower_bound(m_vecTags.begin(), m_vecTags.end(), tag,
+			[](const TagEntry& entry, uint32_t value) { return entry.tag < value; });
+		return iter != m_vecTags.end() && iter->tag == tag ? iter->func : nullptr;
+	}
+
+private:
+	struct NameEntry
+	{
+		uint64_t hash;
+		std::string name;
+		GenFunc func;
+	};
+
+	struct TagEntry
+	{
+		uint32_t tag;
+		GenFunc func;
+	};
+
+	std::vector<NameEntry> m_vecNames;//按类名哈希排序
+	std::vector<TagEntry> m_vecTags;//按数字标签排序
+};
+
+//按类型字段创建多态对象，类型字段为类名或数字标签，未注册时抛出异常
+template<typename _Base>
+inline auto genPolymorphic(const std::string_view& strType)->typename _Base::BasePtrType
+{
+	auto ptrRet = _Base::genClass(strType);
+	if (!ptrRet)
+		throw std::runtime_error(std::string("type [" + std::string(strType.data(), strType.size()) + "] do not regist to base class."));
+	return ptrRet;
+}
+
+template<typename _Base>
+inline auto genPolymorphic(uint32_t tag)->typename _Base::BasePtrType
+{
+	auto ptrRet = _Base::genClass(tag);
+	if (!ptrRet)
+		throw std::runtime_error(std::string("type tag [" + std::to_string(tag) + "] do not regist to base class."));
+	return ptrRet;
+}
+
+//类名不含需要转义的字符，直接使用未转义的字符串查找，不复制
+template<typename _Base>
+inline auto genPolymorphic(const Json::Value& jvType)->typename _Base::BasePtrType
+{
+	if (jvType.JSONType() == Json::emJsonType::String)
+		return genPolymorphic<_Base>(jvType.str_view());
+	return genPolymorphic<_Base>(jvType.get<uint32_t>());
+}
+
+//查找多态类型字段，不是对象或没有类型字段时返回nullptr
+inline const Json::Value* find_class_type(const Json::Value& jvData)
+{
+	static constexpr uint64_t hash = Json::key_hash(FINAL_CLASS_TYPE, sizeof(FINAL_CLASS_TYPE) - 1);
+	return jvData.find(FINAL_CLASS_TYPE, hash);
+}
+
 //是否为json互转方法的结构体有Json互转方法
 template<typename T, typename = void>
 struct enable_json_convert : std::false_type {};
@@ -116,7 +524,62 @@ struct enable_json_convert_depl<T,
 		, void())> //包含generateJson和parseJson接口
 	:std::true_type {};
 
+//是否有ADD_JSON_MEMBER*宏生成的按成员转换的接口（readJsonMember、writeJsonMembers等）
+//只有手写的generateJson/parseJson接口的基类，或者继承自这种基类的结构体没有，派生类整体调用其转换接口
+template<typename T, typename = void>
+struct has_member_table : std::false_type {};
+template<typename T>
+struct has_member_table<T, typename std::enable_if<T::jsonMemberTable()>::type> : std::true_type {};
+
+//基类的成员个数和结构哈希，整体转换的基类不计入
+template<typename Base, bool = has_member_table<Base>::value>
+struct member_table_base
+{
+	static constexpr size_t count() { return Base::jsonMemberCount(); }
+	static constexpr uint64_t name_hash() { return Base::jsonNameHash(); }
+	static constexpr uint64_t schema_hash() { return Base::jsonSchemaHash(); }
+};
+template<typename Base>
+struct member_table_base<Base, false>
+{
+	static constexpr size_t count() { return 0; }
+	static constexpr uint64_t name_hash() { return 0; }
+	static constexpr uint64_t schema_hash() { return 0; }
+};
+
+
+//是否为pair或tuple
+template<typename T>
+struct is_std_tuple : std::false_type {};
+template<typename T1, typename T2>
+struct is_std_tuple<std::pair<T1, T2>> : std::true_type {};
+template<typename... T>
+struct is_std_tuple<std::tuple<T...>> : std::true_type {};
+
+//是否为variant
+template<typename T>
+struct is_std_variant : std::false_type {};
+//是否为variant中的空类型
+template<typename T>
+struct is_monostate : std::false_type {};
+#ifdef MMR_JSON_CPP17
+template<typename... T>
+struct is_std_variant<std::variant<T...>> : std::true_type {};
+template<>
+struct is_monostate<std::monostate> : std::true_type {};
+#endif // MMR_JSON_CPP17
+
+//是否为system_clock的时间点
+template<typename T>
+struct is_time_point : std::false_type {};
+template<typename D>
+struct is_time_point<std::chrono::time_point<std::chrono::system_clock, D>> : std::true_type {};
 
+//是否为时间长度
+template<typename T>
+struct is_duration : std::false_type {};
+template<typename R, typename P>
+struct is_duration<std::chrono::duration<R, P>> : std::true_type {};
 
 //可直接转换为Json类型
 template<typename T>
@@ -126,6 +589,11 @@ struct is_convertable_to_json_type
 		|| std::is_same<std::decay_t<T>, std::string>::value//string类型
 		|| std::is_same<std::decay_t<T>, Json::Value>::value//Json类型
 		|| std::is_enum<std::decay_t<T>>::value//枚举类型
+		|| is_monostate<std::decay_t<T>>::value//std::variant中的空类型
+		|| is_time_point<std::decay_t<T>>::value//时间点
+		|| is_duration<std::decay_t<T>>::value//时间长度
+		|| is_std_tuple<std::decay_t<T>>::value//pair或tuple，元素在转换时检查
+		|| is_std_variant<std::decay_t<T>>::value//variant，各类型在转换时检查
 		|| enable_json_convert<T>::value;//定义了转化接口的结构体
 };
 
@@ -143,278 +611,3280 @@ struct is_optional :std::false_type {};
 template<typename T>
 struct is_optional<std::optional<T>> : std::true_type {};
 
-//是否为vector或list
+//是否为可变长度的数组：vector、list、deque或set、unordered_set
 template<typename T>
 struct is_std_list : std::false_type {};
 template<typename T>
 struct is_std_list<std::vector<T>> : std::true_type {};
 template<typename T>
 struct is_std_list<std::list<T>> : std::true_type {};
+template<typename T>
+struct is_std_list<std::deque<T>> : std::true_type {};
+template<typename T>
+struct is_std_list<std::set<T>> : std::true_type {};
+template<typename T>
+struct is_std_list<std::unordered_set<T>> : std::true_type {};
+
+//二进制数据，与Json互转时使用Base64字符串
+template<typename T>
+struct is_byte_vector : std::false_type {};
+template<>
+struct is_byte_vector<std::vector<uint8_t>> : std::true_type {};
+#ifdef MMR_JSON_CPP17
+template<>
+struct is_byte_vector<std::vector<std::byte>> : std::true_type {};
+#endif // MMR_JSON_CPP17
+
+//是否为std::array
+template<typename T>
+struct is_std_array : std::false_type {};
+template<typename T, size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type {};
 
-//是否为map
+//是否为map或unordered_map
 template<typename T>
 struct is_map :std::false_type {};
 template<typename T>
 struct is_map<std::map<std::string, T>> : std::true_type {};
+template<typename T>
+struct is_map<std::unordered_map<std::string, T>> : std::true_type {};
 
-
-/*****************************************************************/
-/*                          数据类型转Json                       */
-/*****************************************************************/
-//基本数据类型、string和Json::Value类型
+//按Json数组元素个数预先分配容量，没有reserve的容器不处理
 template<typename _Ty>
-inline auto toJson(const _Ty& data)->typename std::enable_if<std::is_arithmetic<std::decay_t<_Ty>>::value
-	|| std::is_same<std::decay_t<_Ty>, std::string>::value
-	|| std::is_same<std::decay_t<_Ty>, Json::Value>::value
-	, Json::Value>::type
+inline auto reserve_elements(_Ty& data, size_t count, int)->decltype(data.reserve(count), void())
 {
-	return  data;
+	data.reserve(count);
 }
 
-//枚举类型
 template<typename _Ty>
-inline auto toJson(const _Ty& data)->typename std::enable_if<std::is_enum<_Ty>::value, Json::Value>::type
+inline void reserve_elements(_Ty& data, size_t count, long) {}
+
+//追加元素，set、unordered_set使用emplace
+template<typename _Ty, typename _Val>
+inline auto append_element(_Ty& data, _Val&& value, int)->decltype(data.emplace_back(std::forward<_Val>(value)), void())
 {
-	using Type = typename std::underlying_type<_Ty>::type;
-	return static_cast<Type>(data);
+	data.emplace_back(std::forward<_Val>(value));
 }
 
-//自定义了转Json接口的结构体
-template<typename _Ty>
-inline auto toJson(const _Ty& data)->typename std::enable_if<enable_json_convert<_Ty>::value, Json::Value>::type
+template<typename _Ty, typename _Val>
+inline void append_element(_Ty& data, _Val&& value, long)
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<extract_type>::value, "subtype error");
-	return data.generateJson();
+	data.emplace(std::forward<_Val>(value));
 }
 
-//shared_ptr或者unique_ptr值
+//Json数组或对象的元素个数，其他类型为0
+inline size_t json_element_count(const Json::Value& jvData)
+{
+	int count = jvData.size();
+	return count > 0 ? static_cast<size_t>(count) : 0;
+}
+
+//Base64字符串直接解码到二进制数据的存储中，失败时清空数据
 template<typename _Ty>
-inline auto toJson(const _Ty& data)->typename std::enable_if<is_smart_ptr<_Ty>::value, Json::Value>::type
+inline bool decode_bytes(std::string_view str, _Ty& data)
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	using basic_type = basic_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
-	if(nullptr == data)
-		return Json::Value();
-	else 
-		return toJson<extract_type>(*data);
+	data.resize(Json::base64::decoded_max_size(str.size()));
+	size_t len = 0;
+	bool bRet = Json::base64::decode(str.data(), str.size(), reinterpret_cast<uint8_t*>(data.data()), len);
+	data.resize(len);
+	return bRet;
 }
 
-//optional，有值或没有值
+inline std::runtime_error base64_error(std::string_view str)
+{
+	return std::runtime_error("Json data is not a valid base64 string, length " + std::to_string(str.size()) + ".");
+}
+
+//1970-01-01起的天数与公历日期互转，适用于全部int64范围内的天数
+constexpr int64_t days_from_civil(int64_t y, unsigned m, unsigned d)
+{
+	y -= m <= 2;
+	const int64_t era = (y >= 0 ? y : y - 399) / 400;
+	const unsigned yoe = static_cast<unsigned>(y - era * 400);
+	const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+inline void civil_from_days(int64_t z, int64_t& y, unsigned& m, unsigned& d)
+{
+	z += 719468;
+	const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+	const unsigned doe = static_cast<unsigned>(z - era * 146097);
+	const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const unsigned mp = (5 * doy + 2) / 153;
+	d = doy - (153 * mp + 2) / 5 + 1;
+	m = mp < 10 ? mp + 3 : mp - 9;
+	y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+//RFC 3339中小数秒的位数，由时间点的精度决定
+template<typename _Period>
+constexpr int rfc3339_digits()
+{
+	return _Period::num >= _Period::den ? 0 : (_Period::den <= 1000 ? 3 : (_Period::den <= 1000000 ? 6 : 9));
+}
+
+inline char* write_digits(char* pOut, uint32_t value, int count)
+{
+	for (int i = count - 1; i >= 0; --i, value /= 10)
+		pOut[i] = static_cast<char>('0' + value % 10);
+	return pOut + count;
+}
+
+//向下取整的duration_cast，与C++17的std::chrono::floor一致
+template<typename _To, typename _Rep, typename _Period>
+inline _To floor_duration(const std::chrono::duration<_Rep, _Period>& value)
+{
+	_To ret = std::chrono::duration_cast<_To>(value);
+	return ret > value ? ret - _To(1) : ret;
+}
+
+//格式化为RFC 3339时间（UTC），如2024-01-02T03:04:05.123Z，不分配内存；buf至少32字节，返回长度，年份不在0~9999时返回0
 template<typename _Ty>
-inline auto toJson(const _Ty& data)->typename std::enable_if<is_optional<_Ty>::value, Json::Value>::type
+inline size_t format_rfc3339(const _Ty& tp, char* buf)
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	using basic_type = basic_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
-	if (data.has_value())
+	using namespace std::chrono;
+	constexpr int digits = rfc3339_digits<typename _Ty::period>();
+	const auto since = tp.time_since_epoch();
+	const auto secs = floor_duration<seconds>(since);
+	const int64_t totalSecs = secs.count();
+	const int64_t days = totalSecs >= 0 ? totalSecs / 86400 : -((-totalSecs + 86399) / 86400);
+	const uint32_t daySecs = static_cast<uint32_t>(totalSecs - days * 86400);
+	int64_t year = 0;
+	unsigned month = 0, day = 0;
+	civil_from_days(days, year, month, day);
+	if (year < 0 || year > 9999)
+		return 0;
+	char* pOut = write_digits(buf, static_cast<uint32_t>(year), 4);
+	*pOut++ = '-';
+	pOut = write_digits(pOut, month, 2);
+	*pOut++ = '-';
+	pOut = write_digits(pOut, day, 2);
+	*pOut++ = 'T';
+	pOut = write_digits(pOut, daySecs / 3600, 2);
+	*pOut++ = ':';
+	pOut = write_digits(pOut, daySecs / 60 % 60, 2);
+	*pOut++ = ':';
+	pOut = write_digits(pOut, daySecs % 60, 2);
+	if (digits > 0)
 	{
-		return toJson<extract_type>(data.value());
+		const int64_t nanos = duration_cast<nanoseconds>(since - secs).count();
+		*pOut++ = '.';
+		pOut = write_digits(pOut, static_cast<uint32_t>(nanos / (digits == 3 ? 1000000 : (digits == 6 ? 1000 : 1))), digits);
 	}
-	return Json::Value();
+	*pOut++ = 'Z';
+	return static_cast<size_t>(pOut - buf);
 }
 
-//容器数组
-template<typename _Ty>
-inline auto toJson(const _Ty& data)->typename std::enable_if<is_std_list<_Ty>::value, Json::Value>::type
+inline bool parse_digits(const char*& pData, const char* pEnd, int count, unsigned& value)
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	using basic_type = basic_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");	Json::Value jvRet;
-	for (const auto& iterData : data)
+	value = 0;
+	if (pEnd - pData < count)
+		return false;
+	for (int i = 0; i < count; ++i, ++pData)
 	{
-		jvRet.append(toJson<extract_type>(iterData));
+		if (*pData < '0' || *pData > '9')
+			return false;
+		value = value * 10 + static_cast<unsigned>(*pData - '0');
 	}
-	return jvRet;
+	return true;
 }
 
-//map转Json Object
-template<typename _Ty>
-inline auto toJson(const _Ty& data)->typename std::enable_if<is_map<_Ty>::value, Json::Value>::type
+inline bool parse_char(const char*& pData, const char* pEnd, char ch)
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	using basic_type = basic_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
-	Json::Value jvRet;
-	for (const auto& iterData : data)
+	if (pData == pEnd || *pData != ch)
+		return false;
+	++pData;
+	return true;
+}
+
+//解析RFC 3339时间，得到1970-01-01起的秒数及纳秒数；日期和时间用'T'、't'或空格分隔，时区为'Z'或±HH:MM，小数秒超过9位时截断
+inline bool parse_rfc3339(std::string_view str, int64_t& seconds, uint32_t& nanos)
+{
+	const char* pData = str.data();
+	const char* pEnd = pData + str.size();
+	unsigned year, month, day, hour, minute, second;
+	if (!parse_digits(pData, pEnd, 4, year) || !parse_char(pData, pEnd, '-') || !parse_digits(pData, pEnd, 2, month)
+		|| !parse_char(pData, pEnd, '-') || !parse_digits(pData, pEnd, 2, day))
+		return false;
+	if (pData == pEnd || (*pData != 'T' && *pData != 't' && *pData != ' '))
+		return false;
+	++pData;
+	if (!parse_digits(pData, pEnd, 2, hour) || !parse_char(pData, pEnd, ':') || !parse_digits(pData, pEnd, 2, minute)
+		|| !parse_char(pData, pEnd, ':') || !parse_digits(pData, pEnd, 2, second))
+		return false;
+	static constexpr unsigned monthDays[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	bool bLeap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+	if (month < 1 || month > 12 || day < 1 || day > (month == 2 && !bLeap ? 28 : monthDays[month - 1])
+		|| hour > 23 || minute > 59 || second > 60)
+		return false;
+	nanos = 0;
+	if (pData != pEnd && *pData == '.')
 	{
-		jvRet[iterData.first] = toJson<extract_type>(iterData.second);
+		++pData;
+		int count = 0;
+		for (; pData != pEnd && *pData >= '0' && *pData <= '9'; ++pData, ++count)
+		{
+			if (count < 9)
+				nanos = nanos * 10 + static_cast<uint32_t>(*pData - '0');
+		}
+		if (count == 0)
+			return false;
+		for (; count < 9; ++count)
+			nanos *= 10;
 	}
-	return jvRet;
+	int64_t offset = 0;
+	if (pData != pEnd && (*pData == 'Z' || *pData == 'z'))
+		++pData;
+	else if (pData != pEnd && (*pData == '+' || *pData == '-'))
+	{
+		int sign = *pData++ == '-' ? -1 : 1;
+		unsigned offHour, offMinute;
+		if (!parse_digits(pData, pEnd, 2, offHour) || !parse_char(pData, pEnd, ':') || !parse_digits(pData, pEnd, 2, offMinute)
+			|| offHour > 23 || offMinute > 59)
+			return false;
+		offset = sign * static_cast<int64_t>(offHour * 3600 + offMinute * 60);
+	}
+	else
+		return false;
+	if (pData != pEnd)
+		return false;
+	seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+	return true;
 }
 
-/*****************************************************************/
-/*                          Json转数据类型                       */
-/*****************************************************************/
-//数字或字符串类型
+//RFC 3339字符串转时间点，失败时返回false
 template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData) ->typename std::enable_if<std::is_arithmetic<_Ty>::value
-	|| std::is_same<_Ty, std::string>::value, _Ty>::type
+inline bool parse_time_point(std::string_view str, _Ty& tp)
 {
-	return jvData.get<_Ty>();
+	int64_t seconds = 0;
+	uint32_t nanos = 0;
+	if (!parse_rfc3339(str, seconds, nanos))
+		return false;
+	using Duration = typename _Ty::duration;
+	tp = _Ty(std::chrono::duration_cast<Duration>(std::chrono::seconds(seconds))
+		+ std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(nanos)));
+	return true;
 }
 
-//JSON类型
+//1970-01-01起的毫秒数转时间点
 template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData) ->typename std::enable_if<std::is_same<_Ty, Json::Value>::value, Json::Value>::type
+inline _Ty time_point_from_millis(int64_t millis)
 {
-	return jvData;
+	return _Ty(std::chrono::duration_cast<typename _Ty::duration>(std::chrono::milliseconds(millis)));
 }
 
-//枚举类型
 template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<std::is_enum<_Ty>::value, _Ty>::type
+inline int64_t time_point_to_millis(const _Ty& tp)
 {
-	using Type = typename std::underlying_type<_Ty>::type;
-	return static_cast<_Ty>(jvData.toNum<Type>());
+	return floor_duration<std::chrono::milliseconds>(tp.time_since_epoch()).count();
 }
 
-//自定义了转Json接口的结构体
-template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<enable_json_convert<_Ty>::value, _Ty>::type
+inline std::runtime_error time_error(std::string_view str)
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	using basic_type = basic_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
-	_Ty data;
-	data.parseJson(jvData);
-	return data;
+	return std::runtime_error("Json data [" + std::string(str.data(), str.size()) + "] is not a valid RFC 3339 time.");
 }
 
-//shar_ptr或unique_ptr，非多态类型
+//Json数组与std::array、tuple的元素个数不一致
+inline std::runtime_error fixed_size_error(const Json::Value& jvData, size_t size)
+{
+	return std::runtime_error("Json data " + jvData.dumpFast() + " is not an array of size " + std::to_string(size) + ".");
+}
+
+//std::variant按Json的类型选择，类型对应的位
+enum emJsonKind : uint8_t {
+	emKindNull = 1,
+	emKindBool = 2,
+	emKindIntegral = 4,//有符号整数
+	emKindUintegral = 8,//无符号整数，非负的整数同时属于两种
+	emKindFloating = 16,
+	emKindString = 32,
+	emKindObject = 64,
+	emKindArray = 128,
+	emKindNumber = emKindIntegral | emKindUintegral | emKindFloating,
+	emKindAll = 255
+};
+
+inline uint8_t json_kind(const Json::Value& jvData)
+{
+	switch (jvData.JSONType())
+	{
+	case Json::emJsonType::Null: return emKindNull;
+	case Json::emJsonType::Boolean: return emKindBool;
+	case Json::emJsonType::String: return emKindString;
+	case Json::emJsonType::Object: return emKindObject;
+	case Json::emJsonType::Array: return emKindArray;
+	case Json::emJsonType::Integral: return jvData.get<int64_t>() >= 0 ? (emKindIntegral | emKindUintegral) : emKindIntegral;
+	case Json::emJsonType::Uintegral: return emKindUintegral;
+	default: return emKindFloating;
+	}
+}
+
+//Json文本中下一个值的类型，数字与Json::Value的解析一致，包含小数点或指数时为浮点数
+inline uint8_t json_kind(Json::Reader& reader)
+{
+	switch (reader.peek())
+	{
+	case 'n': return emKindNull;
+	case 't':
+	case 'f': return emKindBool;
+	case '"': return emKindString;
+	case '{': return emKindObject;
+	case '[': return emKindArray;
+	default: break;
+	}
+	const std::string_view& str = reader.str();
+	size_t pos = reader.offset();
+	bool bNeg = pos < str.size() && str[pos] == '-';
+	for (; pos < str.size(); ++pos)
+	{
+		char c = str[pos];
+		if (c == '.' || c == 'e' || c == 'E')
+			return emKindFloating;
+		if (c != '-' && c != '+' && (c < '0' || c > '9'))
+			break;
+	}
+	return bNeg ? emKindIntegral : (emKindIntegral | emKindUintegral);
+}
+
+//数字类型对应的Json数字类型
 template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_smart_ptr<_Ty>::value
-	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type
+constexpr auto number_kind()->typename std::enable_if<std::is_arithmetic<_Ty>::value, uint8_t>::type
+{
+	return std::is_floating_point<_Ty>::value ? emKindFloating : std::is_signed<_Ty>::value ? emKindIntegral : emKindUintegral;
+}
+
+template<typename _Ty>
+constexpr auto number_kind()->typename std::enable_if<std::is_enum<_Ty>::value, uint8_t>::type
+{
+	return number_kind<typename std::underlying_type<_Ty>::type>();
+}
+
+template<typename _Ty>
+constexpr auto number_kind()->typename std::enable_if<is_duration<_Ty>::value, uint8_t>::type
+{
+	return number_kind<typename _Ty::rep>();
+}
+
+//类型可以接受的Json类型，空容器输出为null，所以容器也接受null
+//bExact为true时数字类型只对应自身的整数/浮点类型，用于variant优先选择类型完全一致的成员
+template<typename _Ty, bool bExact = false>
+constexpr auto json_kind_mask()->typename std::enable_if<(std::is_arithmetic<_Ty>::value && !std::is_same<_Ty, bool>::value)
+	|| std::is_enum<_Ty>::value || is_duration<_Ty>::value, uint8_t>::type;
+template<typename _Ty, bool bExact = false>
+constexpr auto json_kind_mask()->typename std::enable_if<!is_optional<_Ty>::value && !is_smart_ptr<_Ty>::value && !is_std_variant<_Ty>::value
+	&& !(std::is_arithmetic<_Ty>::value && !std::is_same<_Ty, bool>::value) && !std::is_enum<_Ty>::value && !is_duration<_Ty>::value, uint8_t>::type;
+template<typename _Ty, bool bExact = false>
+constexpr auto json_kind_mask()->typename std::enable_if<is_optional<_Ty>::value || is_smart_ptr<_Ty>::value, uint8_t>::type;
+#ifdef MMR_JSON_CPP17
+template<typename _Ty, bool bExact = false>
+constexpr auto json_kind_mask()->typename std::enable_if<is_std_variant<_Ty>::value, uint8_t>::type;
+#endif // MMR_JSON_CPP17
+
+template<typename _Ty, bool bExact>
+constexpr auto json_kind_mask()->typename std::enable_if<(std::is_arithmetic<_Ty>::value && !std::is_same<_Ty, bool>::value)
+	|| std::is_enum<_Ty>::value || is_duration<_Ty>::value, uint8_t>::type
+{
+	return bExact ? number_kind<_Ty>() : emKindNumber;
+}
+
+template<typename _Ty, bool bExact>
+constexpr auto json_kind_mask()->typename std::enable_if<!is_optional<_Ty>::value && !is_smart_ptr<_Ty>::value && !is_std_variant<_Ty>::value
+	&& !(std::is_arithmetic<_Ty>::value && !std::is_same<_Ty, bool>::value) && !std::is_enum<_Ty>::value && !is_duration<_Ty>::value, uint8_t>::type
+{
+	return is_monostate<_Ty>::value ? emKindNull
+		: std::is_same<_Ty, bool>::value ? emKindBool
+		: is_time_point<_Ty>::value ? (emKindString | (bExact ? emKindIntegral : emKindNumber))
+		: std::is_same<_Ty, std::string>::value ? emKindString
+		: std::is_same<_Ty, Json::Value>::value ? emKindAll
+		: is_byte_vector<_Ty>::value ? (emKindString | emKindArray | emKindNull)
+		: is_std_list<_Ty>::value || is_std_array<_Ty>::value || is_std_tuple<_Ty>::value ? (emKindArray | emKindNull)
+		: is_map<_Ty>::value ? (emKindObject | emKindNull) : emKindObject;
+}
+
+template<typename _Ty, bool bExact>
+constexpr auto json_kind_mask()->typename std::enable_if<is_optional<_Ty>::value || is_smart_ptr<_Ty>::value, uint8_t>::type
+{
+	return emKindNull | json_kind_mask<extract_value_type_t<_Ty>, bExact>();
+}
+
+#ifdef MMR_JSON_CPP17
+template<bool bExact, typename... T>
+constexpr uint8_t variant_kind_mask(const std::variant<T...>*)
+{
+	const uint8_t masks[] = { json_kind_mask<T, bExact>()... };
+	uint8_t mask = 0;
+	for (uint8_t iter : masks)
+		mask |= iter;
+	return mask;
+}
+
+template<typename _Ty, bool bExact>
+constexpr auto json_kind_mask()->typename std::enable_if<is_std_variant<_Ty>::value, uint8_t>::type
+{
+	return variant_kind_mask<bExact>(static_cast<const _Ty*>(nullptr));
+}
+
+//先选择第一个类型完全一致的variant成员（如1.5选择double而不是int），没有时选择第一个可以转换的成员，都没有时为成员个数
+template<typename... T>
+constexpr size_t variant_select(const std::variant<T...>*, uint8_t kind)
+{
+	const uint8_t exact[] = { json_kind_mask<T, true>()... };
+	const uint8_t masks[] = { json_kind_mask<T>()... };
+	for (size_t i = 0; i < sizeof...(T); ++i)
+	{
+		if (exact[i] & kind)
+			return i;
+	}
+	for (size_t i = 0; i < sizeof...(T); ++i)
+	{
+		if (masks[i] & kind)
+			return i;
+	}
+	return sizeof...(T);
+}
+
+template<typename _Ty>
+inline size_t variant_select(uint8_t kind)
+{
+	size_t index = variant_select(static_cast<const _Ty*>(nullptr), kind);
+	if (index == std::variant_size<_Ty>::value)
+		throw std::runtime_error("Json data type do not match any variant alternative.");
+	return index;
+}
+#endif // MMR_JSON_CPP17
+
+/*****************************************************************/
+/*                         容器并行转换                          */
+/*****************************************************************/
+//执行taskCount个任务，task(i)可以并发调用，全部完成后返回
+using ParallelExecutor = std::function<void(size_t taskCount, const std::function<void(size_t)>& task)>;
+
+//数组中结构体元素的并行转换配置，默认不并行
+struct ParallelConfig
+{
+	size_t threadCount = 0;//包括调用线程在内的线程数，小于2时不并行
+	size_t minElements = 4096;//元素个数不少于该值时才并行
+	ParallelExecutor executor;//为空时使用std::thread
+};
+
+inline ParallelConfig& parallel_config()
+{
+	static ParallelConfig config;
+	return config;
+}
+
+//设置并行转换，须在转换开始前设置，转换过程中不能修改
+inline void setParallelConvert(size_t threadCount, size_t minElements = 4096, ParallelExecutor executor = nullptr)
+{
+	ParallelConfig& config = parallel_config();
+	config.threadCount = threadCount;
+	config.minElements = minElements;
+	config.executor = std::move(executor);
+}
+
+//当前线程是否正在执行并行任务，嵌套的数组在任务中串行转换
+inline bool& in_parallel_task()
+{
+	thread_local bool bInTask = false;
+	return bInTask;
+}
+
+inline bool use_parallel(size_t count)
+{
+	const ParallelConfig& config = parallel_config();
+	return config.threadCount > 1 && count >= config.minElements && count > 1 && !in_parallel_task();
+}
+
+//默认的执行方式，调用线程与新建的线程按序号领取任务
+inline void run_parallel_tasks(size_t taskCount, const std::function<void(size_t)>& task)
+{
+	const ParallelConfig& config = parallel_config();
+	if (config.executor)
+	{
+		config.executor(taskCount, task);
+		return;
+	}
+	std::atomic<size_t> next(0);
+	auto worker = [&]() {
+		for (size_t i = next++; i < taskCount; i = next++)
+			task(i);
+	};
+	std::vector<std::thread> vecThreads;
+	size_t threadCount = config.threadCount < taskCount ? config.threadCount : taskCount;
+	try
+	{
+		for (size_t i = 1; i < threadCount; ++i)
+			vecThreads.emplace_back(worker);
+	}
+	catch (const std::system_error&)//无法创建更多线程时由已有线程完成
+	{
+	}
+	worker();
+	for (auto& iter : vecThreads)
+		iter.join();
+}
+
+//按块的大小，块数为线程数的4倍，减少各块耗时不均时的等待
+inline size_t parallel_chunk_size(size_t count)
+{
+	size_t chunkCount = parallel_config().threadCount * 4;
+	return (count + chunkCount - 1) / chunkCount;
+}
+
+//每块的起始迭代器，list只能顺序访问，提前取出
+template<typename _Iter>
+inline std::vector<_Iter> chunk_iterators(_Iter iter, size_t count, size_t chunkSize)
+{
+	std::vector<_Iter> vecIters;
+	vecIters.reserve((count + chunkSize - 1) / chunkSize);
+	for (size_t i = 0; i < count; i += chunkSize)
+	{
+		vecIters.push_back(iter);
+		std::advance(iter, count - i < chunkSize ? count - i : chunkSize);
+	}
+	return vecIters;
+}
+
+//并行处理count个元素，func(chunk, begin, end)处理第chunk块，即序号[begin, end)的元素；
+//块内遇到异常即停止，全部结束后重新抛出序号最小的块中的异常，与串行转换抛出的异常相同
+template<typename _Func>
+inline void parallel_for_chunks(size_t count, size_t chunkSize, _Func&& func)
+{
+	size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+	std::vector<std::exception_ptr> vecErrors(chunkCount);
+	run_parallel_tasks(chunkCount, [&](size_t chunk) {
+		bool& bInTask = in_parallel_task();
+		bool bOld = bInTask;
+		bInTask = true;
+		try
+		{
+			size_t end = (chunk + 1) * chunkSize;
+			func(chunk, chunk * chunkSize, end < count ? end : count);
+		}
+		catch (...)
+		{
+			vecErrors[chunk] = std::current_exception();
+		}
+		bInTask = bOld;
+	});
+	for (auto& iter : vecErrors)
+	{
+		if (iter)
+			std::rethrow_exception(iter);
+	}
+}
+
+//可以并行转换的数组元素：定义了转换接口的结构体及其智能指针
+template<typename T>
+struct is_parallel_element : std::integral_constant<bool, enable_json_convert<T>::value
+	|| (is_smart_ptr<T>::value && enable_json_convert<extract_value_type_t<T>>::value)> {};
+
+//串行转换时的容器，元素先转换到预先分配的std::vector中
+template<typename _Ty, typename _Elem>
+inline auto from_parallel_buffer(std::vector<_Elem>&& vecData)->typename std::enable_if<std::is_same<_Ty, std::vector<_Elem>>::value, _Ty>::type
+{
+	return std::move(vecData);
+}
+
+template<typename _Ty, typename _Elem>
+inline auto from_parallel_buffer(std::vector<_Elem>&& vecData)->typename std::enable_if<!std::is_same<_Ty, std::vector<_Elem>>::value, _Ty>::type
+{
+	return _Ty(std::make_move_iterator(vecData.begin()), std::make_move_iterator(vecData.end()));
+}
+
+/*****************************************************************/
+/*                          数据类型转Json                       */
+/*****************************************************************/
+//容器嵌套时需要先声明
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<(is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value) || is_std_array<_Ty>::value, Json::Value>::type;
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_byte_vector<_Ty>::value, Json::Value>::type;
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_map<_Ty>::value, Json::Value>::type;
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_std_tuple<_Ty>::value, Json::Value>::type;
+#ifdef MMR_JSON_CPP17
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_std_variant<_Ty>::value, Json::Value>::type;
+#endif // MMR_JSON_CPP17
+
+//基本数据类型、string和Json::Value类型
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<std::is_arithmetic<std::decay_t<_Ty>>::value
+	|| std::is_same<std::decay_t<_Ty>, std::string>::value
+	|| std::is_same<std::decay_t<_Ty>, Json::Value>::value
+	, Json::Value>::type
+{
+	return  data;
+}
+
+//枚举类型
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<std::is_enum<_Ty>::value, Json::Value>::type
+{
+	using Type = typename std::underlying_type<_Ty>::type;
+	return static_cast<Type>(data);
+}
+
+//时间点，RFC 3339字符串或毫秒数
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_time_point<_Ty>::value, Json::Value>::type
+{
+#ifdef JSON_TIME_EPOCH_MILLIS
+	return time_point_to_millis(data);
+#else
+	char buf[32];
+	size_t len = format_rfc3339(data, buf);
+	if (0 == len)
+		throw std::runtime_error("time point is out of RFC 3339 range.");
+	return std::string(buf, len);
+#endif
+}
+
+//时间长度，自身单位的数值
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_duration<_Ty>::value, Json::Value>::type
+{
+	return data.count();
+}
+
+//std::variant中的空类型
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_monostate<_Ty>::value, Json::Value>::type
+{
+	return Json::Value();
+}
+
+//自定义了转Json接口的结构体
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<enable_json_convert<_Ty>::value, Json::Value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<extract_type>::value, "subtype error");
+	return data.generateJson();
+}
+
+//shared_ptr或者unique_ptr值
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_smart_ptr<_Ty>::value, Json::Value>::type
 {
 	using extract_type = extract_value_type_t<_Ty>;
 	using basic_type = basic_value_type_t<_Ty>;
 	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
-	if (jvData.IsNull())
-		return nullptr;
-	else
-		return std::make_unique<extract_type>(fromJson<extract_type>(jvData));
+	if(nullptr == data)
+		return Json::Value();
+	else 
+		return toJson<extract_type>(*data);
 }
 
+//optional，有值或没有值
 template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_smart_ptr<_Ty>::value
-	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_optional<_Ty>::value, Json::Value>::type
 {
 	using extract_type = extract_value_type_t<_Ty>;
 	using basic_type = basic_value_type_t<_Ty>;
 	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
-	if (jvData.IsNull() || !jvData.hasKey(FINAL_CLASS_TYPE))
-		return nullptr;
-	else 
+	if (data.has_value())
 	{
-		std::string strType = jvData[FINAL_CLASS_TYPE].get<std::string>();
-		auto ptrRet = extract_type::genClass(strType);
-		if (ptrRet)
-		{
-			ptrRet->parseJson(jvData);
-		}
-		else//抛出异常？ 
-		{
-			throw std::runtime_error(std::string("type [" + strType + "] do not regist to base class."));
-		}
-		return ptrRet;
+		return toJson<extract_type>(data.value());
+	}
+	return Json::Value();
+}
+
+//结构体数组并行转换，各块直接写入预先分配的数组元素
+template<typename _Ty>
+inline auto toParallelArray(const _Ty& data, Json::Value& jvRet)->typename std::enable_if<is_parallel_element<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	size_t count = data.size();
+	if (!use_parallel(count))
+		return false;
+	jvRet[static_cast<unsigned>(count - 1)];
+	size_t chunkSize = parallel_chunk_size(count);
+	auto vecIters = chunk_iterators(data.begin(), count, chunkSize);
+	auto iterOut = jvRet.ArrayRange().begin();
+	parallel_for_chunks(count, chunkSize, [&](size_t chunk, size_t begin, size_t end) {
+		auto iter = vecIters[chunk];
+		for (size_t i = begin; i < end; ++i, ++iter)
+			iterOut[i] = toJson<extract_type>(*iter);
+	});
+	return true;
+}
+
+template<typename _Ty>
+inline auto toParallelArray(const _Ty& data, Json::Value& jvRet)->typename std::enable_if<!is_parallel_element<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	return false;
+}
+
+//容器数组
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<(is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value) || is_std_array<_Ty>::value, Json::Value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");	Json::Value jvRet;
+	if (toParallelArray(data, jvRet))
+		return jvRet;
+	for (const auto& iterData : data)
+	{
+		jvRet.append(toJson<extract_type>(iterData));
+	}
+	return jvRet;
+}
+
+//二进制数据转Base64字符串
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_byte_vector<_Ty>::value, Json::Value>::type
+{
+	return Json::Value(Json::base64::encode(data.data(), data.size()));
+}
+
+//map转Json Object
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_map<_Ty>::value, Json::Value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	Json::Value jvRet;
+	for (const auto& iterData : data)
+	{
+		jvRet[iterData.first] = toJson<extract_type>(iterData.second);
 	}
-		
+	return jvRet;
+}
+
+//pair、tuple转Json数组
+template<typename _Tuple, size_t... I>
+inline Json::Value toJsonTuple(const _Tuple& data, std::index_sequence<I...>)
+{
+	Json::Value jvRet = Json::Value::Make(Json::emJsonType::Array);
+	int order[] = { 0, (jvRet.append(toJson<std::tuple_element_t<I, _Tuple>>(std::get<I>(data))), 0)... };
+	(void)order;
+	return jvRet;
+}
+
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_std_tuple<_Ty>::value, Json::Value>::type
+{
+	return toJsonTuple(data, std::make_index_sequence<std::tuple_size<_Ty>::value>());
+}
+
+#ifdef MMR_JSON_CPP17
+//variant转换当前的值
+template<typename _Ty>
+inline auto toJson(const _Ty& data)->typename std::enable_if<is_std_variant<_Ty>::value, Json::Value>::type
+{
+	return std::visit([](const auto& value) { return toJson<std::decay_t<decltype(value)>>(value); }, data);
+}
+#endif // MMR_JSON_CPP17
+
+/*****************************************************************/
+/*                   数据类型直接输出Json文本                    */
+/*****************************************************************/
+//与toJson的类型一一对应，不构建Json::Value，容器嵌套时需要先声明
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<std::is_arithmetic<std::decay_t<_Ty>>::value
+	|| std::is_same<std::decay_t<_Ty>, std::string>::value
+	|| std::is_same<std::decay_t<_Ty>, Json::Value>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<std::is_enum<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_time_point<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_duration<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<enable_json_convert<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_smart_ptr<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_optional<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<(is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value) || is_std_array<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_byte_vector<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_map<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_monostate<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_std_tuple<_Ty>::value>::type;
+#ifdef MMR_JSON_CPP17
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_std_variant<_Ty>::value>::type;
+#endif // MMR_JSON_CPP17
+
+//基本数据类型、string和Json::Value类型
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<std::is_arithmetic<std::decay_t<_Ty>>::value
+	|| std::is_same<std::decay_t<_Ty>, std::string>::value
+	|| std::is_same<std::decay_t<_Ty>, Json::Value>::value>::type
+{
+	writer.writeValue(data);
+}
+
+//枚举类型
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<std::is_enum<_Ty>::value>::type
+{
+	using Type = typename std::underlying_type<_Ty>::type;
+	writer.writeValue(static_cast<Type>(data));
+}
+
+//时间点，直接格式化到输出中
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_time_point<_Ty>::value>::type
+{
+#ifdef JSON_TIME_EPOCH_MILLIS
+	writer.writeValue(time_point_to_millis(data));
+#else
+	char buf[32];
+	size_t len = format_rfc3339(data, buf);
+	if (0 == len)
+		throw std::runtime_error("time point is out of RFC 3339 range.");
+	writer.writeString(buf, len);
+#endif
+}
+
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_duration<_Ty>::value>::type
+{
+	writer.writeValue(data.count());
+}
+
+//自定义了转Json接口的结构体，没有writeJson接口时（手写的转换接口）经过Json::Value输出
+template<typename _Ty>
+inline auto writeJsonStruct(Json::Writer& writer, const _Ty& data, int)->decltype(data.writeJson(writer), void())
+{
+	data.writeJson(writer);
+}
+
+template<typename _Ty>
+inline void writeJsonStruct(Json::Writer& writer, const _Ty& data, long)
+{
+	writer.writeValue(data.generateJson());
+}
+
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<enable_json_convert<_Ty>::value>::type
+{
+	writeJsonStruct(writer, data, 0);
+}
+
+//shared_ptr或者unique_ptr值，多态类型通过虚函数输出派生类数据
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_smart_ptr<_Ty>::value>::type
+{
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	if (nullptr == data)
+		writer.writeNull();
+	else
+		writeJson(writer, *data);
+}
+
+//optional，没有值时输出null
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_optional<_Ty>::value>::type
+{
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	if (data.has_value())
+		writeJson(writer, data.value());
+	else
+		writer.writeNull();
+}
+
+//结构体数组并行输出，各块输出到单独的缓冲区后按顺序拼接
+template<typename _Ty>
+inline auto writeParallelArray(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_parallel_element<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	size_t count = data.size();
+	if (!use_parallel(count))
+		return false;
+	size_t chunkSize = parallel_chunk_size(count);
+	auto vecIters = chunk_iterators(data.begin(), count, chunkSize);
+	std::vector<std::string> vecText(vecIters.size());
+	parallel_for_chunks(count, chunkSize, [&](size_t chunk, size_t begin, size_t end) {
+		Json::Writer writerChunk(vecText[chunk]);
+		auto iter = vecIters[chunk];
+		for (size_t i = begin; i < end; ++i, ++iter)
+			writeJson(writerChunk, *iter);
+	});
+	for (auto& iter : vecText)
+		writer.writeRaw(iter);
+	return true;
+}
+
+template<typename _Ty>
+inline auto writeParallelArray(Json::Writer& writer, const _Ty& data)->typename std::enable_if<!is_parallel_element<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	return false;
+}
+
+//容器数组，空容器与toJson一致输出null
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<(is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value) || is_std_array<_Ty>::value>::type
+{
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	if (data.empty())
+	{
+		writer.writeNull();
+		return;
+	}
+	writer.beginArray();
+	if (writeParallelArray(writer, data))
+	{
+		writer.endArray();
+		return;
+	}
+	for (const auto& iterData : data)
+		writeJson(writer, iterData);
+	writer.endArray();
+}
+
+//二进制数据，直接编码到输出中
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_byte_vector<_Ty>::value>::type
+{
+	writer.writeBase64(data.data(), data.size());
+}
+
+//map转Json Object，空map与toJson一致输出null
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_map<_Ty>::value>::type
+{
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	if (data.empty())
+	{
+		writer.writeNull();
+		return;
+	}
+	writer.beginObject();
+	for (const auto& iterData : data)
+	{
+		writer.writeKey(iterData.first);
+		writeJson(writer, iterData.second);
+	}
+	writer.endObject();
+}
+
+//std::variant中的空类型
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_monostate<_Ty>::value>::type
+{
+	writer.writeNull();
+}
+
+//pair、tuple输出为Json数组
+template<typename _Tuple, size_t... I>
+inline void writeJsonTuple(Json::Writer& writer, const _Tuple& data, std::index_sequence<I...>)
+{
+	writer.beginArray();
+	int order[] = { 0, (writeJson(writer, std::get<I>(data)), 0)... };
+	(void)order;
+	writer.endArray();
+}
+
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_std_tuple<_Ty>::value>::type
+{
+	writeJsonTuple(writer, data, std::make_index_sequence<std::tuple_size<_Ty>::value>());
+}
+
+#ifdef MMR_JSON_CPP17
+template<typename _Ty>
+inline auto writeJson(Json::Writer& writer, const _Ty& data)->typename std::enable_if<is_std_variant<_Ty>::value>::type
+{
+	std::visit([&writer](const auto& value) { writeJson(writer, value); }, data);
+}
+#endif // MMR_JSON_CPP17
+
+//任意支持的类型直接转换为Json文本
+template<typename _Ty>
+inline std::string toJsonString(const _Ty& data)
+{
+	std::string strRet;
+	strRet.reserve(256);
+	Json::Writer writer(strRet);
+	writeJson(writer, data);
+	return strRet;
+}
+
+/*****************************************************************/
+/*                          Json转数据类型                       */
+/*****************************************************************/
+//容器嵌套时需要先声明
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_byte_vector<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_array<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_map<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_tuple<_Ty>::value, _Ty>::type;
+#ifdef MMR_JSON_CPP17
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_variant<_Ty>::value, _Ty>::type;
+#endif // MMR_JSON_CPP17
+
+//紧凑存储的数字数组直接读取，不转换为通用存储，func(序号, 元素)
+template<typename _Elem, typename _Func>
+inline auto forPackedArray(const Json::Value& jvData, _Func&& func)->typename std::enable_if<std::is_arithmetic<_Elem>::value, bool>::type
+{
+	size_t index = 0;
+	switch (jvData.ArrayStorage())
+	{
+	case Json::emArrayStorage::Int64:
+		for (auto iterData : jvData.as_span<int64_t>())
+			func(index++, Json::Value(iterData).get<_Elem>());
+		return true;
+	case Json::emArrayStorage::Double:
+		for (auto iterData : jvData.as_span<double>())
+			func(index++, Json::Value(iterData).get<_Elem>());
+		return true;
+	default:
+		return false;
+	}
+}
+
+template<typename _Elem, typename _Func>
+inline auto forPackedArray(const Json::Value& jvData, _Func&& func)->typename std::enable_if<!std::is_arithmetic<_Elem>::value, bool>::type
+{
+	return false;
+}
+
+template<typename _Ty>
+inline bool fromPackedArray(const Json::Value& jvData, _Ty& retArray)
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	return forPackedArray<extract_type>(jvData, [&retArray](size_t index, extract_type value) {
+		append_element(retArray, std::move(value), 0);
+	});
+}
+
+//数字或字符串类型
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData) ->typename std::enable_if<std::is_arithmetic<_Ty>::value
+	|| std::is_same<_Ty, std::string>::value, _Ty>::type
+{
+	return jvData.get<_Ty>();
+}
+
+//JSON类型
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData) ->typename std::enable_if<std::is_same<_Ty, Json::Value>::value, Json::Value>::type
+{
+	return jvData;
+}
+
+//枚举类型
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<std::is_enum<_Ty>::value, _Ty>::type
+{
+	using Type = typename std::underlying_type<_Ty>::type;
+	return static_cast<_Ty>(jvData.toNum<Type>());
+}
+
+//时间点，字符串按RFC 3339解析，数字为毫秒数
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_time_point<_Ty>::value, _Ty>::type
+{
+	if (jvData.JSONType() != Json::emJsonType::String)
+		return time_point_from_millis<_Ty>(jvData.get<int64_t>());
+	_Ty tpRet;
+	if (!parse_time_point(jvData.str_view(), tpRet))
+		throw time_error(jvData.str_view());
+	return tpRet;
+}
+
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_duration<_Ty>::value, _Ty>::type
+{
+	return _Ty(jvData.get<typename _Ty::rep>());
+}
+
+//std::variant中的空类型
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_monostate<_Ty>::value, _Ty>::type
+{
+	return _Ty();
+}
+
+//自定义了转Json接口的结构体
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<enable_json_convert<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	_Ty data;
+	data.parseJson(jvData);
+	return data;
+}
+
+//shar_ptr或unique_ptr，非多态类型
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	if (jvData.IsNull())
+		return nullptr;
+	else
+		return std::make_unique<extract_type>(fromJson<extract_type>(jvData));
+}
+
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	const Json::Value* pType = find_class_type(jvData);
+	if (!pType)
+		return nullptr;
+	auto ptrRet = genPolymorphic<extract_type>(*pType);
+	ptrRet->parseJson(jvData);
+	return ptrRet;
+}
+//optional
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_optional<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	if (jvData.IsNull())
+		return std::nullopt;
+	else
+		return fromJson<extract_type>(jvData);
+}
+
+//结构体数组并行转换，各块写入预先分配的元素，结束后移动到容器中
+template<typename _Ty>
+inline auto fromParallelArray(const Json::Value& jvData, _Ty& retArray)->typename std::enable_if<is_parallel_element<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	auto range = jvData.ArrayRange();//结构体数组为通用存储，各线程通过迭代器下标只读访问元素
+	size_t count = static_cast<size_t>(std::distance(range.begin(), range.end()));
+	if (!use_parallel(count))
+		return false;
+	std::vector<extract_type> vecData(count);
+	auto iterIn = range.begin();
+	parallel_for_chunks(count, parallel_chunk_size(count), [&](size_t chunk, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			vecData[i] = fromJson<extract_type>(iterIn[i]);
+	});
+	retArray = from_parallel_buffer<_Ty>(std::move(vecData));
+	return true;
+}
+
+template<typename _Ty>
+inline auto fromParallelArray(const Json::Value& jvData, _Ty& retArray)->typename std::enable_if<!is_parallel_element<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	return false;
+}
+
+//容器数组，按Json数组的元素个数预先分配
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	_Ty retArray;
+	if (fromParallelArray(jvData, retArray))
+		return retArray;
+	reserve_elements(retArray, json_element_count(jvData), 0);
+	if (fromPackedArray(jvData, retArray))
+		return retArray;
+	for (const auto& iterJv : jvData.ArrayRange())
+	{
+		append_element(retArray, fromJson<extract_type>(iterJv), 0);
+	}
+	return retArray;
+}
+
+//二进制数据，兼容旧格式的整数数组
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_byte_vector<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	_Ty retData;
+	if (jvData.JSONType() == Json::emJsonType::String)
+	{
+		if (!decode_bytes(jvData.str_view(), retData))
+			throw base64_error(jvData.str_view());
+		return retData;
+	}
+	retData.reserve(json_element_count(jvData));
+	for (const auto& iterJv : jvData.ArrayRange())
+	{
+		retData.push_back(fromJson<extract_type>(iterJv));
+	}
+	return retData;
+}
+
+//std::array，元素直接写入，Json数组的元素个数必须相同
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_array<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	_Ty retArray{};
+	if (jvData.length() != static_cast<int>(retArray.size()))
+		throw fixed_size_error(jvData, retArray.size());
+	if (forPackedArray<extract_type>(jvData, [&retArray](size_t index, extract_type value) { retArray[index] = value; }))
+		return retArray;
+	size_t index = 0;
+	for (const auto& iterJv : jvData.ArrayRange())
+	{
+		retArray[index++] = fromJson<extract_type>(iterJv);
+	}
+	return retArray;
+}
+
+//map
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_map<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	_Ty mapRet;
+	reserve_elements(mapRet, json_element_count(jvData), 0);
+	for (const auto& iterMap : jvData.ObjectRange())
+	{
+		mapRet[iterMap.first] = fromJson<extract_type>(iterMap.second);
+	}
+	return mapRet;
+}
+
+//pair、tuple，Json数组的元素个数必须相同
+template<typename _Tuple, size_t... I>
+inline void fromJsonTuple(const Json::Value& jvData, _Tuple& data, std::index_sequence<I...>)
+{
+	int order[] = { 0, (std::get<I>(data) = fromJson<std::tuple_element_t<I, _Tuple>>(jvData.at(static_cast<unsigned>(I))), 0)... };
+	(void)order;
+}
+
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_tuple<_Ty>::value, _Ty>::type
+{
+	_Ty data;
+	if (jvData.length() != static_cast<int>(std::tuple_size<_Ty>::value))
+		throw fixed_size_error(jvData, std::tuple_size<_Ty>::value);
+	fromJsonTuple(jvData, data, std::make_index_sequence<std::tuple_size<_Ty>::value>());
+	return data;
+}
+
+#ifdef MMR_JSON_CPP17
+//variant，按Json的类型选择第一个可以接受的类型
+template<size_t I, typename _Ty>
+inline void fromJsonVariantAt(const Json::Value& jvData, _Ty& data)
+{
+	data.template emplace<I>(fromJson<std::variant_alternative_t<I, _Ty>>(jvData));
+}
+
+template<typename _Ty, size_t... I>
+inline void fromJsonVariant(const Json::Value& jvData, _Ty& data, size_t index, std::index_sequence<I...>)
+{
+	using FromFunc = void(*)(const Json::Value&, _Ty&);
+	static constexpr FromFunc funcs[] = { &fromJsonVariantAt<I, _Ty>... };
+	funcs[index](jvData, data);
+}
+
+template<typename _Ty>
+inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_variant<_Ty>::value, _Ty>::type
+{
+	_Ty data;
+	fromJsonVariant(jvData, data, variant_select<_Ty>(json_kind(jvData)), std::make_index_sequence<std::variant_size<_Ty>::value>());
+	return data;
+}
+#endif // MMR_JSON_CPP17
+
+/*****************************************************************/
+/*                  右值Json::Value转数据类型                    */
+/*****************************************************************/
+//文档转换后即销毁时使用，字符串、Json::Value子树和map的键直接从文档中转移，不复制；
+//数字、枚举等类型没有对应的重载，使用const Json::Value&版本，容器嵌套时需要先声明
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<std::is_same<_Ty, std::string>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<std::is_same<_Ty, Json::Value>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<enable_json_convert<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_optional<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_byte_vector<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_map<_Ty>::value, _Ty>::type;
+
+//字符串类型，需要转义时与const版本一致返回转义后的副本
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<std::is_same<_Ty, std::string>::value, _Ty>::type
+{
+	return jvData.take_string();
+}
+
+//JSON类型
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<std::is_same<_Ty, Json::Value>::value, _Ty>::type
+{
+	return std::move(jvData);
+}
+
+//自定义了转Json接口的结构体，只有const Json::Value&接口时使用该接口
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<enable_json_convert<_Ty>::value, _Ty>::type
+{
+	_Ty data;
+	data.parseJson(std::move(jvData));
+	return data;
+}
+
+//shar_ptr或unique_ptr，非多态类型
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	if (jvData.IsNull())
+		return nullptr;
+	else
+		return std::make_unique<extract_type>(fromJson<extract_type>(std::move(jvData)));
+}
+
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	const Json::Value* pType = find_class_type(jvData);
+	if (!pType)
+		return nullptr;
+	auto ptrRet = genPolymorphic<extract_type>(*pType);
+	ptrRet->parseJson(std::move(jvData));
+	return ptrRet;
+}
+
+//optional
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_optional<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	if (jvData.IsNull())
+		return std::nullopt;
+	else
+		return fromJson<extract_type>(std::move(jvData));
+}
+
+template<typename _Ty>
+inline auto fromParallelArray(Json::Value&& jvData, _Ty& retArray)->typename std::enable_if<is_parallel_element<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	auto range = jvData.ArrayRange();
+	size_t count = static_cast<size_t>(std::distance(range.begin(), range.end()));
+	if (!use_parallel(count))
+		return false;
+	std::vector<extract_type> vecData(count);
+	auto iterIn = range.begin();
+	parallel_for_chunks(count, parallel_chunk_size(count), [&](size_t chunk, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			vecData[i] = fromJson<extract_type>(std::move(iterIn[i]));
+	});
+	retArray = from_parallel_buffer<_Ty>(std::move(vecData));
+	return true;
+}
+
+template<typename _Ty>
+inline auto fromParallelArray(Json::Value&& jvData, _Ty& retArray)->typename std::enable_if<!is_parallel_element<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	return false;
+}
+
+//容器数组
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	_Ty retArray;
+	if (fromParallelArray(std::move(jvData), retArray))
+		return retArray;
+	reserve_elements(retArray, json_element_count(jvData), 0);
+	if (fromPackedArray(jvData, retArray))
+		return retArray;
+	for (auto& iterJv : jvData.ArrayRange())
+	{
+		append_element(retArray, fromJson<extract_type>(std::move(iterJv)), 0);
+	}
+	return retArray;
+}
+
+//二进制数据，解码时没有可以转移的内容
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_byte_vector<_Ty>::value, _Ty>::type
+{
+	return fromJson<_Ty>(static_cast<const Json::Value&>(jvData));
+}
+
+//map，键从文档的节点中直接取出
+template<typename _Ty>
+inline auto fromJson(Json::Value&& jvData)->typename std::enable_if<is_map<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	_Ty mapRet;
+	reserve_elements(mapRet, json_element_count(jvData), 0);
+	jvData.consume_members([&](auto&& key, Json::Value& value) {//键可以转移时转移，否则复制到容器的节点中
+		mapRet.emplace_hint(mapRet.end(), std::forward<decltype(key)>(key), fromJson<extract_type>(std::move(value)));
+	});
+	return mapRet;
+}
+
+/*****************************************************************/
+/*                    Json文本直接转数据类型                     */
+/*****************************************************************/
+//与fromJson的类型一一对应，不构建Json::Value，容器嵌套时需要先声明
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<std::is_arithmetic<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<std::is_same<_Ty, std::string>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<std::is_same<_Ty, Json::Value>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<std::is_enum<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_time_point<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_duration<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<enable_json_convert<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_optional<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_byte_vector<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_map<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_monostate<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_std_array<_Ty>::value, _Ty>::type;
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_std_tuple<_Ty>::value, _Ty>::type;
+#ifdef MMR_JSON_CPP17
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_std_variant<_Ty>::value, _Ty>::type;
+#endif // MMR_JSON_CPP17
+
+//数字类型
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<std::is_arithmetic<_Ty>::value, _Ty>::type
+{
+	return reader.readValue().get<_Ty>();
+}
+
+//字符串类型，不是字符串时与fromJson一致抛出异常
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<std::is_same<_Ty, std::string>::value, _Ty>::type
+{
+	if (reader.peek() != '\"')
+		return reader.readValue().get<std::string>();
+	std::string strRet;
+	reader.readString(strRet);
+	return strRet;
+}
+
+//JSON类型
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<std::is_same<_Ty, Json::Value>::value, _Ty>::type
+{
+	return reader.readValue();
+}
+
+//枚举类型
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<std::is_enum<_Ty>::value, _Ty>::type
+{
+	using Type = typename std::underlying_type<_Ty>::type;
+	return static_cast<_Ty>(reader.readValue().toNum<Type>());
+}
+
+//时间点，不含转义字符时直接从原文解析
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_time_point<_Ty>::value, _Ty>::type
+{
+	std::string_view view;
+	if (reader.peek() != '\"' || !reader.readStringView(view))
+		return fromJson<_Ty>(reader.readValue());
+	_Ty tpRet;
+	if (!parse_time_point(view, tpRet))
+		throw time_error(view);
+	return tpRet;
+}
+
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_duration<_Ty>::value, _Ty>::type
+{
+	return _Ty(reader.readValue().get<typename _Ty::rep>());
+}
+
+//std::variant中的空类型
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_monostate<_Ty>::value, _Ty>::type
+{
+	reader.skipValue();
+	return _Ty();
+}
+
+//自定义了转Json接口的结构体，没有readJson接口时（手写的转换接口）先读取为Json::Value再转换
+template<typename _Ty>
+inline auto readJsonStruct(Json::Reader& reader, _Ty& data, int)->decltype(data.readJson(reader), void())
+{
+	data.readJson(reader);
+}
+
+template<typename _Ty>
+inline void readJsonStruct(Json::Reader& reader, _Ty& data, long)
+{
+	data.parseJson(reader.readValue());
+}
+
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<enable_json_convert<_Ty>::value, _Ty>::type
+{
+	_Ty data;
+	readJsonStruct(reader, data, 0);
+	return data;
+}
+
+//shar_ptr或unique_ptr，非多态类型
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	if (reader.readNull())
+		return nullptr;
+	return std::make_unique<extract_type>(readJson<extract_type>(reader));
+}
+
+//多态类型先读取类型字段创建对象，不构建Json::Value
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value, _Ty>::type
+{
+	//writeJson把类型字段写在第一个键，直接读取；其它来源的文本类型字段可能在任意位置，跳过其它成员找到类型字段
+	//创建对象后回到对象开始处直接读取
+	using extract_type = extract_value_type_t<_Ty>;
+	if (reader.readNull())
+		return nullptr;
+	if (reader.peek() != '{')
+	{
+		reader.skipValue();//与fromJson一致，不是对象时返回空指针
+		return nullptr;
+	}
+	size_t start = reader.offset();
+	std::string strKey;
+	if (reader.beginObject())
+	{
+		do
+		{
+			reader.readKey(strKey);
+			if (strKey == FINAL_CLASS_TYPE)
+			{
+				typename extract_type::BasePtrType ptrRet;
+				if (reader.peek() == '\"')
+				{
+					reader.readString(strKey);
+					ptrRet = genPolymorphic<extract_type>(std::string_view(strKey));
+				}
+				else
+					ptrRet = genPolymorphic<extract_type>(reader.readValue());
+				reader.seek(start);
+				ptrRet->readJson(reader);
+				return ptrRet;
+			}
+			reader.skipValue();
+		} while (reader.nextElement('}'));
+	}
+	return nullptr;
+}
+
+//optional
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_optional<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	if (reader.readNull())
+		return std::nullopt;
+	return readJson<extract_type>(reader);
+}
+
+//容器数组，不是数组时与fromJson一致返回空容器
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	_Ty retArray;
+	if (reader.peek() != '[')
+		reader.skipValue();
+	else if (reader.beginArray())
+	{
+		do
+		{
+			append_element(retArray, readJson<extract_type>(reader), 0);
+		} while (reader.nextElement(']'));
+	}
+	return retArray;
+}
+
+//二进制数据，不含转义字符时直接从原文解码
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_byte_vector<_Ty>::value, _Ty>::type
+{
+	_Ty retData;
+	char ch = reader.peek();
+	if (ch == '"')
+	{
+		std::string_view view;
+		std::string strData;
+		if (!reader.readStringView(view))
+		{
+			reader.readString(strData);
+			view = strData;
+		}
+		if (!decode_bytes(view, retData))
+			throw base64_error(view);
+	}
+	else if (ch == '[')
+		retData = fromJson<_Ty>(reader.readValue());
+	else
+		reader.skipValue();
+	return retData;
+}
+
+//std::array，元素直接写入，Json数组的元素个数必须相同
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_std_array<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	_Ty retArray{};
+	size_t index = 0;
+	if (reader.beginArray())
+	{
+		do
+		{
+			if (index == retArray.size())
+				throw std::runtime_error("Json array has more than " + std::to_string(retArray.size()) + " elements.");
+			retArray[index++] = readJson<extract_type>(reader);
+		} while (reader.nextElement(']'));
+	}
+	if (index != retArray.size())
+		throw std::runtime_error("Json array has " + std::to_string(index) + " elements, expected " + std::to_string(retArray.size()) + ".");
+	return retArray;
+}
+
+//map，不是对象时与fromJson一致返回空map
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_map<_Ty>::value, _Ty>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	using basic_type = basic_value_type_t<_Ty>;
+	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
+	_Ty mapRet;
+	if (reader.peek() != '{')
+		reader.skipValue();
+	else if (reader.beginObject())
+	{
+		std::string strKey;
+		do
+		{
+			reader.readKey(strKey);
+			mapRet[strKey] = readJson<extract_type>(reader);
+		} while (reader.nextElement('}'));
+	}
+	return mapRet;
+}
+
+//pair、tuple，Json数组的元素个数必须相同
+template<typename _Tuple, size_t... I>
+inline void readJsonTuple(Json::Reader& reader, _Tuple& data, std::index_sequence<I...>)
+{
+	bool bMore = reader.beginArray();
+	int order[] = { 0, ((bMore ? (std::get<I>(data) = readJson<std::tuple_element_t<I, _Tuple>>(reader), bMore = reader.nextElement(']'))
+		: throw std::runtime_error("Json array has less than " + std::to_string(sizeof...(I)) + " elements.")), 0)... };
+	(void)order;
+	if (bMore)
+		throw std::runtime_error("Json array has more than " + std::to_string(sizeof...(I)) + " elements.");
+}
+
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_std_tuple<_Ty>::value, _Ty>::type
+{
+	_Ty data;
+	readJsonTuple(reader, data, std::make_index_sequence<std::tuple_size<_Ty>::value>());
+	return data;
+}
+
+#ifdef MMR_JSON_CPP17
+//variant，按Json的类型选择第一个可以接受的类型
+template<size_t I, typename _Ty>
+inline void readJsonVariantAt(Json::Reader& reader, _Ty& data)
+{
+	data.template emplace<I>(readJson<std::variant_alternative_t<I, _Ty>>(reader));
+}
+
+template<typename _Ty, size_t... I>
+inline void readJsonVariant(Json::Reader& reader, _Ty& data, size_t index, std::index_sequence<I...>)
+{
+	using ReadFunc = void(*)(Json::Reader&, _Ty&);
+	static constexpr ReadFunc funcs[] = { &readJsonVariantAt<I, _Ty>... };
+	funcs[index](reader, data);
+}
+
+template<typename _Ty>
+inline auto readJson(Json::Reader& reader)->typename std::enable_if<is_std_variant<_Ty>::value, _Ty>::type
+{
+	_Ty data;
+	readJsonVariant(reader, data, variant_select<_Ty>(json_kind(reader)), std::make_index_sequence<std::variant_size<_Ty>::value>());
+	return data;
+}
+#endif // MMR_JSON_CPP17
+
+//Json文本直接解析到数据，解析或转换失败时返回错误信息，data不变
+template<typename _Ty>
+inline std::string parseInto(const std::string_view& str, _Ty& data)
+{
+	Json::Reader reader(str);
+	std::string strErr;
+	try
+	{
+		_Ty temp = readJson<_Ty>(reader);
+		reader.finish();
+		data = std::move(temp);
+	}
+	catch (const std::exception& e)
+	{
+		strErr = e.what() + Json::Value::error_position(str, reader.offset());
+	}
+	return strErr;
+}
+
+/*****************************************************************/
+/*                  Json转数据类型（不抛出异常）                 */
+/*****************************************************************/
+//错误信息中期望的类型名称
+template<typename _Ty>
+constexpr auto expected_type_name()->typename std::enable_if<std::is_arithmetic<_Ty>::value, const char*>::type
+{
+	return std::is_same<_Ty, bool>::value ? "bool"
+		: std::is_floating_point<_Ty>::value ? (sizeof(_Ty) == sizeof(float) ? "float" : "double")
+		: std::is_signed<_Ty>::value ? (sizeof(_Ty) == 1 ? "int8" : sizeof(_Ty) == 2 ? "int16" : sizeof(_Ty) == 4 ? "int32" : "int64")
+		: (sizeof(_Ty) == 1 ? "uint8" : sizeof(_Ty) == 2 ? "uint16" : sizeof(_Ty) == 4 ? "uint32" : "uint64");
+}
+
+template<typename _Ty>
+constexpr auto expected_type_name()->typename std::enable_if<std::is_enum<_Ty>::value, const char*>::type
+{
+	return expected_type_name<typename std::underlying_type<_Ty>::type>();
+}
+
+template<typename _Ty>
+constexpr auto expected_type_name()->typename std::enable_if<!std::is_arithmetic<_Ty>::value && !std::is_enum<_Ty>::value, const char*>::type
+{
+	return std::is_same<_Ty, std::string>::value ? "string"
+		: std::is_same<_Ty, Json::Value>::value ? "json"
+		: is_byte_vector<_Ty>::value ? "base64"
+		: is_time_point<_Ty>::value ? "time"
+		: is_duration<_Ty>::value ? "number"
+		: is_std_list<_Ty>::value || is_std_array<_Ty>::value || is_std_tuple<_Ty>::value ? "array"
+		: is_std_variant<_Ty>::value ? "variant"
+		: is_monostate<_Ty>::value ? "null"
+		: is_optional<_Ty>::value || is_smart_ptr<_Ty>::value ? "nullable" : "object";
+}
+
+//转换规则与fromJson相同，fromJson抛出异常的地方把错误记录到errors中，继续转换其他成员
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<std::is_arithmetic<_Ty>::value
+	|| std::is_same<_Ty, std::string>::value>::type;
+inline void tryFromJson(const Json::Value& jvData, Json::Value& data, ErrorList& errors);
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<std::is_enum<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_time_point<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_duration<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<enable_json_convert<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_optional<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_byte_vector<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_map<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_monostate<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_std_array<_Ty>::value>::type;
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_std_tuple<_Ty>::value>::type;
+#ifdef MMR_JSON_CPP17
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_std_variant<_Ty>::value>::type;
+#endif // MMR_JSON_CPP17
+
+//数字或字符串类型，数字超出范围时为OutOfRange
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<std::is_arithmetic<_Ty>::value
+	|| std::is_same<_Ty, std::string>::value>::type
+{
+	bool bRet = false;
+	data = jvData.get<_Ty>(bRet);
+	if (!bRet)
+	{
+		Json::emJsonType type = jvData.JSONType();
+		bool bNumber = type == Json::emJsonType::Integral || type == Json::emJsonType::Uintegral || type == Json::emJsonType::Floating;
+		errors.add(bNumber && std::is_arithmetic<_Ty>::value ? emParseError::OutOfRange : emParseError::TypeMismatch, expected_type_name<_Ty>());
+	}
+}
+
+//JSON类型
+inline void tryFromJson(const Json::Value& jvData, Json::Value& data, ErrorList&)
+{
+	data = jvData;
+}
+
+//枚举类型，与fromJson一致不检查
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<std::is_enum<_Ty>::value>::type
+{
+	data = fromJson<_Ty>(jvData);
+}
+
+//时间点，字符串不是RFC 3339格式、不是字符串或数字时为TypeMismatch，毫秒数超出范围时为OutOfRange
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_time_point<_Ty>::value>::type
+{
+	Json::emJsonType type = jvData.JSONType();
+	if (type != Json::emJsonType::String)
+	{
+		bool bRet = false;
+		int64_t millis = jvData.get<int64_t>(bRet);
+		if (bRet)
+			data = time_point_from_millis<_Ty>(millis);
+		else
+		{
+			bool bNumber = type == Json::emJsonType::Integral || type == Json::emJsonType::Uintegral || type == Json::emJsonType::Floating;
+			errors.add(bNumber ? emParseError::OutOfRange : emParseError::TypeMismatch, expected_type_name<_Ty>());
+		}
+	}
+	else if (!parse_time_point(jvData.str_view(), data))
+		errors.add(emParseError::TypeMismatch, expected_type_name<_Ty>(), time_error(jvData.str_view()).what());
+}
+
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_duration<_Ty>::value>::type
+{
+	typename _Ty::rep count{};
+	tryFromJson(jvData, count, errors);
+	data = _Ty(count);
+}
+
+//结构体，自定义的转换接口（没有tryParseJson）抛出的异常记录为Exception
+template<typename _Ty>
+inline auto tryParseStruct(const Json::Value& jvData, _Ty& data, ErrorList& errors, int)->decltype(data.tryParseJson(jvData, errors), void())
+{
+	data.tryParseJson(jvData, errors);
+}
+
+template<typename _Ty>
+inline void tryParseStruct(const Json::Value& jvData, _Ty& data, ErrorList& errors, long)
+{
+	try
+	{
+		data.parseJson(jvData);
+	}
+	catch (const std::exception& e)
+	{
+		errors.add(emParseError::Exception, "object", e.what());
+	}
+}
+
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<enable_json_convert<_Ty>::value>::type
+{
+	tryParseStruct(jvData, data, errors, 0);
+}
+
+//shar_ptr或unique_ptr，非多态类型
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	if (jvData.IsNull())
+	{
+		data = nullptr;
+		return;
+	}
+	std::unique_ptr<extract_type> ptrRet = std::make_unique<extract_type>();
+	tryFromJson(jvData, *ptrRet, errors);
+	data = std::move(ptrRet);
+}
+
+//多态类型，类型字段未注册时为UnknownType
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	const Json::Value* pType = find_class_type(jvData);
+	if (!pType)
+	{
+		data = nullptr;
+		return;
+	}
+	typename extract_type::BasePtrType ptrRet;
+	if (pType->JSONType() == Json::emJsonType::String)
+		ptrRet = extract_type::genClass(pType->str_view());
+	else
+	{
+		bool bRet = false;
+		uint32_t tag = pType->get<uint32_t>(bRet);
+		if (bRet)
+			ptrRet = extract_type::genClass(tag);
+	}
+	if (!ptrRet)
+	{
+		errors.pushKey(FINAL_CLASS_TYPE);
+		errors.add(emParseError::UnknownType, "registered type");
+		errors.popPath();
+		return;
+	}
+	ptrRet->tryParseJson(jvData, errors);
+	data = std::move(ptrRet);
+}
+
+//optional
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_optional<_Ty>::value>::type
+{
+	if (jvData.IsNull())
+	{
+		data = std::nullopt;
+		return;
+	}
+	data.emplace();//C++14的optional实现中emplace没有返回值
+	tryFromJson(jvData, *data, errors);
+}
+
+//紧凑存储的数字数组
+template<typename _Ty>
+inline auto tryFromPackedArray(const Json::Value& jvData, _Ty& retArray, ErrorList& errors)->typename std::enable_if<std::is_arithmetic<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	auto func = [&](size_t index, auto iterData) {
+		extract_type value{};
+		errors.pushIndex(index);
+		tryFromJson(Json::Value(iterData), value, errors);
+		errors.popPath();
+		append_element(retArray, std::move(value), 0);
+	};
+	size_t index = 0;
+	switch (jvData.ArrayStorage())
+	{
+	case Json::emArrayStorage::Int64:
+		for (auto iterData : jvData.as_span<int64_t>())
+			func(index++, iterData);
+		return true;
+	case Json::emArrayStorage::Double:
+		for (auto iterData : jvData.as_span<double>())
+			func(index++, iterData);
+		return true;
+	default:
+		return false;
+	}
+}
+
+template<typename _Ty>
+inline auto tryFromPackedArray(const Json::Value& jvData, _Ty& retArray, ErrorList& errors)->typename std::enable_if<!std::is_arithmetic<extract_value_type_t<_Ty>>::value, bool>::type
+{
+	return false;
+}
+
+//容器数组，不并行转换
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_std_list<_Ty>::value && !is_byte_vector<_Ty>::value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	data.clear();
+	reserve_elements(data, json_element_count(jvData), 0);
+	if (tryFromPackedArray(jvData, data, errors))
+		return;
+	size_t index = 0;
+	for (const auto& iterJv : jvData.ArrayRange())
+	{
+		if (errors.stopped())
+			break;
+		extract_type value{};
+		errors.pushIndex(index++);
+		tryFromJson(iterJv, value, errors);
+		errors.popPath();
+		append_element(data, std::move(value), 0);
+	}
+}
+
+//二进制数据
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_byte_vector<_Ty>::value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	data.clear();
+	if (jvData.JSONType() == Json::emJsonType::String)
+	{
+		if (!decode_bytes(jvData.str_view(), data))
+			errors.add(emParseError::TypeMismatch, "base64", base64_error(jvData.str_view()).what());
+		return;
+	}
+	data.reserve(json_element_count(jvData));
+	size_t index = 0;
+	for (const auto& iterJv : jvData.ArrayRange())
+	{
+		if (errors.stopped())
+			break;
+		extract_type value{};
+		errors.pushIndex(index++);
+		tryFromJson(iterJv, value, errors);
+		errors.popPath();
+		data.push_back(value);
+	}
+}
+
+//map
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_map<_Ty>::value>::type
+{
+	data.clear();
+	reserve_elements(data, json_element_count(jvData), 0);
+	for (const auto& iterMap : jvData.ObjectRange())
+	{
+		if (errors.stopped())
+			break;
+		errors.pushKey(iterMap.first);
+		tryFromJson(iterMap.second, data[iterMap.first], errors);
+		errors.popPath();
+	}
+}
+
+//std::variant中的空类型
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_monostate<_Ty>::value>::type
+{
+}
+
+//元素个数与std::array、tuple不一致时为TypeMismatch
+inline bool check_fixed_size(const Json::Value& jvData, size_t size, ErrorList& errors)
+{
+	if (jvData.length() == static_cast<int>(size))
+		return true;
+	errors.add(emParseError::TypeMismatch, "array", "expected " + std::to_string(size) + " elements");
+	return false;
+}
+
+//std::array
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_std_array<_Ty>::value>::type
+{
+	if (!check_fixed_size(jvData, data.size(), errors))
+		return;
+	size_t index = 0;
+	for (const auto& iterJv : jvData.ArrayRange())
+	{
+		if (errors.stopped())
+			break;
+		errors.pushIndex(index);
+		tryFromJson(iterJv, data[index++], errors);
+		errors.popPath();
+	}
+}
+
+//pair、tuple
+template<typename _Tuple, size_t... I>
+inline void tryFromJsonTuple(const Json::Value& jvData, _Tuple& data, ErrorList& errors, std::index_sequence<I...>)
+{
+	int order[] = { 0, (errors.stopped() ? 0 : (errors.pushIndex(I), tryFromJson(jvData.at(static_cast<unsigned>(I)), std::get<I>(data), errors), errors.popPath(), 0))... };
+	(void)order;
+}
+
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_std_tuple<_Ty>::value>::type
+{
+	if (check_fixed_size(jvData, std::tuple_size<_Ty>::value, errors))
+		tryFromJsonTuple(jvData, data, errors, std::make_index_sequence<std::tuple_size<_Ty>::value>());
+}
+
+#ifdef MMR_JSON_CPP17
+//variant，没有可以接受该Json类型的成员时为TypeMismatch
+template<size_t I, typename _Ty>
+inline void tryFromJsonVariantAt(const Json::Value& jvData, _Ty& data, ErrorList& errors)
+{
+	tryFromJson(jvData, data.template emplace<I>(), errors);
+}
+
+template<typename _Ty, size_t... I>
+inline void tryFromJsonVariant(const Json::Value& jvData, _Ty& data, ErrorList& errors, size_t index, std::index_sequence<I...>)
+{
+	using FromFunc = void(*)(const Json::Value&, _Ty&, ErrorList&);
+	static constexpr FromFunc funcs[] = { &tryFromJsonVariantAt<I, _Ty>... };
+	funcs[index](jvData, data, errors);
+}
+
+template<typename _Ty>
+inline auto tryFromJson(const Json::Value& jvData, _Ty& data, ErrorList& errors)->typename std::enable_if<is_std_variant<_Ty>::value>::type
+{
+	size_t index = variant_select(static_cast<const _Ty*>(nullptr), json_kind(jvData));
+	if (index == std::variant_size<_Ty>::value)
+		errors.add(emParseError::TypeMismatch, "variant");
+	else
+		tryFromJsonVariant(jvData, data, errors, index, std::make_index_sequence<std::variant_size<_Ty>::value>());
+}
+#endif // MMR_JSON_CPP17
+
+//不抛出异常的转换，用于批量校验：errors先清空，再记录所有错误的Json路径和期望的类型，没有错误时返回true
+//有错误时data为部分转换的结果
+template<typename _Ty>
+inline bool tryParse(const Json::Value& jvData, _Ty& data, ErrorList& errors)
+{
+	errors.clear();
+	tryFromJson(jvData, data, errors);
+	return errors.empty();
+}
+
+/*****************************************************************/
+/*                         类型数据转Json函数                    */
+/*****************************************************************/
+// 基础情况
+inline void generatJsonVars(Json::Value& jvData, const char* name) {}
+
+// 递归模板函数
+template<typename T, typename... Args>
+inline void generatJsonVars(Json::Value& jvData, const char* name, const T& value, Args&&... args)
+{
+	// 提取当前变量名（直到第一个逗号或结束）
+	const char* comma = strchr(name, ',');
+	if (comma)
+	{
+		jvData[trim(name, comma)] = toJson(value);
+		generatJsonVars(jvData, comma + 1, args...);
+	}
+	else
+	{
+		jvData[trim(name, name + strlen(name))] = toJson(value);
+	}
+}
+
+//使用编译期生成的成员名称表
+inline void generatJsonVars(Json::Value& jvData, const MemberName* pName) {}
+
+template<typename T, typename... Args>
+inline void generatJsonVars(Json::Value& jvData, const MemberName* pName, const T& value, Args&&... args)
+{
+	jvData.set(std::string_view(pName->data, pName->len), toJson(value));
+	generatJsonVars(jvData, pName + 1, args...);
+}
+
+//整体转换的基类生成的对象成员逐个输出到当前对象中
+inline void writeJsonObjectMembers(Json::Writer& writer, const Json::Value& jvData)
+{
+	for (const auto& iter : jvData.ObjectRange())
+	{
+		writer.writeKey(iter.first);
+		writer.writeValue(iter.second);
+	}
+}
+
+inline void writeJsonVars(Json::Writer& writer, const MemberName* pName) {}
+
+template<typename T, typename... Args>
+inline void writeJsonVars(Json::Writer& writer, const MemberName* pName, const T& value, Args&&... args)
+{
+	writer.writeKey(pName->data, pName->len);
+	writeJson(writer, value);
+	writeJsonVars(writer, pName + 1, args...);
+}
+
+/*****************************************************************/
+/*                      修改过的成员生成补丁                     */
+/*****************************************************************/
+//成员的序号，不是注册的成员时返回成员个数
+inline size_t member_index(const void* pMember, size_t index) { return index; }
+
+template<typename T, typename... Args>
+inline size_t member_index(const void* pMember, size_t index, const T& value, const Args&... args)
+{
+	return pMember == static_cast<const void*>(&value) ? index : member_index(pMember, index + 1, args...);
+}
+
+//类型可以比较时只在值不同时赋值，返回是否修改
+template<typename T, typename V>
+inline auto assign_if_changed(T& member, V&& value, int)->decltype(member != value, bool())
+{
+	if (!(member != value))
+		return false;
+	member = std::forward<V>(value);
+	return true;
+}
+
+template<typename T, typename V>
+inline bool assign_if_changed(T& member, V&& value, long)
+{
+	member = std::forward<V>(value);
+	return true;
+}
+
+inline void generatJsonPatchVars(Json::Value& jvData, const MemberName* pName, const uint64_t* pDirty, size_t index) {}
+
+template<typename T, typename... Args>
+inline void generatJsonPatchVars(Json::Value& jvData, const MemberName* pName, const uint64_t* pDirty, size_t index, const T& value, Args&&... args)
+{
+	if (is_member_seen(pDirty, index))
+		jvData.set(std::string_view(pName->data, pName->len), toJson(value));
+	generatJsonPatchVars(jvData, pName + 1, pDirty, index + 1, args...);
+}
+
+inline void writeJsonPatchVars(Json::Writer& writer, const MemberName* pName, const uint64_t* pDirty, size_t index) {}
+
+template<typename T, typename... Args>
+inline void writeJsonPatchVars(Json::Writer& writer, const MemberName* pName, const uint64_t* pDirty, size_t index, const T& value, Args&&... args)
+{
+	if (is_member_seen(pDirty, index))
+	{
+		writer.writeKey(pName->data, pName->len);
+		writeJson(writer, value);
+	}
+	writeJsonPatchVars(writer, pName + 1, pDirty, index + 1, args...);
+}
+
+/*****************************************************************/
+/*                    Json文本转结构体成员函数                   */
+/*****************************************************************/
+template<size_t I, typename _Tuple>
+inline void readJsonVar(MemberReadState& state, _Tuple& members)
+{
+	using dataType = std::decay_t<std::tuple_element_t<I, _Tuple>>;
+	if (state.pErrors)
+		tryFromJson(*state.pValue, std::get<I>(members), *state.pErrors);
+	else if (state.pMoveValue)
+		std::get<I>(members) = fromJson<dataType>(std::move(*state.pMoveValue));
+	else if (state.pValue)
+		std::get<I>(members) = fromJson<dataType>(*state.pValue);
+	else
+		std::get<I>(members) = readJson<dataType>(*state.pReader);
+}
+
+//按成员序号跳转到对应的读取函数
+template<typename _Tuple, size_t... I>
+inline void readJsonVarAt(MemberReadState& state, _Tuple& members, size_t index, std::index_sequence<I...>)
+{
+	using ReadFunc = void(*)(MemberReadState&, _Tuple&);
+	static constexpr ReadFunc funcs[] = { &readJsonVar<I, _Tuple>... };
+	funcs[index](state, members);
+}
+
+//读取state.key对应的成员，不是本类的成员时返回false；offset为本类成员在pSeen中的起始位置
+template<size_t N, typename _Tuple>
+inline bool readJsonVars(MemberReadState& state, const MemberNameTable<N>& table, _Tuple&& members, size_t offset = 0)
+{
+	size_t index = find_member(table, state.key);
+	if (index == N)
+		return false;
+	readJsonVarAt(state, members, index, std::make_index_sequence<N>());
+	set_member_seen(state.pSeen, offset + index);
+	return true;
+}
+
+//缺少非optional、数组、智能指针成员时抛出异常，与parseJsonVars规则一致；pErrors不为空时记录为MissingKey
+inline void checkJsonVars(const uint64_t* pSeen, ErrorList* pErrors, size_t index, const MemberName* pName) {}
+
+template<typename T, typename... Args>
+inline void checkJsonVars(const uint64_t* pSeen, ErrorList* pErrors, size_t index, const MemberName* pName, const T& value, Args&&... args)
+{
+	using dataType = std::decay_t<T>;
+	if (!is_member_seen(pSeen, index) && !is_optional<dataType>::value && !is_std_list<dataType>::value && !is_smart_ptr<dataType>::value)
+	{
+		if (!pErrors)
+			throw std::runtime_error(std::string("Key [" + std::string(pName->data, pName->len) + "] do not exist."));
+		pErrors->pushKey(std::string_view(pName->data, pName->len));
+		pErrors->add(emParseError::MissingKey, expected_type_name<dataType>());
+		pErrors->popPath();
+	}
+	checkJsonVars(pSeen, pErrors, index + 1, pName + 1, args...);
+}
+
+//读取一个对象，N为包含基类在内的成员个数，未知的键直接跳过
+template<size_t N, typename _FuncRead, typename _FuncCheck>
+inline void readJsonObject(Json::Reader& reader, _FuncRead&& funcRead, _FuncCheck&& funcCheck)
+{
+	uint64_t seen[(N + 63) / 64] = {};
+	MemberReadState state{ &reader, nullptr, nullptr, std::string(), std::string_view(), seen, nullptr };
+	if (reader.peek() != '{')
+		reader.skipValue();//与parseJsonVars一致，不是对象时按成员都不存在处理
+	else if (reader.beginObject())
+	{
+		do
+		{
+			reader.readKey(state.strKey);
+			state.key = state.strKey;
+			if (!funcRead(state))
+				reader.skipValue();
+		} while (reader.nextElement('}'));
+	}
+	funcCheck(seen);
+}
+
+//遍历一次Json对象，每个成员按键分派到结构体成员，不生成键的字符串
+template<size_t N, typename _FuncRead, typename _FuncCheck>
+inline void parseJsonObject(const Json::Value& jvData, _FuncRead&& funcRead, _FuncCheck&& funcCheck)
+{
+	uint64_t seen[(N + 63) / 64] = {};
+	MemberReadState state{ nullptr, nullptr, nullptr, std::string(), std::string_view(), seen, nullptr };
+	jvData.for_each_member([&](const std::string& key, const Json::Value& value) {
+		state.key = key;
+		state.pValue = &value;
+		funcRead(state);
+	});
+	funcCheck(seen);
+}
+
+//右值Json::Value，成员的值转移到结构体中
+template<size_t N, typename _FuncRead, typename _FuncCheck>
+inline void parseJsonObject(Json::Value&& jvData, _FuncRead&& funcRead, _FuncCheck&& funcCheck)
+{
+	uint64_t seen[(N + 63) / 64] = {};
+	MemberReadState state{ nullptr, nullptr, nullptr, std::string(), std::string_view(), seen, nullptr };
+	jvData.for_each_member([&](const std::string& key, Json::Value& value) {
+		state.key = key;
+		state.pValue = &value;
+		state.pMoveValue = &value;
+		funcRead(state);
+	});
+	funcCheck(seen);
+}
+
+//不抛出异常的转换，成员的错误记录到errors中，按照策略停止后不再转换后面的成员
+template<size_t N, typename _FuncRead, typename _FuncCheck>
+inline void tryParseJsonObject(const Json::Value& jvData, ErrorList& errors, _FuncRead&& funcRead, _FuncCheck&& funcCheck)
+{
+	uint64_t seen[(N + 63) / 64] = {};
+	MemberReadState state{ nullptr, nullptr, nullptr, std::string(), std::string_view(), seen, &errors };
+	jvData.for_each_member([&](const std::string& key, const Json::Value& value) {
+		if (errors.stopped())
+			return;
+		state.key = key;
+		state.pValue = &value;
+		errors.pushKey(key);
+		funcRead(state);
+		errors.popPath();
+	});
+	if (!errors.stopped())
+		funcCheck(seen, &errors);
+}
+
+/*****************************************************************/
+/*                        Json转数据类型函数                     */
+/*****************************************************************/
+inline void parseJsonVars(const Json::Value& jvData, const char* name) {}
+
+// 递归模板函数
+template<typename T, typename... Args>
+inline void parseJsonVars(const Json::Value& jvData, const char* name, T& value, Args&&... args)
+{
+	// 提取当前变量名（直到第一个逗号或结束）
+	using dataType = std::decay_t<T>;
+	const char* comma = strchr(name, ',');
+	if (comma)
+	{
+		std::string strKey = trim(name, comma);
+		if (jvData.hasKey(strKey))
+			value = fromJson<dataType>(jvData.at(strKey));
+		else if (!is_optional<dataType>::value && !is_std_list<dataType>::value && !is_smart_ptr<dataType>::value)
+			throw std::runtime_error(std::string("Key [" + strKey + "] do not exist."));
+		parseJsonVars(jvData, comma + 1, args...);
+	}
+	else
+	{
+		std::string strKey = trim(name, name + strlen(name));
+		if (jvData.hasKey(strKey))
+			value = fromJson<dataType>(jvData.at(strKey));
+		else if (!is_optional<dataType>::value && !is_std_list<dataType>::value && !is_smart_ptr<dataType>::value)
+			throw std::runtime_error(std::string("Key [" + strKey + "] do not exist."));
+	}
+}
+
+
+/*****************************************************************/
+/*                        结构体二进制编码                       */
+/*****************************************************************/
+//用于服务间传输，与toJson/fromJson支持的类型相同，按注册顺序依次编码成员，不保存成员名称：
+//	bool为1字节，整数为varint（有符号整数先zigzag编码），浮点数为原始的IEEE字节（按小端主机）
+//	字符串为varint长度加原始字节（不转义），Json::Value成员及没有二进制接口的结构体为dumpFast文本
+//	数组、map为varint元素个数加元素，浮点数及单字节整数的std::vector整块复制
+//	结构体成员中的optional、智能指针是否有值记录在结构体开头的位图中，容器元素中的用1字节记录
+//	多态智能指针先写入实际类型的数字标签（polymorphic_tag），再写入实际类型的成员
+class BinaryWriter
+{
+public:
+	explicit BinaryWriter(std::string& strOut) : m_strOut(strOut) {}
+
+	std::string& str() { return m_strOut; }
+
+	void writeByte(uint8_t byte) { m_strOut.push_back(static_cast<char>(byte)); }
+
+	void writeRaw(const void* pData, size_t len) { m_strOut.append(static_cast<const char*>(pData), len); }
+
+	void writeVarint(uint64_t value) {
+		char buf[10];
+		size_t len = 0;
+		while (value >= 0x80)
+		{
+			buf[len++] = static_cast<char>(value | 0x80);
+			value >>= 7;
+		}
+		buf[len++] = static_cast<char>(value);
+		m_strOut.append(buf, len);
+	}
+
+	void writeZigzag(int64_t value) {
+		writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+	}
+
+	void writeFixed64(uint64_t value) { writeRaw(&value, sizeof(value)); }
+
+private:
+	std::string& m_strOut;
+};
+
+//数据不完整或格式错误时抛出异常
+class BinaryReader
+{
+public:
+	explicit BinaryReader(const std::string_view& str) : m_str(str), m_offset(0) {}
+
+	size_t offset() const { return m_offset; }
+	bool finished() const { return m_offset == m_str.size(); }
+
+	uint8_t readByte() {
+		require(1);
+		return static_cast<uint8_t>(m_str[m_offset++]);
+	}
+
+	void readRaw(void* pData, size_t len) {
+		require(len);
+		if (len)
+			memcpy(pData, m_str.data() + m_offset, len);
+		m_offset += len;
+	}
+
+	std::string_view readView(size_t len) {
+		require(len);
+		std::string_view view = m_str.substr(m_offset, len);
+		m_offset += len;
+		return view;
+	}
+
+	uint64_t readVarint() {
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			uint8_t byte = readByte();
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+		throw std::runtime_error("binary varint too long.");
+	}
+
+	int64_t readZigzag() {
+		uint64_t value = readVarint();
+		return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+	}
+
+	uint64_t readFixed64() {
+		uint64_t value = 0;
+		readRaw(&value, sizeof(value));
+		return value;
+	}
+
+	//元素个数，每个元素至少占1字节，超过剩余长度时为错误数据，避免按错误的个数分配内存
+	size_t readCount() {
+		uint64_t count = readVarint();
+		if (count > m_str.size() - m_offset)
+			throw std::runtime_error("binary element count out of range.");
+		return static_cast<size_t>(count);
+	}
+
+private:
+	void require(size_t len) {
+		if (len > m_str.size() - m_offset)
+			throw std::runtime_error("binary data truncated.");
+	}
+
+	std::string_view m_str;
+	size_t m_offset;
+};
+
+//结构体是否有ADD_JSON_MEMBER*生成的二进制接口
+template<typename T, typename = void>
+struct enable_binary_convert : std::false_type {};
+template<typename T>
+struct enable_binary_convert<T,
+	decltype(std::declval<const T&>().writeBinary(std::declval<BinaryWriter&>())
+		, std::declval<T&>().readBinary(std::declval<BinaryReader&>())
+		, void())>
+	:std::true_type {};
+
+//optional或智能指针，可能没有值
+template<typename T>
+struct is_nullable : std::integral_constant<bool, is_optional<T>::value || is_smart_ptr<T>::value> {};
+
+//可以整块复制的数组元素
+template<typename T>
+struct is_binary_block : std::integral_constant<bool, std::is_floating_point<T>::value
+	|| (std::is_integral<T>::value && sizeof(T) == 1 && !std::is_same<T, bool>::value)> {};
+#ifdef MMR_JSON_CPP17
+template<>
+struct is_binary_block<std::byte> : std::true_type {};
+#endif // MMR_JSON_CPP17
+
+//可以整块复制的数组：元素可以整块复制的std::vector或std::array
+template<typename T>
+struct is_binary_block_array : std::integral_constant<bool, is_binary_block<extract_value_type_t<T>>::value
+	&& (std::is_same<T, std::vector<extract_value_type_t<T>>>::value || is_std_array<T>::value)> {};
+
+//模式哈希，由成员名称和成员类型计算，编码和解码的结构体定义不一致时拒绝解码
+constexpr uint64_t schema_combine(uint64_t seed, uint64_t value)
+{
+	return (seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2))) * 0x100000001b3ull;
+}
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<std::is_arithmetic<_Ty>::value, uint64_t>::type;
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<std::is_enum<_Ty>::value, uint64_t>::type;
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_time_point<_Ty>::value || is_duration<_Ty>::value, uint64_t>::type;
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<std::is_same<_Ty, std::string>::value || std::is_same<_Ty, Json::Value>::value, uint64_t>::type;
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<enable_json_convert<_Ty>::value, uint64_t>::type;
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_nullable<_Ty>::value || is_std_list<_Ty>::value || is_map<_Ty>::value, uint64_t>::type;
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_monostate<_Ty>::value, uint64_t>::type;
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_std_array<_Ty>::value, uint64_t>::type;
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_std_tuple<_Ty>::value || is_std_variant<_Ty>::value, uint64_t>::type;
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<std::is_arithmetic<_Ty>::value, uint64_t>::type
+{
+	return std::is_same<_Ty, bool>::value ? 1 : (std::is_floating_point<_Ty>::value ? 0x40 : (std::is_signed<_Ty>::value ? 0x20 : 0x30)) + sizeof(_Ty);
+}
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<std::is_enum<_Ty>::value, uint64_t>::type
+{
+	return schema_combine(5, schema_hash<typename std::underlying_type<_Ty>::type>());
+}
+
+//时间点、时间长度，单位不同时不兼容
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_time_point<_Ty>::value || is_duration<_Ty>::value, uint64_t>::type
+{
+	return schema_combine(schema_combine(schema_combine(is_time_point<_Ty>::value ? 18 : 19, _Ty::period::num), _Ty::period::den),
+		schema_hash<typename _Ty::rep>());
+}
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<std::is_same<_Ty, std::string>::value || std::is_same<_Ty, Json::Value>::value, uint64_t>::type
+{
+	return std::is_same<_Ty, std::string>::value ? 6 : 7;
+}
+
+//嵌套的结构体只计算其成员名称，自身嵌套的结构体不会无限递归
+template<typename _Ty>
+constexpr auto schema_hash_struct(int)->decltype(_Ty::jsonNameHash())
+{
+	return schema_combine(8, _Ty::jsonNameHash());
+}
+
+template<typename _Ty>
+constexpr uint64_t schema_hash_struct(long)
+{
+	return 9;
+}
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<enable_json_convert<_Ty>::value, uint64_t>::type
+{
+	return schema_hash_struct<_Ty>(0);
+}
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_nullable<_Ty>::value || is_std_list<_Ty>::value || is_map<_Ty>::value, uint64_t>::type
+{
+	return schema_combine(is_optional<_Ty>::value ? 10 : (is_smart_ptr<_Ty>::value ? 11 : (is_std_list<_Ty>::value ? 12 : 13)),
+		schema_hash<extract_value_type_t<_Ty>>());
+}
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_monostate<_Ty>::value, uint64_t>::type
+{
+	return 14;
+}
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_std_array<_Ty>::value, uint64_t>::type
+{
+	return schema_combine(schema_combine(15, std::tuple_size<_Ty>::value), schema_hash<extract_value_type_t<_Ty>>());
+}
+
+template<typename... T>
+constexpr uint64_t schema_hash_pack(uint64_t seed)
+{
+	const uint64_t codes[] = { 0, schema_hash<T>()... };
+	for (size_t i = 1; i < sizeof(codes) / sizeof(codes[0]); ++i)
+		seed = schema_combine(seed, codes[i]);
+	return seed;
+}
+
+template<typename T1, typename T2>
+constexpr uint64_t schema_hash_of(const std::pair<T1, T2>*) { return schema_hash_pack<T1, T2>(16); }
+template<typename... T>
+constexpr uint64_t schema_hash_of(const std::tuple<T...>*) { return schema_hash_pack<T...>(16); }
+#ifdef MMR_JSON_CPP17
+template<typename... T>
+constexpr uint64_t schema_hash_of(const std::variant<T...>*) { return schema_hash_pack<T...>(17); }
+#endif // MMR_JSON_CPP17
+
+template<typename _Ty>
+constexpr auto schema_hash()->typename std::enable_if<is_std_tuple<_Ty>::value || is_std_variant<_Ty>::value, uint64_t>::type
+{
+	return schema_hash_of(static_cast<const _Ty*>(nullptr));
+}
+
+//成员类型依次合并到seed中，_Tuple为std::tie(成员...)的类型
+template<typename _Tuple>
+struct schema_tuple;
+template<typename... T>
+struct schema_tuple<std::tuple<T...>>
+{
+	static constexpr uint64_t hash(uint64_t seed)
+	{
+		const uint64_t codes[] = { schema_hash<std::decay_t<T>>()... };
+		for (uint64_t code : codes)
+			seed = schema_combine(seed, code);
+		return seed;
+	}
+};
+
+//编码数据开头的模式哈希，结构体包含全部成员的类型
+template<typename _Ty>
+constexpr auto binary_schema_hash(int)->decltype(_Ty::jsonSchemaHash())
+{
+	return _Ty::jsonSchemaHash();
+}
+
+template<typename _Ty>
+constexpr uint64_t binary_schema_hash(long)
+{
+	return schema_hash<_Ty>();
+}
+
+//容器嵌套时需要先声明
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<std::is_arithmetic<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<std::is_enum<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_time_point<_Ty>::value || is_duration<_Ty>::value>::type;
+inline void writeBinary(BinaryWriter& writer, const std::string& data);
+inline void writeBinary(BinaryWriter& writer, const Json::Value& data);
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<enable_json_convert<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_nullable<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_std_list<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_map<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_monostate<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_std_array<_Ty>::value>::type;
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_std_tuple<_Ty>::value>::type;
+#ifdef MMR_JSON_CPP17
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_std_variant<_Ty>::value>::type;
+#endif // MMR_JSON_CPP17
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<std::is_arithmetic<_Ty>::value>::type;
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<std::is_enum<_Ty>::value>::type;
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_time_point<_Ty>::value || is_duration<_Ty>::value>::type;
+inline void readBinary(BinaryReader& reader, std::string& data);
+inline void readBinary(BinaryReader& reader, Json::Value& data);
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<enable_json_convert<_Ty>::value>::type;
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_nullable<_Ty>::value>::type;
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_std_list<_Ty>::value>::type;
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_map<_Ty>::value>::type;
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_monostate<_Ty>::value>::type;
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_std_array<_Ty>::value>::type;
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_std_tuple<_Ty>::value>::type;
+#ifdef MMR_JSON_CPP17
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_std_variant<_Ty>::value>::type;
+#endif // MMR_JSON_CPP17
+
+//数字类型
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<std::is_arithmetic<_Ty>::value>::type
+{
+	if (std::is_same<_Ty, bool>::value)
+		writer.writeByte(data ? 1 : 0);
+	else if (std::is_floating_point<_Ty>::value)
+		writer.writeRaw(&data, sizeof(data));
+	else if (std::is_signed<_Ty>::value)
+		writer.writeZigzag(static_cast<int64_t>(data));
+	else
+		writer.writeVarint(static_cast<uint64_t>(data));
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<std::is_arithmetic<_Ty>::value>::type
+{
+	if (std::is_same<_Ty, bool>::value)
+		data = reader.readByte() != 0;
+	else if (std::is_floating_point<_Ty>::value)
+		reader.readRaw(&data, sizeof(data));
+	else if (std::is_signed<_Ty>::value)
+		data = static_cast<_Ty>(reader.readZigzag());
+	else
+		data = static_cast<_Ty>(reader.readVarint());
+}
+
+//枚举类型
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<std::is_enum<_Ty>::value>::type
+{
+	writeBinary(writer, static_cast<typename std::underlying_type<_Ty>::type>(data));
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<std::is_enum<_Ty>::value>::type
+{
+	typename std::underlying_type<_Ty>::type value;
+	readBinary(reader, value);
+	data = static_cast<_Ty>(value);
+}
+
+//时间点、时间长度，写入自身单位的数值
+template<typename R, typename P>
+constexpr R time_count(const std::chrono::duration<R, P>& data) { return data.count(); }
+template<typename C, typename D>
+constexpr typename D::rep time_count(const std::chrono::time_point<C, D>& data) { return data.time_since_epoch().count(); }
+
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_time_point<_Ty>::value || is_duration<_Ty>::value>::type
+{
+	writeBinary(writer, time_count(data));
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_time_point<_Ty>::value || is_duration<_Ty>::value>::type
+{
+	typename _Ty::rep value;
+	readBinary(reader, value);
+	data = _Ty(std::chrono::duration<typename _Ty::rep, typename _Ty::period>(value));
+}
+
+//字符串类型
+inline void writeBinary(BinaryWriter& writer, const std::string& data)
+{
+	writer.writeVarint(data.size());
+	writer.writeRaw(data.data(), data.size());
+}
+
+inline void readBinary(BinaryReader& reader, std::string& data)
+{
+	std::string_view view = reader.readView(reader.readCount());
+	data.assign(view.data(), view.size());
+}
+
+//JSON类型，保存为Json文本
+inline void writeBinary(BinaryWriter& writer, const Json::Value& data)
+{
+	writeBinary(writer, data.dumpFast());
+}
+
+inline void readBinary(BinaryReader& reader, Json::Value& data)
+{
+	std::string_view view = reader.readView(reader.readCount());
+	std::string strErr = data.load(view);
+	if (!strErr.empty())
+		throw std::runtime_error(strErr);
+}
+
+//结构体，没有二进制接口时（自定义的转换接口）保存为Json文本
+template<typename _Ty>
+inline auto writeBinaryStruct(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<enable_binary_convert<_Ty>::value>::type
+{
+	data.writeBinary(writer);
+}
+
+template<typename _Ty>
+inline auto writeBinaryStruct(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<!enable_binary_convert<_Ty>::value>::type
+{
+	writeBinary(writer, toJson(data));
+}
+
+template<typename _Ty>
+inline auto readBinaryStruct(BinaryReader& reader, _Ty& data)->typename std::enable_if<enable_binary_convert<_Ty>::value>::type
+{
+	data.readBinary(reader);
+}
+
+template<typename _Ty>
+inline auto readBinaryStruct(BinaryReader& reader, _Ty& data)->typename std::enable_if<!enable_binary_convert<_Ty>::value>::type
+{
+	Json::Value jvData;
+	readBinary(reader, jvData);
+	data = fromJson<_Ty>(jvData);
+}
+
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<enable_json_convert<_Ty>::value>::type
+{
+	writeBinaryStruct(writer, data);
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<enable_json_convert<_Ty>::value>::type
+{
+	readBinaryStruct(reader, data);
+}
+
+//optional或智能指针有值时写入的内容，多态类型先写入实际类型的标签
+template<typename _Ty>
+inline auto writeBinaryPresent(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<!enable_json_convert_depl<extract_value_type_t<_Ty>>::value>::type
+{
+	writeBinary(writer, *data);
+}
+
+template<typename _Ty>
+inline auto writeBinaryPresent(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<enable_json_convert_depl<extract_value_type_t<_Ty>>::value>::type
+{
+	writer.writeVarint(data->binaryTypeTag());
+	data->writeBinary(writer);
+}
+
+template<typename _Ty>
+inline auto readBinaryPresent(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_optional<_Ty>::value>::type
+{
+	data.emplace();
+	readBinary(reader, *data);
+}
+
+template<typename _Ty>
+inline auto readBinaryPresent(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& !enable_json_convert_depl<extract_value_type_t<_Ty>>::value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	std::unique_ptr<extract_type> ptrRet = std::make_unique<extract_type>();
+	readBinary(reader, *ptrRet);
+	data = std::move(ptrRet);
+}
+
+template<typename _Ty>
+inline auto readBinaryPresent(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_smart_ptr<_Ty>::value
+	&& enable_json_convert_depl<extract_value_type_t<_Ty>>::value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	uint64_t tag = reader.readVarint();
+	if (tag > UINT32_MAX)
+		throw std::runtime_error("binary type tag out of range.");
+	auto ptrRet = genPolymorphic<extract_type>(static_cast<uint32_t>(tag));
+	ptrRet->readBinary(reader);
+	data = std::move(ptrRet);
+}
+
+inline bool is_present(const void*) { return true; }
+
+template<typename _Ty>
+inline auto is_present(const _Ty& data)->typename std::enable_if<is_nullable<_Ty>::value, bool>::type
+{
+	return static_cast<bool>(data);
+}
+
+//optional或智能指针，1字节记录是否有值
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_nullable<_Ty>::value>::type
+{
+	writer.writeByte(data ? 1 : 0);
+	if (data)
+		writeBinaryPresent(writer, data);
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_nullable<_Ty>::value>::type
+{
+	if (reader.readByte())
+		readBinaryPresent(reader, data);
+	else
+		data = _Ty();
+}
+
+//容器数组
+template<typename _Ty>
+inline auto writeBinaryArray(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_binary_block_array<_Ty>::value>::type
+{
+	writer.writeRaw(data.data(), data.size() * sizeof(extract_value_type_t<_Ty>));
+}
+
+template<typename _Ty>
+inline auto writeBinaryArray(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<!is_binary_block_array<_Ty>::value>::type
+{
+	for (const auto& iter : data)
+		writeBinary(writer, iter);
+}
+
+template<typename _Ty>
+inline auto readBinaryArray(BinaryReader& reader, _Ty& data, size_t count)->typename std::enable_if<is_binary_block_array<_Ty>::value>::type
+{
+	data.resize(count);
+	reader.readRaw(data.data(), count * sizeof(extract_value_type_t<_Ty>));
+}
+
+template<typename _Ty>
+inline auto readBinaryArray(BinaryReader& reader, _Ty& data, size_t count)->typename std::enable_if<!is_binary_block_array<_Ty>::value>::type
+{
+	using extract_type = extract_value_type_t<_Ty>;
+	reserve_elements(data, count, 0);
+	for (size_t i = 0; i < count; ++i)
+	{
+		extract_type value{};
+		readBinary(reader, value);
+		append_element(data, std::move(value), 0);
+	}
+}
+
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_std_list<_Ty>::value>::type
+{
+	writer.writeVarint(data.size());
+	writeBinaryArray(writer, data);
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_std_list<_Ty>::value>::type
+{
+	data.clear();
+	readBinaryArray(reader, data, reader.readCount());
+}
+
+//map
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_map<_Ty>::value>::type
+{
+	writer.writeVarint(data.size());
+	for (const auto& iter : data)
+	{
+		writeBinary(writer, iter.first);
+		writeBinary(writer, iter.second);
+	}
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_map<_Ty>::value>::type
+{
+	data.clear();
+	size_t count = reader.readCount();
+	std::string strKey;
+	for (size_t i = 0; i < count; ++i)
+	{
+		readBinary(reader, strKey);
+		readBinary(reader, data.emplace_hint(data.end(), std::move(strKey), extract_value_type_t<_Ty>())->second);
+	}
+}
+
+//std::variant中的空类型，不写入内容
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_monostate<_Ty>::value>::type
+{
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_monostate<_Ty>::value>::type
+{
+}
+
+//std::array，元素个数固定，不写入
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_std_array<_Ty>::value>::type
+{
+	writeBinaryArray(writer, data);
+}
+
+template<typename _Ty>
+inline auto readBinaryFixed(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_binary_block_array<_Ty>::value>::type
+{
+	reader.readRaw(data.data(), sizeof(data));
+}
+
+template<typename _Ty>
+inline auto readBinaryFixed(BinaryReader& reader, _Ty& data)->typename std::enable_if<!is_binary_block_array<_Ty>::value>::type
+{
+	for (auto& iter : data)
+		readBinary(reader, iter);
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_std_array<_Ty>::value>::type
+{
+	readBinaryFixed(reader, data);
+}
+
+//pair、tuple，按顺序写入各个元素
+template<typename _Tuple, size_t... I>
+inline void writeBinaryTuple(BinaryWriter& writer, const _Tuple& data, std::index_sequence<I...>)
+{
+	int order[] = { 0, (writeBinary(writer, std::get<I>(data)), 0)... };
+	(void)order;
+}
+
+template<typename _Tuple, size_t... I>
+inline void readBinaryTuple(BinaryReader& reader, _Tuple& data, std::index_sequence<I...>)
+{
+	int order[] = { 0, (readBinary(reader, std::get<I>(data)), 0)... };
+	(void)order;
+}
+
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_std_tuple<_Ty>::value>::type
+{
+	writeBinaryTuple(writer, data, std::make_index_sequence<std::tuple_size<_Ty>::value>());
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_std_tuple<_Ty>::value>::type
+{
+	readBinaryTuple(reader, data, std::make_index_sequence<std::tuple_size<_Ty>::value>());
+}
+
+#ifdef MMR_JSON_CPP17
+//variant，先写入成员序号
+template<typename _Ty>
+inline auto writeBinary(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_std_variant<_Ty>::value>::type
+{
+	writer.writeVarint(data.index());
+	std::visit([&writer](const auto& value) { writeBinary(writer, value); }, data);
+}
+
+template<size_t I, typename _Ty>
+inline void readBinaryVariantAt(BinaryReader& reader, _Ty& data)
+{
+	readBinary(reader, data.template emplace<I>());
+}
+
+template<typename _Ty, size_t... I>
+inline void readBinaryVariant(BinaryReader& reader, _Ty& data, size_t index, std::index_sequence<I...>)
+{
+	using ReadFunc = void(*)(BinaryReader&, _Ty&);
+	static constexpr ReadFunc funcs[] = { &readBinaryVariantAt<I, _Ty>... };
+	funcs[index](reader, data);
+}
+
+template<typename _Ty>
+inline auto readBinary(BinaryReader& reader, _Ty& data)->typename std::enable_if<is_std_variant<_Ty>::value>::type
+{
+	uint64_t index = reader.readVarint();
+	if (index >= std::variant_size<_Ty>::value)
+		throw std::runtime_error("binary variant index out of range.");
+	readBinaryVariant(reader, data, static_cast<size_t>(index), std::make_index_sequence<std::variant_size<_Ty>::value>());
+}
+#endif // MMR_JSON_CPP17
+
+/*****************************************************************/
+/*                      结构体成员二进制编码                     */
+/*****************************************************************/
+template<typename... Args>
+constexpr size_t count_nullable()
+{
+	const bool flags[] = { is_nullable<Args>::value... };
+	size_t count = 0;
+	for (bool flag : flags)
+		count += flag ? 1 : 0;
+	return count;
+}
+
+template<typename _Ty>
+inline auto set_presence_bit(uint8_t* pBits, size_t& index, const _Ty& data)->typename std::enable_if<is_nullable<_Ty>::value>::type
+{
+	if (data)
+		pBits[index / 8] |= static_cast<uint8_t>(1u << (index % 8));
+	++index;
+}
+
+template<typename _Ty>
+inline auto set_presence_bit(uint8_t* pBits, size_t& index, const _Ty& data)->typename std::enable_if<!is_nullable<_Ty>::value>::type
+{
+}
+
+template<typename _Ty>
+inline auto writeBinaryMember(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<is_nullable<_Ty>::value>::type
+{
+	if (data)
+		writeBinaryPresent(writer, data);
 }
-//optional
+
 template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_optional<_Ty>::value, _Ty>::type
+inline auto writeBinaryMember(BinaryWriter& writer, const _Ty& data)->typename std::enable_if<!is_nullable<_Ty>::value>::type
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	using basic_type = basic_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
-	if (jvData.IsNull())
-		return std::nullopt;
-	else
-		return fromJson<extract_type>(jvData);
+	writeBinary(writer, data);
 }
 
-//容器数组
 template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_std_list<_Ty>::value, _Ty>::type
+inline auto readBinaryMember(BinaryReader& reader, const uint8_t* pBits, size_t& index, _Ty& data)->typename std::enable_if<is_nullable<_Ty>::value>::type
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	using basic_type = basic_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");	_Ty retArray;
-	for (const auto& iterJv : jvData.ArrayRange())
-	{
-		retArray.emplace_back(fromJson<extract_type>(iterJv));
-	}
-	return retArray;
+	bool bPresent = 0 != (pBits[index / 8] & (1u << (index % 8)));
+	++index;
+	if (bPresent)
+		readBinaryPresent(reader, data);
+	else
+		data = _Ty();
 }
 
-//map
 template<typename _Ty>
-inline auto fromJson(const Json::Value& jvData)->typename std::enable_if<is_map<_Ty>::value, _Ty>::type
+inline auto readBinaryMember(BinaryReader& reader, const uint8_t* pBits, size_t& index, _Ty& data)->typename std::enable_if<!is_nullable<_Ty>::value>::type
 {
-	using extract_type = extract_value_type_t<_Ty>;
-	using basic_type = basic_value_type_t<_Ty>;
-	static_assert(is_convertable_to_json_type<basic_type>::value, "basic type error");
-	_Ty mapRet;
-	for (const auto& iterMap : jvData.ObjectRange())
-	{
-		mapRet[iterMap.first] = fromJson<extract_type>(iterMap.second);
-	}
-	return mapRet;
+	readBinary(reader, data);
 }
 
-/*****************************************************************/
-/*                         类型数据转Json函数                    */
-/*****************************************************************/
-// 基础情况
-inline void generatJsonVars(Json::Value& jvData, const char* name) {}
+//先写入optional、智能指针成员是否有值的位图，再按顺序写入成员
+template<typename... Args>
+inline void writeBinaryVars(BinaryWriter& writer, const Args&... args)
+{
+	constexpr size_t bytes = (count_nullable<Args...>() + 7) / 8;
+	uint8_t bits[bytes + 1] = {};
+	size_t index = 0;
+	int order[] = { (set_presence_bit(bits, index, args), 0)... };
+	writer.writeRaw(bits, bytes);
+	int orderWrite[] = { (writeBinaryMember(writer, args), 0)... };
+	(void)order;
+	(void)orderWrite;
+}
 
-// 递归模板函数
-template<typename T, typename... Args>
-inline void generatJsonVars(Json::Value& jvData, const char* name, const T& value, Args&&... args)
+template<typename... Args>
+inline void readBinaryVars(BinaryReader& reader, Args&... args)
 {
-	// 提取当前变量名（直到第一个逗号或结束）
-	const char* comma = strchr(name, ',');
-	if (comma)
-	{
-		jvData[trim(name, comma)] = toJson(value);
-		generatJsonVars(jvData, comma + 1, args...);
-	}
-	else
-	{
-		jvData[trim(name, name + strlen(name))] = toJson(value);
-	}
+	constexpr size_t bytes = (count_nullable<Args...>() + 7) / 8;
+	uint8_t bits[bytes + 1] = {};
+	reader.readRaw(bits, bytes);
+	size_t index = 0;
+	int order[] = { (readBinaryMember(reader, bits, index, args), 0)... };
+	(void)order;
 }
 
-/*****************************************************************/
-/*                        Json转数据类型函数                     */
-/*****************************************************************/
-inline void parseJsonVars(const Json::Value& jvData, const char* name) {}
+//数据编码为二进制，开头为8字节的模式哈希
+template<typename _Ty>
+inline std::string toBinary(const _Ty& data)
+{
+	std::string strOut;
+	BinaryWriter writer(strOut);
+	writer.writeFixed64(std::integral_constant<uint64_t, binary_schema_hash<_Ty>(0)>::value);
+	writeBinary(writer, data);
+	return strOut;
+}
 
-// 递归模板函数
-template<typename T, typename... Args>
-inline void parseJsonVars(const Json::Value& jvData, const char* name, T& value, Args&&... args)
+//二进制解码，模式哈希不一致或数据错误时返回错误信息（包含出错位置），data不变
+template<typename _Ty>
+inline std::string fromBinary(const std::string_view& str, _Ty& data)
 {
-	// 提取当前变量名（直到第一个逗号或结束）
-	using dataType = std::decay_t<T>;
-	const char* comma = strchr(name, ',');
-	if (comma)
+	BinaryReader reader(str);
+	std::string strErr;
+	try
 	{
-		std::string strKey = trim(name, comma);
-		if (jvData.hasKey(strKey))
-			value = fromJson<dataType>(jvData.at(strKey));
-		else if (!is_optional<dataType>::value && !is_std_list<dataType>::value && !is_smart_ptr<dataType>::value)
-			throw std::runtime_error(std::string("Key [" + strKey + "] do not exist."));
-		parseJsonVars(jvData, comma + 1, args...);
+		if (reader.readFixed64() != std::integral_constant<uint64_t, binary_schema_hash<_Ty>(0)>::value)
+			throw std::runtime_error("binary schema hash mismatch.");
+		_Ty temp;
+		readBinary(reader, temp);
+		if (!reader.finished())
+			throw std::runtime_error("more data after binary object.");
+		data = std::move(temp);
 	}
-	else
+	catch (const std::exception& e)
 	{
-		std::string strKey = trim(name, name + strlen(name));
-		if (jvData.hasKey(strKey))
-			value = fromJson<dataType>(jvData.at(strKey));
-		else if (!is_optional<dataType>::value && !is_std_list<dataType>::value && !is_smart_ptr<dataType>::value)
-			throw std::runtime_error(std::string("Key [" + strKey + "] do not exist."));
+		strErr = e.what() + std::string(" offset:") + std::to_string(reader.offset());
 	}
+	return strErr;
 }
 
 }
@@ -434,46 +3904,408 @@ inline void parseJsonVars(const Json::Value& jvData, const char* name, T& value,
 //	return jvData;
 //}
 
+//编译期生成的成员名称表，在函数内定义为静态常量
+#ifndef JSON_INNER_NAME_TABLE
+#define JSON_INNER_NAME_TABLE ANameTableShouldNotBeSameWithStructMember5c1e7b3d2
+#endif //JSON_INNER_NAME_TABLE
+
+#define JSON_MEMBER_NAME_TABLE(...)\
+	static constexpr auto JSON_INNER_NAME_TABLE = \
+		mmrUtil::split_member_names<mmrUtil::count_member_names(#__VA_ARGS__)>(#__VA_ARGS__);
+
 #define ADD_JSON_MEMBER(...) 	\
 public:\
+	static constexpr size_t jsonMemberCount() { return mmrUtil::count_member_names(#__VA_ARGS__); }\
+	static constexpr bool jsonMemberTable() { return true; }\
+	static constexpr uint64_t jsonNameHash() { return Json::key_hash(#__VA_ARGS__, sizeof(#__VA_ARGS__) - 1); }\
+	static constexpr uint64_t jsonSchemaHash() { return mmrUtil::schema_tuple<decltype(std::tie(__VA_ARGS__))>::hash(jsonNameHash()); }\
+Json::Value generateJson() const\
+{\
+	Json::Value JSON_INNER_MEMBER_NAME;\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+	return JSON_INNER_MEMBER_NAME;\
+}\
+void parseJson(const Json::Value& JSON_INNER_MEMBER_NAME)\
+{\
+	mmrUtil::parseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+		[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+		[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+}\
+void parseJson(Json::Value&& JSON_INNER_MEMBER_NAME)\
+{\
+	mmrUtil::parseJsonObject<jsonMemberCount()>(std::move(JSON_INNER_MEMBER_NAME),\
+		[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+		[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+}\
+void tryParseJson(const Json::Value& JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList& JSON_INNER_ERRORS_NAME)/*mmrUtil::tryParse使用，不抛出异常*/\
+{\
+	mmrUtil::tryParseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME,\
+		[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+		[this](const uint64_t* pSeen, mmrUtil::ErrorList* pErrors) { checkJsonMembers(pSeen, pErrors); });\
+}\
+void writeJson(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+{\
+	JSON_INNER_MEMBER_NAME.beginObject();\
+	writeJsonMembers(JSON_INNER_MEMBER_NAME);\
+	JSON_INNER_MEMBER_NAME.endObject();\
+}\
+void readJson(Json::Reader& JSON_INNER_MEMBER_NAME)\
+{\
+	mmrUtil::readJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+		[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+		[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+}\
+void writeBinary(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+{\
+	writeBinaryMembers(JSON_INNER_MEMBER_NAME);\
+}\
+void readBinary(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+{\
+	readBinaryMembers(JSON_INNER_MEMBER_NAME);\
+}\
+protected:\
+friend class Json::Value;\
+void generateJson(Json::Value& JSON_INNER_MEMBER_NAME) const\
+{\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__); \
+}\
+void writeJsonMembers(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+{\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::writeJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__); \
+}\
+bool readJsonMember(mmrUtil::MemberReadState& JSON_INNER_MEMBER_NAME)\
+{\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	return mmrUtil::readJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE, std::tie(__VA_ARGS__));\
+}\
+void checkJsonMembers(const uint64_t* JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList* JSON_INNER_ERRORS_NAME = nullptr) const\
+{\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::checkJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME, 0, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+}\
+void writeBinaryMembers(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+{\
+	mmrUtil::writeBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
+}\
+void readBinaryMembers(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+{\
+	mmrUtil::readBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
+}
+
+
+//Json与结构体互转，并记录修改过的成员，只输出修改过的成员作为补丁
+//成员通过setJsonMember赋值，或直接修改后调用markJsonDirty标记；parseJson时Json中没有的成员保持不变，不抛出异常
+#define ADD_JSON_MEMBER_TRACKED(...) 	\
+public:\
+	static constexpr size_t jsonMemberCount() { return mmrUtil::count_member_names(#__VA_ARGS__); }\
+	static constexpr bool jsonMemberTable() { return true; }\
+	static constexpr uint64_t jsonNameHash() { return Json::key_hash(#__VA_ARGS__, sizeof(#__VA_ARGS__) - 1); }\
+	static constexpr uint64_t jsonSchemaHash() { return mmrUtil::schema_tuple<decltype(std::tie(__VA_ARGS__))>::hash(jsonNameHash()); }\
 Json::Value generateJson() const\
 {\
 	Json::Value JSON_INNER_MEMBER_NAME;\
-	mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__);\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
 	return JSON_INNER_MEMBER_NAME;\
 }\
 void parseJson(const Json::Value& JSON_INNER_MEMBER_NAME)\
 {\
-	mmrUtil::parseJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__); \
+	mmrUtil::parseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+		[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+		[](const uint64_t*) {});\
+}\
+void parseJson(Json::Value&& JSON_INNER_MEMBER_NAME)\
+{\
+	mmrUtil::parseJsonObject<jsonMemberCount()>(std::move(JSON_INNER_MEMBER_NAME),\
+		[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+		[](const uint64_t*) {});\
+}\
+void tryParseJson(const Json::Value& JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList& JSON_INNER_ERRORS_NAME)/*mmrUtil::tryParse使用，不抛出异常*/\
+{\
+	mmrUtil::tryParseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME,\
+		[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+		[](const uint64_t*, mmrUtil::ErrorList*) {});\
+}\
+void writeJson(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+{\
+	JSON_INNER_MEMBER_NAME.beginObject();\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::writeJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+	JSON_INNER_MEMBER_NAME.endObject();\
+}\
+void readJson(Json::Reader& JSON_INNER_MEMBER_NAME)\
+{\
+	mmrUtil::readJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+		[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+		[](const uint64_t*) {});\
+}\
+/*只包含修改过的成员的对象，没有修改时为空对象*/\
+Json::Value generateJsonPatch() const\
+{\
+	Json::Value JSON_INNER_MEMBER_NAME = Json::Value::Make(Json::emJsonType::Object);\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::generatJsonPatchVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, JSON_INNER_DIRTY_NAME, 0, __VA_ARGS__);\
+	return JSON_INNER_MEMBER_NAME;\
+}\
+void writeJsonPatch(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+{\
+	JSON_INNER_MEMBER_NAME.beginObject();\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::writeJsonPatchVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, JSON_INNER_DIRTY_NAME, 0, __VA_ARGS__);\
+	JSON_INNER_MEMBER_NAME.endObject();\
+}\
+template<typename _T>\
+void markJsonDirty(const _T& member)\
+{\
+	size_t index = mmrUtil::member_index(&member, 0, __VA_ARGS__);\
+	if (index < jsonMemberCount())\
+		mmrUtil::set_member_seen(JSON_INNER_DIRTY_NAME, index);\
+}\
+void markJsonDirtyAll()\
+{\
+	for (size_t i = 0; i < jsonMemberCount(); ++i)\
+		mmrUtil::set_member_seen(JSON_INNER_DIRTY_NAME, i);\
+}\
+/*类型可以比较时值不同才赋值并标记*/\
+template<typename _T, typename _V>\
+void setJsonMember(_T& member, _V&& value)\
+{\
+	if (mmrUtil::assign_if_changed(member, std::forward<_V>(value), 0))\
+		markJsonDirty(member);\
+}\
+bool isJsonDirty() const\
+{\
+	for (auto iter : JSON_INNER_DIRTY_NAME)\
+	{\
+		if (iter)\
+			return true;\
+	}\
+	return false;\
+}\
+/*补丁发送后清除修改标记*/\
+void clearJsonDirty()\
+{\
+	for (auto& iter : JSON_INNER_DIRTY_NAME)\
+		iter = 0;\
+}\
+void writeBinary(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+{\
+	mmrUtil::writeBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
+}\
+void readBinary(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+{\
+	mmrUtil::readBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
 }\
 protected:\
 friend class Json::Value;\
+uint64_t JSON_INNER_DIRTY_NAME[(mmrUtil::count_member_names(#__VA_ARGS__) + 63) / 64] = {};\
 void generateJson(Json::Value& JSON_INNER_MEMBER_NAME) const\
 {\
-	mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__); \
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__); \
+}\
+bool readJsonMember(mmrUtil::MemberReadState& JSON_INNER_MEMBER_NAME)\
+{\
+	JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+	return mmrUtil::readJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE, std::tie(__VA_ARGS__));\
 }
 
 
+//派生类访问基类的转换接口，基类没有按成员转换的接口时（只有手写的generateJson/parseJson）整体转换
+#define JSON_MEMBER_BASE_DISPATCH(Base)\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto parseJsonBase(const Json::Value&)->typename std::enable_if<mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type {}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto parseJsonBase(const Json::Value& JSON_INNER_MEMBER_NAME)->typename std::enable_if<!mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		JSON_INNER_BASE_TYPE::parseJson(JSON_INNER_MEMBER_NAME);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto tryParseJsonBase(const Json::Value&, mmrUtil::ErrorList&)->typename std::enable_if<mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type {}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto tryParseJsonBase(const Json::Value& JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList& JSON_INNER_ERRORS_NAME)->typename std::enable_if<!mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		tryParseJsonWhole<JSON_INNER_BASE_TYPE>(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME, 0);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE>/*基类有tryParseJson时（继承自手写接口的结构体）直接调用*/\
+	auto tryParseJsonWhole(const Json::Value& JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList& JSON_INNER_ERRORS_NAME, int)\
+		->decltype(std::declval<JSON_INNER_BASE_TYPE&>().tryParseJson(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME), void())\
+	{\
+		JSON_INNER_BASE_TYPE::tryParseJson(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE>\
+	void tryParseJsonWhole(const Json::Value& JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList& JSON_INNER_ERRORS_NAME, long)\
+	{\
+		try\
+		{\
+			JSON_INNER_BASE_TYPE::parseJson(JSON_INNER_MEMBER_NAME);\
+		}\
+		catch (const std::exception& e)\
+		{\
+			JSON_INNER_ERRORS_NAME.add(mmrUtil::emParseError::Exception, "object", e.what());\
+		}\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto readJsonObjectBase(Json::Reader& JSON_INNER_MEMBER_NAME)->typename std::enable_if<mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		mmrUtil::readJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto readJsonObjectBase(Json::Reader& JSON_INNER_MEMBER_NAME)->typename std::enable_if<!mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		Json::Value jvData = JSON_INNER_MEMBER_NAME.readValue();\
+		JSON_INNER_BASE_TYPE::parseJson(jvData);\
+		mmrUtil::parseJsonObject<jsonMemberCount()>(std::move(jvData),\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto writeJsonBaseMembers(Json::Writer& JSON_INNER_MEMBER_NAME) const->typename std::enable_if<mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		JSON_INNER_BASE_TYPE::writeJsonMembers(JSON_INNER_MEMBER_NAME);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto writeJsonBaseMembers(Json::Writer& JSON_INNER_MEMBER_NAME) const->typename std::enable_if<!mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		Json::Value jvBase;\
+		JSON_INNER_BASE_TYPE::generateJson(jvBase);\
+		mmrUtil::writeJsonObjectMembers(JSON_INNER_MEMBER_NAME, jvBase);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto readJsonBaseMember(mmrUtil::MemberReadState& JSON_INNER_MEMBER_NAME)->typename std::enable_if<mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value, bool>::type\
+	{\
+		return JSON_INNER_BASE_TYPE::readJsonMember(JSON_INNER_MEMBER_NAME);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto readJsonBaseMember(mmrUtil::MemberReadState&)->typename std::enable_if<!mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value, bool>::type\
+	{\
+		return false;\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto checkJsonBaseMembers(const uint64_t* JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList* JSON_INNER_ERRORS_NAME) const->typename std::enable_if<mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		JSON_INNER_BASE_TYPE::checkJsonMembers(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto checkJsonBaseMembers(const uint64_t*, mmrUtil::ErrorList*) const->typename std::enable_if<!mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type {}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto writeBinaryBaseMembers(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const->typename std::enable_if<mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		JSON_INNER_BASE_TYPE::writeBinaryMembers(JSON_INNER_MEMBER_NAME);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto writeBinaryBaseMembers(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const->typename std::enable_if<!mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		Json::Value jvBase;\
+		JSON_INNER_BASE_TYPE::generateJson(jvBase);\
+		mmrUtil::writeBinary(JSON_INNER_MEMBER_NAME, jvBase);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto readBinaryBaseMembers(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)->typename std::enable_if<mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		JSON_INNER_BASE_TYPE::readBinaryMembers(JSON_INNER_MEMBER_NAME);\
+	}\
+	template<typename JSON_INNER_BASE_TYPE = Base>\
+	auto readBinaryBaseMembers(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)->typename std::enable_if<!mmrUtil::has_member_table<JSON_INNER_BASE_TYPE>::value>::type\
+	{\
+		Json::Value jvBase;\
+		mmrUtil::readBinary(JSON_INNER_MEMBER_NAME, jvBase);\
+		JSON_INNER_BASE_TYPE::parseJson(jvBase);\
+	}
+
 #define ADD_JSON_MEMBER_INHERIT(Base, ...) 	\
 public:\
+	static constexpr size_t jsonMemberCount() { return mmrUtil::member_table_base<Base>::count() + mmrUtil::count_member_names(#__VA_ARGS__); }\
+	static constexpr bool jsonMemberTable() { return mmrUtil::has_member_table<Base>::value; }\
+	static constexpr uint64_t jsonNameHash() { return mmrUtil::schema_combine(mmrUtil::member_table_base<Base>::name_hash(), Json::key_hash(#__VA_ARGS__, sizeof(#__VA_ARGS__) - 1)); }\
+	static constexpr uint64_t jsonSchemaHash() { return mmrUtil::schema_tuple<decltype(std::tie(__VA_ARGS__))>::hash(mmrUtil::schema_combine(mmrUtil::member_table_base<Base>::schema_hash(), jsonNameHash())); }\
 	Json::Value generateJson() const\
 	{\
 		Json::Value JSON_INNER_MEMBER_NAME;\
 		Base::generateJson(JSON_INNER_MEMBER_NAME);\
-		mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__);\
+		JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+		mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
 		return JSON_INNER_MEMBER_NAME;\
 	}\
 	void parseJson(const Json::Value& JSON_INNER_MEMBER_NAME)\
 	{\
-		Base::parseJson(JSON_INNER_MEMBER_NAME);\
-		mmrUtil::parseJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__); \
+		parseJsonBase(JSON_INNER_MEMBER_NAME);\
+		mmrUtil::parseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	void parseJson(Json::Value&& JSON_INNER_MEMBER_NAME)\
+	{\
+		parseJsonBase(JSON_INNER_MEMBER_NAME);\
+		mmrUtil::parseJsonObject<jsonMemberCount()>(std::move(JSON_INNER_MEMBER_NAME),\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	void tryParseJson(const Json::Value& JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList& JSON_INNER_ERRORS_NAME)/*mmrUtil::tryParse使用，不抛出异常*/\
+	{\
+		tryParseJsonBase(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME);\
+		mmrUtil::tryParseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME,\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen, mmrUtil::ErrorList* pErrors) { checkJsonMembers(pSeen, pErrors); });\
+	}\
+	void writeJson(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+	{\
+		JSON_INNER_MEMBER_NAME.beginObject();\
+		writeJsonMembers(JSON_INNER_MEMBER_NAME);\
+		JSON_INNER_MEMBER_NAME.endObject();\
+	}\
+	void readJson(Json::Reader& JSON_INNER_MEMBER_NAME)\
+	{\
+		readJsonObjectBase(JSON_INNER_MEMBER_NAME);\
+	}\
+	void writeBinary(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+	{\
+		writeBinaryMembers(JSON_INNER_MEMBER_NAME);\
+	}\
+	void readBinary(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+	{\
+		readBinaryMembers(JSON_INNER_MEMBER_NAME);\
 	}\
 protected:\
 	friend class Json::Value;\
+	JSON_MEMBER_BASE_DISPATCH(Base)\
 	void generateJson(Json::Value& JSON_INNER_MEMBER_NAME) const\
 	{\
 		Base::generateJson(JSON_INNER_MEMBER_NAME);\
-		mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__); \
+		JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+		mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__); \
+	}\
+	void writeJsonMembers(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+	{\
+		writeJsonBaseMembers(JSON_INNER_MEMBER_NAME);\
+		JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+		mmrUtil::writeJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__); \
+	}\
+	bool readJsonMember(mmrUtil::MemberReadState& JSON_INNER_MEMBER_NAME)\
+	{\
+		JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+		return mmrUtil::readJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE, std::tie(__VA_ARGS__), mmrUtil::member_table_base<Base>::count()) || readJsonBaseMember(JSON_INNER_MEMBER_NAME);\
+	}\
+	void checkJsonMembers(const uint64_t* JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList* JSON_INNER_ERRORS_NAME = nullptr) const\
+	{\
+		checkJsonBaseMembers(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME);\
+		JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+		mmrUtil::checkJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME, mmrUtil::member_table_base<Base>::count(), JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+	}\
+	void writeBinaryMembers(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+	{\
+		writeBinaryBaseMembers(JSON_INNER_MEMBER_NAME);\
+		mmrUtil::writeBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
+	}\
+	void readBinaryMembers(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+	{\
+		readBinaryBaseMembers(JSON_INNER_MEMBER_NAME);\
+		mmrUtil::readBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
 	}
 
 
@@ -481,77 +4313,225 @@ protected:\
 #define ADD_JSON_MEMBER_BASE_DEPL_COMM(Base, ...)\
 public:\
 	virtual ~Base() = default;\
+	static constexpr size_t jsonMemberCount() { return mmrUtil::count_member_names(#__VA_ARGS__); }\
+	static constexpr bool jsonMemberTable() { return true; }\
+	static constexpr uint64_t jsonNameHash() { return Json::key_hash(#__VA_ARGS__, sizeof(#__VA_ARGS__) - 1); }\
+	static constexpr uint64_t jsonSchemaHash() { return mmrUtil::schema_tuple<decltype(std::tie(__VA_ARGS__))>::hash(jsonNameHash()); }\
 	virtual Json::Value generateJson() const\
 	{\
 		Json::Value JSON_INNER_MEMBER_NAME;\
-		mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__);\
-		JSON_INNER_MEMBER_NAME[FINAL_CLASS_TYPE] = #Base;\
+		JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+		mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+		JSON_INNER_MEMBER_NAME[FINAL_CLASS_TYPE] = FINAL_CLASS_TYPE_VALUE(Base);\
 		return JSON_INNER_MEMBER_NAME;\
 	}\
 	virtual void parseJson(const Json::Value& JSON_INNER_MEMBER_NAME)\
 	{\
-		mmrUtil::parseJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__);\
+		mmrUtil::parseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	virtual void parseJson(Json::Value&& JSON_INNER_MEMBER_NAME)\
+	{\
+		mmrUtil::parseJsonObject<jsonMemberCount()>(std::move(JSON_INNER_MEMBER_NAME),\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	virtual void tryParseJson(const Json::Value& JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList& JSON_INNER_ERRORS_NAME)/*mmrUtil::tryParse使用，不抛出异常*/\
+	{\
+		mmrUtil::tryParseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME,\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen, mmrUtil::ErrorList* pErrors) { checkJsonMembers(pSeen, pErrors); });\
+	}\
+	virtual void writeJson(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+	{\
+		JSON_INNER_MEMBER_NAME.beginObject();\
+		JSON_INNER_MEMBER_NAME.writeKey(FINAL_CLASS_TYPE);/*类型字段写在最前，读取时无需扫描*/\
+		JSON_INNER_MEMBER_NAME.writeValue(FINAL_CLASS_TYPE_VALUE(Base));\
+		writeJsonMembers(JSON_INNER_MEMBER_NAME);\
+		JSON_INNER_MEMBER_NAME.endObject();\
+	}\
+	virtual void readJson(Json::Reader& JSON_INNER_MEMBER_NAME)\
+	{\
+		mmrUtil::readJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	virtual uint32_t binaryTypeTag() const/*二进制编码写入的实际类型标签*/\
+	{\
+		return std::integral_constant<uint32_t, mmrUtil::polymorphic_tag(#Base, sizeof(#Base) - 1)>::value;\
+	}\
+	void writeBinary(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+	{\
+		writeBinaryMembers(JSON_INNER_MEMBER_NAME);\
+	}\
+	void readBinary(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+	{\
+		readBinaryMembers(JSON_INNER_MEMBER_NAME);\
 	}\
 	protected:\
 		friend class Json::Value;\
 		virtual void generateJson(Json::Value& JSON_INNER_MEMBER_NAME) const\
 		{\
-			mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__);\
+			JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+			mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+		}\
+		virtual void writeJsonMembers(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+		{\
+			JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+			mmrUtil::writeJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+		}\
+		bool readJsonMember(mmrUtil::MemberReadState& JSON_INNER_MEMBER_NAME)\
+		{\
+			JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+			return mmrUtil::readJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE, std::tie(__VA_ARGS__));\
+		}\
+		void checkJsonMembers(const uint64_t* JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList* JSON_INNER_ERRORS_NAME = nullptr) const\
+		{\
+			JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+			mmrUtil::checkJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME, 0, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+		}\
+		virtual void writeBinaryMembers(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+		{\
+			mmrUtil::writeBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
+		}\
+		virtual void readBinaryMembers(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+		{\
+			mmrUtil::readBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
 		}\
 public:\
 	using BasePtrType = std::unique_ptr<Base>;/*基类指针*/\
-	using TypeGenFunc = std::function<BasePtrType(void)>;\
-	static BasePtrType genClass(const std::string& strType)\
+	using TypeGenFunc = BasePtrType(*)();\
+	static BasePtrType genClass(const std::string_view& strType)\
+	{\
+		TypeGenFunc func = getTypeRegistry().find(strType);\
+		return func ? func() : nullptr;\
+	}\
+	static BasePtrType genClass(uint32_t tag)/*FINAL_CLASS_TYPE_NUMERIC写入的数字标签*/\
 	{\
-		auto iterGenFunc = getAllMapGenFunc().find(strType);\
-		return iterGenFunc != getAllMapGenFunc().end() ? iterGenFunc->second() : nullptr;\
+		TypeGenFunc func = getTypeRegistry().find(tag);\
+		return func ? func() : nullptr;\
 	}\
 	template<typename _T>\
 	struct RegGenFunc\
 	{\
 		RegGenFunc(std::string strType)\
 		{\
-			AddGenFunc(strType, std::bind(&RegGenFunc::genFunc, this));\
+			AddGenFunc(strType, &RegGenFunc::genFunc);\
 		}\
-		BasePtrType genFunc()\
+		static BasePtrType genFunc()\
 		{\
 			return std::make_unique<_T>();\
 		}\
 	};\
 protected:\
-	static void AddGenFunc(const std::string strType, TypeGenFunc&& func)\
+	static void AddGenFunc(const std::string& strType, TypeGenFunc func)\
 	{\
-		getAllMapGenFunc().insert(std::make_pair(strType, std::move(func)));\
+		getTypeRegistry().add(strType, func);\
 	}\
 private:\
-	static std::map<std::string, TypeGenFunc>& getAllMapGenFunc()\
+	static mmrUtil::PolymorphicRegistry<BasePtrType>& getTypeRegistry()\
 	{\
-		static std::map<std::string, TypeGenFunc> mapFunc;\
-		return mapFunc;\
+		static mmrUtil::PolymorphicRegistry<BasePtrType> registry;\
+		return registry;\
 	}\
 
 #define ADD_JSON_MEMBER_DERIVE_DEPL_COMM(Parent,Derive, ...)\
 public:\
 	virtual ~Derive() = default;\
+	static constexpr size_t jsonMemberCount() { return mmrUtil::member_table_base<Parent>::count() + mmrUtil::count_member_names(#__VA_ARGS__); }\
+	static constexpr bool jsonMemberTable() { return mmrUtil::has_member_table<Parent>::value; }\
+	static constexpr uint64_t jsonNameHash() { return mmrUtil::schema_combine(mmrUtil::member_table_base<Parent>::name_hash(), Json::key_hash(#__VA_ARGS__, sizeof(#__VA_ARGS__) - 1)); }\
+	static constexpr uint64_t jsonSchemaHash() { return mmrUtil::schema_tuple<decltype(std::tie(__VA_ARGS__))>::hash(mmrUtil::schema_combine(mmrUtil::member_table_base<Parent>::schema_hash(), jsonNameHash())); }\
 	virtual Json::Value generateJson() const\
 	{\
 		Json::Value JSON_INNER_MEMBER_NAME;\
 		Parent::generateJson(JSON_INNER_MEMBER_NAME);\
-		mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__);\
-		JSON_INNER_MEMBER_NAME[FINAL_CLASS_TYPE] = #Derive;\
+		JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+		mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+		JSON_INNER_MEMBER_NAME[FINAL_CLASS_TYPE] = FINAL_CLASS_TYPE_VALUE(Derive);\
 		return JSON_INNER_MEMBER_NAME;\
 	}\
 	virtual void parseJson(const Json::Value& JSON_INNER_MEMBER_NAME)\
 	{\
-		Parent::parseJson(JSON_INNER_MEMBER_NAME);\
-		mmrUtil::parseJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__);\
+		parseJsonBase(JSON_INNER_MEMBER_NAME);\
+		mmrUtil::parseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME,\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	virtual void parseJson(Json::Value&& JSON_INNER_MEMBER_NAME)\
+	{\
+		parseJsonBase(JSON_INNER_MEMBER_NAME);\
+		mmrUtil::parseJsonObject<jsonMemberCount()>(std::move(JSON_INNER_MEMBER_NAME),\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen) { checkJsonMembers(pSeen); });\
+	}\
+	virtual void tryParseJson(const Json::Value& JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList& JSON_INNER_ERRORS_NAME)/*mmrUtil::tryParse使用，不抛出异常*/\
+	{\
+		tryParseJsonBase(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME);\
+		mmrUtil::tryParseJsonObject<jsonMemberCount()>(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME,\
+			[this](mmrUtil::MemberReadState& state) { return readJsonMember(state); },\
+			[this](const uint64_t* pSeen, mmrUtil::ErrorList* pErrors) { checkJsonMembers(pSeen, pErrors); });\
+	}\
+	virtual void writeJson(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+	{\
+		JSON_INNER_MEMBER_NAME.beginObject();\
+		JSON_INNER_MEMBER_NAME.writeKey(FINAL_CLASS_TYPE);/*类型字段写在最前，读取时无需扫描*/\
+		JSON_INNER_MEMBER_NAME.writeValue(FINAL_CLASS_TYPE_VALUE(Derive));\
+		writeJsonMembers(JSON_INNER_MEMBER_NAME);\
+		JSON_INNER_MEMBER_NAME.endObject();\
+	}\
+	virtual void readJson(Json::Reader& JSON_INNER_MEMBER_NAME)\
+	{\
+		readJsonObjectBase(JSON_INNER_MEMBER_NAME);\
+	}\
+	virtual uint32_t binaryTypeTag() const/*二进制编码写入的实际类型标签*/\
+	{\
+		return std::integral_constant<uint32_t, mmrUtil::polymorphic_tag(#Derive, sizeof(#Derive) - 1)>::value;\
+	}\
+	void writeBinary(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+	{\
+		writeBinaryMembers(JSON_INNER_MEMBER_NAME);\
+	}\
+	void readBinary(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+	{\
+		readBinaryMembers(JSON_INNER_MEMBER_NAME);\
 	}\
 	protected:\
 		friend class Json::Value;\
+		JSON_MEMBER_BASE_DISPATCH(Parent)\
 		virtual void generateJson(Json::Value& JSON_INNER_MEMBER_NAME) const\
 		{\
 			Parent::generateJson(JSON_INNER_MEMBER_NAME);\
-			mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, #__VA_ARGS__, __VA_ARGS__);\
+			JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+			mmrUtil::generatJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+		}\
+		virtual void writeJsonMembers(Json::Writer& JSON_INNER_MEMBER_NAME) const\
+		{\
+			writeJsonBaseMembers(JSON_INNER_MEMBER_NAME);\
+			JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+			mmrUtil::writeJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+		}\
+		bool readJsonMember(mmrUtil::MemberReadState& JSON_INNER_MEMBER_NAME)\
+		{\
+			JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+			return mmrUtil::readJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_NAME_TABLE, std::tie(__VA_ARGS__), mmrUtil::member_table_base<Parent>::count()) || readJsonBaseMember(JSON_INNER_MEMBER_NAME);\
+		}\
+		void checkJsonMembers(const uint64_t* JSON_INNER_MEMBER_NAME, mmrUtil::ErrorList* JSON_INNER_ERRORS_NAME = nullptr) const\
+		{\
+			checkJsonBaseMembers(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME);\
+			JSON_MEMBER_NAME_TABLE(__VA_ARGS__)\
+			mmrUtil::checkJsonVars(JSON_INNER_MEMBER_NAME, JSON_INNER_ERRORS_NAME, mmrUtil::member_table_base<Parent>::count(), JSON_INNER_NAME_TABLE.names, __VA_ARGS__);\
+		}\
+		virtual void writeBinaryMembers(mmrUtil::BinaryWriter& JSON_INNER_MEMBER_NAME) const\
+		{\
+			writeBinaryBaseMembers(JSON_INNER_MEMBER_NAME);\
+			mmrUtil::writeBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
+		}\
+		virtual void readBinaryMembers(mmrUtil::BinaryReader& JSON_INNER_MEMBER_NAME)\
+		{\
+			readBinaryBaseMembers(JSON_INNER_MEMBER_NAME);\
+			mmrUtil::readBinaryVars(JSON_INNER_MEMBER_NAME, __VA_ARGS__);\
 		}
 
 #if __cplusplus >= 201703L // C++17 及以后：使用 inline 静态成员，直接在类内定义并初始化
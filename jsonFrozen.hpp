@@ -0,0 +1,761 @@
+/**
+ * @file jsonFrozen.hpp
+ * @brief 只读Json文档，数据压平保存在64位字序列（tape）和字符串缓冲区中
+ * @author Mounmory (237628106@qq.com) https://github.com/Mounmory
+ * @date
+ *
+ *
+ * 参考simdjson的tape结构：
+ * - 加载后不再修改的配置、查找表等数据，使用FrozenDocument可以减少内存占用并提高缓存命中
+ * - 可以直接从Json文本解析，也可以由已有的Json::Value单向冻结生成
+ * - 通过ValueRef访问数据，接口与Json::Value的只读接口保持一致
+ */
+
+#ifndef MMR_UTIL_JSON_FROZEN_HPP
+#define MMR_UTIL_JSON_FROZEN_HPP
+#include "json.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+/*
+	tape中每个64位字的高8位为类型标记，低56位为负载
+		- 'n' 't' 'f'	null、true、false
+		- 'l' 'u' 'd'	int64、uint64、double，数值保存在下一个字中
+		- '"'			字符串，负载为字符串缓冲区中的偏移，缓冲区中依次保存4字节长度、内容、'\0'
+		- '['			数组开始，低32位为数组结束后下一个字的位置，32~55位为元素个数
+		- '{'			对象开始，负载同数组，后面紧跟一个辅助字，保存有序键索引的位置（偏移+1，0表示没有索引）
+		- ']' '}'		数组、对象结束，负载为开始字的位置
+		- '-'			被后面同名键覆盖的键，负载同字符串，遍历和计数时跳过该成员
+	元素个数超过0xFFFFFF时保存饱和值，需要时遍历计数
+	对象的成员在tape中按“键（字符串）、值”依次排列，对象成员较多时额外生成按键排序的索引，查找为二分查找
+	对象的键保存形式与Json::Value一致（转义后的形式），重复的键以最后一个为准，元素个数不包含被覆盖的成员
+*/
+
+namespace Json
+{
+	//tape数据的只读视图，不持有内存
+	struct TapeView
+	{
+		static constexpr uint64_t PAYLOAD_MASK = 0x00FFFFFFFFFFFFFFull;
+		static constexpr uint64_t COUNT_SATURATED = 0xFFFFFF;
+		static constexpr uint32_t KEY_INDEX_MIN = 8;//对象成员个数达到该值时生成键索引
+		static constexpr char DEAD_KEY = '-';
+
+		const uint64_t* tape = nullptr;
+		size_t tapeLen = 0;
+		const char* strings = nullptr;
+		const uint32_t* index = nullptr;
+
+		static uint64_t makeWord(char tag, uint64_t payload) {
+			return (static_cast<uint64_t>(static_cast<uint8_t>(tag)) << 56) | (payload & PAYLOAD_MASK);
+		}
+
+		char tag(size_t idx) const { return static_cast<char>(tape[idx] >> 56); }
+
+		uint64_t payload(size_t idx) const { return tape[idx] & PAYLOAD_MASK; }
+
+		//跳过idx处的值，返回下一个值的位置
+		size_t next(size_t idx) const {
+			switch (tag(idx)) {
+			case 'l':
+			case 'u':
+			case 'd': return idx + 2;
+			case '[':
+			case '{': return static_cast<uint32_t>(payload(idx));
+			default: return idx + 1;
+			}
+		}
+
+		std::string_view stringAt(size_t idx) const {
+			const char* pData = strings + payload(idx);
+			uint32_t len = 0;
+			memcpy(&len, pData, sizeof(len));
+			return std::string_view(pData + sizeof(len), len);
+		}
+
+		//跳过被覆盖的成员，返回pos及之后第一个有效成员（或对象结束字）的位置
+		size_t live(size_t pos) const {
+			while (tag(pos) == DEAD_KEY)
+				pos = next(pos + 1);
+			return pos;
+		}
+
+		//数组或对象的元素个数
+		size_t count(size_t idx) const {
+			size_t cnt = static_cast<size_t>(payload(idx) >> 32);
+			if (cnt < COUNT_SATURATED)
+				return cnt;
+			cnt = 0;
+			bool isObject = tag(idx) == '{';
+			size_t end = static_cast<uint32_t>(payload(idx)) - 1;
+			for (size_t pos = isObject ? live(idx + 2) : idx + 1; pos < end; ++cnt)
+				pos = isObject ? live(next(pos + 1)) : next(pos);
+			return cnt;
+		}
+
+		//在对象中查找键，返回值的位置，没有找到返回0（位置0不可能是成员的值）
+		size_t findKey(size_t objIdx, const std::string_view& key) const {
+			uint64_t aux = tape[objIdx + 1];
+			if (aux != 0)
+			{
+				const uint32_t* pCount = index + (aux - 1);
+				const uint32_t* pBegin = pCount + 1;
+				const uint32_t* pEnd = pBegin + *pCount;
+				auto iter = std::upper_bound(pBegin, pEnd, key, [this](const std::string_view& k, uint32_t pos) {
+					return k.compare(stringAt(pos)) < 0;
+				});
+				if (iter != pBegin && stringAt(*(iter - 1)) == key)
+					return *(iter - 1) + 1;
+				return 0;
+			}
+			size_t end = static_cast<uint32_t>(payload(objIdx)) - 1;
+			for (size_t pos = live(objIdx + 2); pos < end; pos = live(next(pos + 1)))
+			{
+				if (stringAt(pos) == key)
+					return pos + 1;
+			}
+			return 0;
+		}
+	};
+
+	class ValueRef
+	{
+	public:
+		template <typename _Ref>//Array或Object迭代器
+		class TapeIterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = _Ref;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const _Ref*;
+			using reference = _Ref;
+
+			TapeIterator() = default;
+			TapeIterator(const TapeView* view, size_t idx) : m_pView(view), m_idx(idx) {}
+
+			_Ref operator*() const { return deref(static_cast<_Ref*>(nullptr)); }
+			TapeIterator& operator++() { m_idx = step(static_cast<_Ref*>(nullptr)); return *this; }
+			TapeIterator operator++(int) { TapeIterator ret = *this; ++(*this); return ret; }
+			bool operator==(const TapeIterator& other) const { return m_idx == other.m_idx; }
+			bool operator!=(const TapeIterator& other) const { return m_idx != other.m_idx; }
+
+		private:
+			ValueRef deref(ValueRef*) const { return ValueRef(m_pView, m_idx); }
+			std::pair<std::string_view, ValueRef> deref(std::pair<std::string_view, ValueRef>*) const {
+				return std::make_pair(m_pView->stringAt(m_idx), ValueRef(m_pView, m_idx + 1));
+			}
+			size_t step(ValueRef*) const { return m_pView->next(m_idx); }
+			size_t step(std::pair<std::string_view, ValueRef>*) const { return m_pView->live(m_pView->next(m_idx + 1)); }
+
+			const TapeView* m_pView = nullptr;
+			size_t m_idx = 0;
+		};
+
+		template <typename _Iter>
+		class TapeRange {
+			_Iter m_begin;
+			_Iter m_end;
+		public:
+			TapeRange(_Iter b, _Iter e) : m_begin(b), m_end(e) {}
+			_Iter begin() const { return m_begin; }
+			_Iter end() const { return m_end; }
+		};
+
+		using ArrayIterator = TapeIterator<ValueRef>;
+		using ObjectIterator = TapeIterator<std::pair<std::string_view, ValueRef>>;
+
+		ValueRef() = default;
+		ValueRef(const TapeView* view, size_t idx) : m_pView(view), m_idx(idx) {}
+
+		emJsonType JSONType() const {
+			if (nullptr == m_pView)
+				return emJsonType::Null;
+			switch (m_pView->tag(m_idx)) {
+			case '{': return emJsonType::Object;
+			case '[': return emJsonType::Array;
+			case '"': return emJsonType::String;
+			case 'd': return emJsonType::Floating;
+			case 'l': return emJsonType::Integral;
+			case 'u': return emJsonType::Uintegral;
+			case 't':
+			case 'f': return emJsonType::Boolean;
+			default: return emJsonType::Null;
+			}
+		}
+
+		bool IsNull() const { return JSONType() == emJsonType::Null; }
+
+		int length() const {
+			if (JSONType() == emJsonType::Array)
+				return static_cast<int>(m_pView->count(m_idx));
+			return -1;
+		}
+
+		int size() const {
+			auto type = JSONType();
+			if (type == emJsonType::Object || type == emJsonType::Array)
+				return static_cast<int>(m_pView->count(m_idx));
+			return -1;
+		}
+
+		bool hasKey(const std::string_view& key) const {
+			return JSONType() == emJsonType::Object && m_pView->findKey(m_idx, key) != 0;
+		}
+
+		//键不存在时返回null
+		ValueRef operator[](const std::string_view& key) const {
+			if (JSONType() == emJsonType::Object)
+			{
+				size_t pos = m_pView->findKey(m_idx, key);
+				if (pos != 0)
+					return ValueRef(m_pView, pos);
+			}
+			return ValueRef();
+		}
+
+		//越界时返回null
+		ValueRef operator[](unsigned index) const {
+			if (JSONType() == emJsonType::Array)
+			{
+				size_t end = static_cast<uint32_t>(m_pView->payload(m_idx)) - 1;
+				size_t pos = m_idx + 1;
+				for (unsigned i = 0; i < index && pos < end; ++i)
+					pos = m_pView->next(pos);
+				if (pos < end)
+					return ValueRef(m_pView, pos);
+			}
+			return ValueRef();
+		}
+
+		ValueRef at(const std::string_view& key) const {
+			if (!hasKey(key))
+				throw std::out_of_range("key [" + std::string(key.data(), key.size()) + "] do not exist.");
+			return operator[](key);
+		}
+
+		ValueRef at(unsigned index) const {
+			if (JSONType() != emJsonType::Array || index >= m_pView->count(m_idx))
+				throw std::out_of_range("index " + std::to_string(index) + " out of range.");
+			return operator[](index);
+		}
+
+		template<typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value, T>::type toNum() const { bool ret; return get<T>(ret); }
+
+		template<typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value
+			|| std::is_same<std::decay_t<T>, std::string>::value
+			|| std::is_same<std::decay_t<T>, std::string_view>::value, T>::type get() const
+		{
+			bool bRet = false;
+			auto ret = get<std::decay_t<T>>(bRet);
+			if (false == bRet)
+			{
+				std::stringstream ss;
+				ss << "Json data [" << this->dumpFast() << "] convert to [" << typeid(T).name() << "] error." << std::endl;
+				throw std::runtime_error(ss.str());
+			}
+			return ret;
+		}
+
+		//数字类型的转换规则与Json::Value一致
+		template<typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value, T>::type get(bool& bRet) const {
+			return scalar().template get<T>(bRet);
+		}
+
+		//与Json::Value一致，返回转义后的字符串
+		template<typename T>
+		typename std::enable_if<std::is_same<std::decay_t<T>, std::string>::value, std::string>::type
+			get(bool& bRet) const
+		{
+			bRet = JSONType() == emJsonType::String;
+			if (!bRet)
+				return std::string();
+			std::string_view strView = m_pView->stringAt(m_idx);
+			return Value::json_escape(std::string(strView.data(), strView.size()));
+		}
+
+		//直接返回tape中保存的原始字符串，不做拷贝
+		template<typename T>
+		typename std::enable_if<std::is_same<std::decay_t<T>, std::string_view>::value, std::string_view>::type
+			get(bool& bRet) const
+		{
+			bRet = JSONType() == emJsonType::String;
+			return bRet ? m_pView->stringAt(m_idx) : std::string_view();
+		}
+
+		TapeRange<ObjectIterator> ObjectRange() const {
+			if (JSONType() == emJsonType::Object)
+				return TapeRange<ObjectIterator>(ObjectIterator(m_pView, m_pView->live(m_idx + 2)),
+					ObjectIterator(m_pView, static_cast<uint32_t>(m_pView->payload(m_idx)) - 1));
+			return TapeRange<ObjectIterator>(ObjectIterator(), ObjectIterator());
+		}
+
+		TapeRange<ArrayIterator> ArrayRange() const {
+			if (JSONType() == emJsonType::Array)
+				return TapeRange<ArrayIterator>(ArrayIterator(m_pView, m_idx + 1),
+					ArrayIterator(m_pView, static_cast<uint32_t>(m_pView->payload(m_idx)) - 1));
+			return TapeRange<ArrayIterator>(ArrayIterator(), ArrayIterator());
+		}
+
+		std::string dumpFast() const
+		{
+			std::string strRet;
+			strRet.reserve(256);
+			dumpFast(strRet);
+			return strRet;
+		}
+
+		//输出格式与Json::Value::dumpFast一致
+		template<typename _outType = std::string>
+		void dumpFast(_outType& strR) const {
+			switch (JSONType()) {
+			case emJsonType::Null:
+				strR.append("null");
+				break;
+			case emJsonType::Object: {
+				strR.append("{");
+				bool skip = true;
+				for (const auto& p : ObjectRange()) {
+					if (!skip)
+						strR.append(",");
+					strR.append("\"" + std::string(p.first.data(), p.first.size()) + "\":");
+					p.second.dumpFast(strR);
+					skip = false;
+				}
+				strR.append("}");
+				break;
+			}
+			case emJsonType::Array: {
+				strR.append("[");
+				bool skip = true;
+				for (const auto& p : ArrayRange())
+				{
+					if (!skip) strR.append(",");
+					p.dumpFast(strR);
+					skip = false;
+				}
+				strR.append("]");
+				break;
+			}
+			case emJsonType::String:
+				strR.append("\"" + get<std::string>() + "\"");
+				break;
+			default:
+				scalar().dumpFast(strR);
+				break;
+			}
+		}
+
+	private:
+		//数字、布尔类型转为Json::Value，不涉及内存分配
+		Value scalar() const {
+			if (nullptr == m_pView)
+				return Value();
+			uint64_t data = 0;
+			switch (m_pView->tag(m_idx)) {
+			case 't': return Value(true);
+			case 'f': return Value(false);
+			case 'l': return Value(static_cast<int64_t>(m_pView->tape[m_idx + 1]));
+			case 'u': return Value(static_cast<uint64_t>(m_pView->tape[m_idx + 1]));
+			case 'd': {
+				double dData = 0.0;
+				data = m_pView->tape[m_idx + 1];
+				memcpy(&dData, &data, sizeof(dData));
+				return Value(dData);
+			}
+			default: return Value();
+			}
+		}
+
+		const TapeView* m_pView = nullptr;
+		size_t m_idx = 0;
+	};
+
+	class FrozenDocument
+	{
+		friend class MappedDocument;
+	public:
+		FrozenDocument() = default;
+
+		//由Json::Value单向冻结生成
+		explicit FrozenDocument(const Value& jvData) {
+			freeze_value(jvData);
+			refresh_view();
+		}
+
+		FrozenDocument(const FrozenDocument& other)
+			: m_vecTape(other.m_vecTape)
+			, m_strBuffer(other.m_strBuffer)
+			, m_vecIndex(other.m_vecIndex)
+		{
+			refresh_view();
+		}
+
+		FrozenDocument(FrozenDocument&& other)
+			: m_vecTape(std::move(other.m_vecTape))
+			, m_strBuffer(std::move(other.m_strBuffer))
+			, m_vecIndex(std::move(other.m_vecIndex))
+		{
+			refresh_view();
+			other.clear();
+		}
+
+		FrozenDocument& operator = (const FrozenDocument& other) {
+			if (this != &other)
+			{
+				m_vecTape = other.m_vecTape;
+				m_strBuffer = other.m_strBuffer;
+				m_vecIndex = other.m_vecIndex;
+				refresh_view();
+			}
+			return *this;
+		}
+
+		FrozenDocument& operator = (FrozenDocument&& other) {
+			if (this != &other)
+			{
+				m_vecTape = std::move(other.m_vecTape);
+				m_strBuffer = std::move(other.m_strBuffer);
+				m_vecIndex = std::move(other.m_vecIndex);
+				refresh_view();
+				other.clear();
+			}
+			return *this;
+		}
+
+		void clear() {
+			m_vecTape.clear();
+			m_strBuffer.clear();
+			m_vecIndex.clear();
+			refresh_view();
+		}
+
+		//文档为空时返回null
+		ValueRef root() const {
+			return m_vecTape.empty() ? ValueRef() : ValueRef(&m_view, 0);
+		}
+
+		//tape、字符串缓冲区及键索引占用的字节数
+		size_t memory_usage() const {
+			return m_vecTape.size() * sizeof(uint64_t) + m_strBuffer.size() + m_vecIndex.size() * sizeof(uint32_t);
+		}
+
+		std::string load(const char* data, size_t len)
+		{
+			return load({ data ,len });
+		}
+
+		//直接从Json文本解析到tape，不生成Json::Value，失败时返回错误信息，原有数据不变
+		std::string load(const std::string_view &str) {
+			size_t offset = 0;
+			std::string strErr;
+			FrozenDocument temDoc;
+			try
+			{
+				temDoc.parse_value(str, offset);
+				Value::consume_ws(str, offset);
+				if (offset < str.size())
+					throw std::out_of_range("more than one object.");
+				temDoc.refresh_view();
+				(*this) = std::move(temDoc);
+			}
+			catch (const std::exception& e)
+			{
+				strErr = e.what() + Value::error_position(str, offset);
+			}
+			return strErr;
+		}
+
+		std::string load_from_file(const std::string& strFile) {
+			std::ifstream input(strFile);
+			if (!input.is_open())
+				return "open file " + strFile + " failed!";
+			std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+			return load(contents);
+		}
+
+	private:
+		void refresh_view() {
+			m_view.tape = m_vecTape.data();
+			m_view.tapeLen = m_vecTape.size();
+			m_view.strings = m_strBuffer.data();
+			m_view.index = m_vecIndex.data();
+		}
+
+		void push_word(char tag, uint64_t payload = 0) {
+			m_vecTape.push_back(TapeView::makeWord(tag, payload));
+		}
+
+		void push_string(const char* data, size_t len) {
+			uint32_t len32 = static_cast<uint32_t>(len);
+			push_word('"', m_strBuffer.size());
+			m_strBuffer.append(reinterpret_cast<const char*>(&len32), sizeof(len32));
+			m_strBuffer.append(data, len);
+			m_strBuffer.push_back('\0');
+		}
+
+		void push_scalar(const Value& jvData) {
+			switch (jvData.Type) {
+			case emJsonType::Boolean: push_word(jvData.Internal.Bool ? 't' : 'f'); break;
+			case emJsonType::Integral:
+				push_word('l');
+				m_vecTape.push_back(static_cast<uint64_t>(jvData.Internal.Int));
+				break;
+			case emJsonType::Uintegral:
+				push_word('u');
+				m_vecTape.push_back(jvData.Internal.Uint64);
+				break;
+			case emJsonType::Floating: {
+				uint64_t data = 0;
+				memcpy(&data, &jvData.Internal.Float, sizeof(data));
+				push_word('d');
+				m_vecTape.push_back(data);
+			}break;
+			default: push_word('n'); break;
+			}
+		}
+
+		//开始字写入结束位置和元素个数，并写入结束字
+		void close_container(size_t openIdx, char closeTag, size_t count) {
+			push_word(closeTag, openIdx);
+			uint64_t cnt = count < TapeView::COUNT_SATURATED ? count : TapeView::COUNT_SATURATED;
+			m_vecTape[openIdx] = TapeView::makeWord(static_cast<char>(m_vecTape[openIdx] >> 56),
+				(cnt << 32) | static_cast<uint32_t>(m_vecTape.size()));
+		}
+
+		void kill_key(size_t pos) {
+			m_vecTape[pos] = TapeView::makeWord(TapeView::DEAD_KEY, m_view.payload(pos));
+		}
+
+		//在写入结束字之前调用：重复的键只保留最后一个，成员较多的对象生成按键排序的索引，返回有效成员个数
+		size_t index_keys(size_t openIdx, size_t count) {
+			if (count < 2)
+				return count;
+			refresh_view();
+			size_t end = m_vecTape.size();
+			if (count < TapeView::KEY_INDEX_MIN)
+			{
+				for (size_t pos = openIdx + 2; pos < end; pos = m_view.next(pos + 1))
+				{
+					for (size_t later = m_view.next(pos + 1); later < end; later = m_view.next(later + 1))
+					{
+						if (m_view.stringAt(pos) == m_view.stringAt(later))
+						{
+							kill_key(pos);
+							--count;
+							break;
+						}
+					}
+				}
+				return count;
+			}
+			size_t indexOffset = m_vecIndex.size();
+			m_vecIndex.push_back(0);
+			for (size_t pos = openIdx + 2; pos < end; pos = m_view.next(pos + 1))
+				m_vecIndex.push_back(static_cast<uint32_t>(pos));
+			std::stable_sort(m_vecIndex.begin() + indexOffset + 1, m_vecIndex.end(), [this](uint32_t lhs, uint32_t rhs) {
+				return m_view.stringAt(lhs).compare(m_view.stringAt(rhs)) < 0;
+			});
+			//排序是稳定的，同名的键中最后出现的排在最后
+			auto iterOut = m_vecIndex.begin() + indexOffset + 1;
+			for (auto iter = iterOut; iter != m_vecIndex.end(); ++iter)
+			{
+				if (iter + 1 != m_vecIndex.end() && m_view.stringAt(*iter) == m_view.stringAt(*(iter + 1)))
+					kill_key(*iter);
+				else
+					*iterOut++ = *iter;
+			}
+			m_vecIndex.erase(iterOut, m_vecIndex.end());
+			count = m_vecIndex.size() - indexOffset - 1;
+			m_vecIndex[indexOffset] = static_cast<uint32_t>(count);
+			m_vecTape[openIdx + 1] = indexOffset + 1;
+			return count;
+		}
+
+		void freeze_value(const Value& jvData) {
+			switch (jvData.Type) {
+			case emJsonType::String:
+				push_string(jvData.Internal.String->data(), jvData.Internal.String->size());
+				break;
+			case emJsonType::Array: {
+				size_t openIdx = m_vecTape.size();
+				push_word('[');
+				if (jvData.Storage == emArrayStorage::Int64)
+				{
+					for (auto iter : *jvData.Internal.IntList)
+						push_scalar(Value(iter));
+				}
+				else if (jvData.Storage == emArrayStorage::Double)
+				{
+					for (auto iter : *jvData.Internal.FloatList)
+						push_scalar(Value(iter));
+				}
+				else
+				{
+					for (const auto& iter : *jvData.Internal.List)
+						freeze_value(iter);
+				}
+				close_container(openIdx, ']', jvData.size());
+			}break;
+			case emJsonType::Object: {
+				size_t openIdx = m_vecTape.size();
+				push_word('{');
+				m_vecTape.push_back(0);
+				jvData.for_each_member([this](const std::string& key, const Value& value) {
+					push_string(key.data(), key.size());
+					freeze_value(value);
+				});
+				close_container(openIdx, '}', index_keys(openIdx, jvData.size()));
+			}break;
+			default:
+				push_scalar(jvData);
+				break;
+			}
+		}
+
+		void parse_value(const std::string_view &str, size_t &offset) {
+			Value::consume_ws(str, offset);
+			char value = str[offset];
+			switch (value) {
+			case '[': parse_array(str, offset); return;
+			case '{': parse_object(str, offset); return;
+			case '\"':
+				m_strScratch.clear();
+				Value::parse_string_raw(str, offset, m_strScratch);
+				push_string(m_strScratch.data(), m_strScratch.size());
+				return;
+			case 't':
+			case 'f': push_scalar(Value::parse_bool(str, offset)); return;
+			case 'n': Value::parse_null(str, offset); push_word('n'); return;
+			default: if ((value <= '9' && value >= '0') || value == '-')
+			{
+				push_scalar(Value::parse_number(str, offset));
+				return;
+			}
+			}
+
+			std::stringstream ss;
+			ss << "ERROR: Parse: Unknown starting character '" << value << "'.";
+			throw std::invalid_argument(ss.str());
+		}
+
+		void parse_object(const std::string_view &str, size_t &offset) {
+			size_t openIdx = m_vecTape.size();
+			size_t count = 0;
+			push_word('{');
+			m_vecTape.push_back(0);
+
+			++offset;
+			Value::consume_ws(str, offset);
+			if (str[offset] == '}')
+				++offset;
+			else
+			{
+				while (true)
+				{
+					Value::consume_ws(str, offset);
+					if (str[offset] != '\"')
+					{
+						std::stringstream ss;
+						ss << "ERROR: Object: Expected string key, found '" << str[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+					//键与Json::Value一致保存转义后的形式
+					m_strScratch.clear();
+					Value::parse_string_raw(str, offset, m_strScratch);
+					if (Value::need_escape(m_strScratch))
+						m_strScratch = Value::json_escape(m_strScratch);
+					push_string(m_strScratch.data(), m_strScratch.size());
+
+					Value::consume_ws(str, offset);
+					if (str[offset] != ':')
+					{
+						std::stringstream ss;
+						ss << "Error: Object: Expected ':', found '" << str[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+					Value::consume_ws(str, ++offset);
+					parse_value(str, offset);
+					++count;
+
+					Value::consume_ws(str, offset);
+					if (str[offset] == ',')
+					{
+						++offset;
+						continue;
+					}
+					else if (str[offset] == '}')
+					{
+						++offset;
+						break;
+					}
+					else
+					{
+						std::stringstream ss;
+						ss << "ERROR: Object: Expected ',' or '}', found '" << str[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+				}
+			}
+			close_container(openIdx, '}', index_keys(openIdx, count));
+		}
+
+		void parse_array(const std::string_view &str, size_t &offset) {
+			size_t openIdx = m_vecTape.size();
+			size_t count = 0;
+			push_word('[');
+
+			++offset;
+			Value::consume_ws(str, offset);
+			if (str[offset] == ']')
+				++offset;
+			else
+			{
+				while (true)
+				{
+					parse_value(str, offset);
+					++count;
+					Value::consume_ws(str, offset);
+
+					if (str[offset] == ',')
+					{
+						++offset;
+						continue;
+					}
+					else if (str[offset] == ']')
+					{
+						++offset;
+						break;
+					}
+					else
+					{
+						std::stringstream ss;
+						ss << "ERROR: Array: Expected ',' or ']', found '" << str[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+				}
+			}
+			close_container(openIdx, ']', count);
+		}
+
+	private:
+		std::vector<uint64_t> m_vecTape;
+		std::string m_strBuffer;
+		std::vector<uint32_t> m_vecIndex;
+		std::string m_strScratch;//解析字符串时复用的缓冲区
+		TapeView m_view;
+	};
+
+	//将Json::Value冻结为只读文档
+	inline FrozenDocument freeze(const Value& jvData)
+	{
+		return FrozenDocument(jvData);
+	}
+}
+
+#endif // !MMR_UTIL_JSON_FROZEN_HPP
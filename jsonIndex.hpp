@@ -0,0 +1,614 @@
+/**
+ * @file jsonIndex.hpp
+ * @brief 大Json文件的字节偏移索引，按下标或键直接解析单个元素
+ * @author Mounmory (237628106@qq.com) https://github.com/Mounmory
+ * @date
+ *
+ *
+ * 顶层为很大的数组或对象时，只需要其中某个元素也必须完整解析整个文件。JsonIndex扫描一遍文件：
+ * - 记录顶层数组每个元素（或每隔stride个元素）、顶层对象每个键对应值的起始偏移，可选记录第二层
+ * - 扫描时只匹配括号和字符串，不构建Json::Value；索引可以保存为文件旁边的索引文件，下次直接读取
+ * - IndexedFile以内存映射方式打开Json文件，通过索引定位后用parse_next只解析需要的元素，错误信息中的行列号为整个文件中的位置
+ * - 索引文件按文件大小、修改时间及首尾内容判断是否对应；查找时定位到的位置不是一个值的开始时，说明文件已被修改，重新生成索引
+ */
+
+#ifndef MMR_UTIL_JSON_INDEX_HPP
+#define MMR_UTIL_JSON_INDEX_HPP
+#include "jsonSnapshot.hpp"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+
+/*
+	索引文件格式，整数按本机字节序保存
+		- 文件头：8字节标识"MMRJSIDX"、4字节版本号、4字节标记（第0位顶层为对象，第1位包含第二层）、
+		  4字节stride、4字节保留、源文件大小、源文件首尾各4KB内容的哈希、源文件的修改时间、顶层元素个数（各8字节）
+		- 之后依次为第一层、第二层每一层的各个数组：8字节元素个数加数据
+	键与Json::Value一致保存转义后的形式，每个键前保存4字节长度；按键查找时在同一个对象的键中二分查找
+*/
+
+namespace Json
+{
+	class JsonIndex
+	{
+	public:
+		static constexpr uint64_t npos = ~0ull;
+		static constexpr uint32_t VERSION = 2;
+
+		//每一层的元素，第二层的元素按所属的第一层元素依次排列
+		struct Level
+		{
+			std::vector<uint64_t> offsets;	//值的起始偏移
+			std::vector<uint64_t> keys;		//键在keyBuffer中的位置，数组元素为npos；所属的容器都是数组时为空
+			std::vector<uint32_t> sorted;	//同一个对象中的元素按键排序后的下标（相对于对象的第一个元素）
+			std::string keyBuffer;
+		};
+
+		JsonIndex() = default;
+
+		//扫描Json文本生成索引，bDepth2为true时同时记录第二层；stride大于1时顶层数组每隔stride个元素记录一次，不能与bDepth2同时使用
+		//失败时返回错误信息，原有索引不变
+		std::string build(const std::string_view& json, bool bDepth2 = false, uint32_t stride = 1) {
+			size_t offset = 0;
+			JsonIndex temIndex;
+			try
+			{
+				if (stride == 0 || (stride > 1 && bDepth2))
+					throw std::invalid_argument("JsonIndex: stride must be 1 when depth 2 is indexed.");
+				temIndex.m_stride = stride;
+				temIndex.m_bDepth2 = bDepth2;
+				temIndex.m_sourceSize = json.size();
+				temIndex.m_sourceHash = source_hash(json);
+				Value::consume_ws(json, offset);
+				char c = offset < json.size() ? json[offset] : '\0';
+				if (c != '[' && c != '{')
+					throw std::invalid_argument("JsonIndex: top-level value must be an array or object.");
+				temIndex.m_bObject = c == '{';
+				if (temIndex.m_bObject)
+					temIndex.m_stride = stride = 1;//stride只用于顶层数组
+				//先确认顶层容器是闭合的，扫描时不会越过文本末尾
+				size_t last = json.size() - 1;
+				while (last > offset && (json[last] == ' ' || json[last] == '\t' || json[last] == '\r' || json[last] == '\n'))
+					--last;
+				if (json[last] != (c == '{' ? '}' : ']'))
+				{
+					offset = last;
+					throw std::invalid_argument("JsonIndex: top-level value is not closed.");
+				}
+				temIndex.m_count = temIndex.scan_container(json, offset, temIndex.m_level1, stride, bDepth2 ? &temIndex.m_level2 : nullptr);
+				Value::consume_ws(json, offset);
+				if (offset < json.size())
+					throw std::out_of_range("more than one object.");
+				(*this) = std::move(temIndex);
+			}
+			catch (const std::exception& e)
+			{
+				return e.what() + Value::error_position(json, offset);
+			}
+			return std::string();
+		}
+
+		//索引与Json文本是否对应（比较文件大小及首尾内容的哈希）
+		bool matches(const std::string_view& json) const {
+			return m_sourceSize == json.size() && m_sourceHash == source_hash(json);
+		}
+
+		//源文件的修改时间（MappedFile::modify_time），build不设置，为0
+		uint64_t source_time() const { return m_sourceTime; }
+		void set_source_time(uint64_t sourceTime) { m_sourceTime = sourceTime; }
+
+		bool save_to_file(const std::string& strFile) const {
+			std::ofstream outFile(strFile, std::ios::binary | std::ios::trunc);
+			if (!outFile.is_open())
+				return false;
+			std::string strData;
+			strData.append("MMRJSIDX", 8);
+			append_pod(strData, static_cast<uint32_t>(VERSION));//按值传递，C++14中按引用使用静态常量成员需要类外定义
+			append_pod(strData, static_cast<uint32_t>((m_bObject ? 1u : 0u) | (m_bDepth2 ? 2u : 0u)));
+			append_pod(strData, m_stride);
+			append_pod(strData, static_cast<uint32_t>(0));
+			append_pod(strData, m_sourceSize);
+			append_pod(strData, m_sourceHash);
+			append_pod(strData, m_sourceTime);
+			append_pod(strData, m_count);
+			append_level(strData, m_level1);
+			append_vector(strData, m_vecChildBegin);
+			append_level(strData, m_level2);
+			outFile.write(strData.data(), static_cast<std::streamsize>(strData.size()));
+			return outFile.good();
+		}
+
+		//读取索引文件，失败时返回错误信息，原有索引不变
+		std::string load_from_file(const std::string& strFile) {
+			std::ifstream input(strFile, std::ios::binary | std::ios::ate);
+			if (!input.is_open())
+				return "open file " + strFile + " failed!";
+			std::string strData(static_cast<size_t>(input.tellg()), '\0');
+			input.seekg(0);
+			input.read(&strData[0], static_cast<std::streamsize>(strData.size()));
+			JsonIndex temIndex;
+			size_t pos = 8;
+			try
+			{
+				if (strData.compare(0, 8, "MMRJSIDX", 8) != 0)
+					throw std::invalid_argument("not a json index file.");
+				uint32_t version = 0, flags = 0, reserved = 0;
+				read_pod(strData, pos, version);
+				if (version != VERSION)
+					throw std::invalid_argument("unsupported json index version " + std::to_string(version) + ".");
+				read_pod(strData, pos, flags);
+				read_pod(strData, pos, temIndex.m_stride);
+				read_pod(strData, pos, reserved);
+				read_pod(strData, pos, temIndex.m_sourceSize);
+				read_pod(strData, pos, temIndex.m_sourceHash);
+				read_pod(strData, pos, temIndex.m_sourceTime);
+				read_pod(strData, pos, temIndex.m_count);
+				temIndex.m_bObject = (flags & 1u) != 0;
+				temIndex.m_bDepth2 = (flags & 2u) != 0;
+				read_level(strData, pos, temIndex.m_level1);
+				read_vector(strData, pos, temIndex.m_vecChildBegin);
+				read_level(strData, pos, temIndex.m_level2);
+				temIndex.check();
+			}
+			catch (const std::exception& e)
+			{
+				return e.what() + std::string(" file:") + strFile;
+			}
+			(*this) = std::move(temIndex);
+			return std::string();
+		}
+
+		bool is_object() const { return m_bObject; }
+		bool has_depth2() const { return m_bDepth2; }
+		uint32_t stride() const { return m_stride; }
+
+		//顶层元素个数
+		uint64_t size() const { return m_count; }
+
+		const Level& level1() const { return m_level1; }
+		const Level& level2() const { return m_level2; }
+
+		//第一层第idx个元素在第二层中的范围[first, last)，没有第二层或元素不是容器时为空范围
+		std::pair<uint64_t, uint64_t> children(uint64_t idx) const {
+			if (!m_bDepth2 || idx + 1 >= m_vecChildBegin.size())
+				return std::make_pair(0, 0);
+			return std::make_pair(m_vecChildBegin[idx], m_vecChildBegin[idx + 1]);
+		}
+
+		//在level的[first, last)中按下标或键查找，返回元素在level中的下标，没有找到返回npos
+		uint64_t find(const Level& level, uint64_t first, uint64_t last, const Pointer::Segment& seg) const {
+			if (first >= last)
+				return npos;
+			if (level.keys.empty() || level.keys[first] == npos)//数组
+				return seg.index != Pointer::Segment::npos && seg.index < last - first ? first + seg.index : npos;
+			const uint32_t* pBegin = level.sorted.data() + first;
+			const uint32_t* pEnd = level.sorted.data() + last;
+			auto iter = std::lower_bound(pBegin, pEnd, seg.key, [&](uint32_t idx, const std::string& key) {
+				return key_at(level, first + idx).compare(key) < 0;
+			});
+			//重复的键以最后一个为准，与Json::Value一致
+			uint64_t found = npos;
+			for (; iter != pEnd && key_at(level, first + *iter) == seg.key; ++iter)
+				found = first + *iter;//stable_sort保持了相同键的原顺序
+			return found;
+		}
+
+		std::string_view key_at(const Level& level, uint64_t idx) const {
+			uint64_t pos = level.keys[idx];
+			uint32_t len = 0;
+			memcpy(&len, level.keyBuffer.data() + pos, sizeof(len));
+			return std::string_view(level.keyBuffer.data() + pos + sizeof(len), len);
+		}
+
+	private:
+		//扫描一个容器，记录其元素；pChildren不为空时对每个元素继续记录一层。offset指向容器的起始括号，返回元素个数
+		uint64_t scan_container(const std::string_view& json, size_t& offset, Level& level, uint32_t stride, Level* pChildren) {
+			bool isObject = json[offset] == '{';
+			char close = isObject ? '}' : ']';
+			size_t first = level.offsets.size();
+			uint64_t count = 0;
+			std::string strKey;
+			Value::consume_ws(json, ++offset);
+			if (json[offset] == close)
+				++offset;
+			else
+			{
+				while (true)
+				{
+					uint64_t keyPos = npos;
+					if (isObject)
+					{
+						Value::parse_key(json, offset, strKey);
+						Value::consume_ws(json, offset);
+						if (json[offset] != ':')
+						{
+							std::stringstream ss;
+							ss << "Error: Object: Expected ':', found '" << json[offset] << "'.";
+							throw std::invalid_argument(ss.str());
+						}
+						++offset;
+						keyPos = level.keyBuffer.size();
+						uint32_t len = static_cast<uint32_t>(strKey.size());
+						level.keyBuffer.append(reinterpret_cast<const char*>(&len), sizeof(len));
+						level.keyBuffer.append(strKey);
+					}
+					Value::consume_ws(json, offset);
+					if (count % stride == 0)
+					{
+						level.offsets.push_back(offset);
+						if (isObject || pChildren != nullptr)
+						{
+							level.keys.resize(level.offsets.size() - 1, static_cast<uint64_t>(npos));
+							level.keys.push_back(keyPos);
+						}
+					}
+					++count;
+					char c = json[offset];
+					if (pChildren != nullptr)
+					{
+						m_vecChildBegin.push_back(pChildren->offsets.size());
+						if (c == '{' || c == '[')
+							scan_container(json, offset, *pChildren, 1, nullptr);
+						else
+							Value::skip_fast(json, offset);
+					}
+					else
+						Value::skip_fast(json, offset);
+
+					Value::consume_ws(json, offset);
+					if (json[offset] == ',')
+						++offset;
+					else if (json[offset] == close)
+					{
+						++offset;
+						break;
+					}
+					else
+					{
+						std::stringstream ss;
+						ss << "ERROR: Expected ',' or '" << close << "', found '" << json[offset] << "'.";
+						throw std::invalid_argument(ss.str());
+					}
+				}
+			}
+			if (pChildren != nullptr)
+				m_vecChildBegin.push_back(pChildren->offsets.size());
+			if (!level.keys.empty())
+				level.keys.resize(level.offsets.size(), static_cast<uint64_t>(npos));
+			//对象的元素按键排序，数组保持原顺序
+			size_t last = level.offsets.size();
+			level.sorted.resize(last);
+			for (size_t i = first; i < last; ++i)
+				level.sorted[i] = static_cast<uint32_t>(i - first);
+			if (isObject)
+			{
+				std::stable_sort(level.sorted.begin() + first, level.sorted.end(), [&](uint32_t lhs, uint32_t rhs) {
+					return key_at(level, first + lhs) < key_at(level, first + rhs);
+				});
+			}
+			return count;
+		}
+
+		//文件大小之外，比较首尾各4KB内容的哈希，避免每次打开时读取整个文件
+		static uint64_t source_hash(const std::string_view& json) {
+			const size_t span = 4096;
+			if (json.size() <= span * 2)
+				return key_hash(json.data(), json.size());
+			uint64_t head = key_hash(json.data(), span);
+			uint64_t tail = key_hash(json.data() + json.size() - span, span);
+			return head ^ (tail * 0x100000001b3ull);
+		}
+
+		//读取索引文件后检查各数组的长度及取值范围，防止损坏的索引文件导致越界
+		void check() const {
+			auto checkLevel = [this](const Level& level) {
+				if ((!level.keys.empty() && level.keys.size() != level.offsets.size()) || level.sorted.size() != level.offsets.size())
+					throw std::out_of_range("json index level size mismatch.");
+				for (auto offset : level.offsets)
+				{
+					if (offset >= m_sourceSize)
+						throw std::out_of_range("json index offset out of range.");
+				}
+				for (auto pos : level.keys)
+				{
+					uint32_t len = 0;
+					if (pos == npos)
+						continue;
+					if (pos > level.keyBuffer.size() || level.keyBuffer.size() - pos < sizeof(len))
+						throw std::out_of_range("json index key out of range.");
+					memcpy(&len, level.keyBuffer.data() + pos, sizeof(len));
+					if (len > level.keyBuffer.size() - pos - sizeof(len))
+						throw std::out_of_range("json index key out of range.");
+				}
+			};
+			checkLevel(m_level1);
+			checkLevel(m_level2);
+			if (m_stride == 0 || (m_bObject && m_stride != 1) || m_level1.offsets.size() != (m_count + m_stride - 1) / m_stride)
+				throw std::out_of_range("json index count mismatch.");
+			if (m_bDepth2 && (m_vecChildBegin.size() != m_level1.offsets.size() + 1 || m_vecChildBegin.back() != m_level2.offsets.size()))
+				throw std::out_of_range("json index depth 2 size mismatch.");
+			for (size_t i = 0; i + 1 < m_vecChildBegin.size(); ++i)
+			{
+				if (m_vecChildBegin[i] > m_vecChildBegin[i + 1])
+					throw std::out_of_range("json index depth 2 range invalid.");
+			}
+			auto checkSorted = [](const Level& level, uint64_t first, uint64_t last) {
+				for (uint64_t i = first; i < last; ++i)
+				{
+					if (level.sorted[i] >= last - first)
+						throw std::out_of_range("json index key order invalid.");
+				}
+			};
+			checkSorted(m_level1, 0, m_level1.offsets.size());
+			for (size_t i = 0; i + 1 < m_vecChildBegin.size(); ++i)
+				checkSorted(m_level2, m_vecChildBegin[i], m_vecChildBegin[i + 1]);
+		}
+
+		template<typename T>
+		static void append_pod(std::string& strOut, const T& data) {
+			strOut.append(reinterpret_cast<const char*>(&data), sizeof(data));
+		}
+
+		template<typename T>
+		static void append_vector(std::string& strOut, const std::vector<T>& vecData) {
+			append_pod(strOut, static_cast<uint64_t>(vecData.size()));
+			if (!vecData.empty())
+				strOut.append(reinterpret_cast<const char*>(vecData.data()), vecData.size() * sizeof(T));
+		}
+
+		static void append_level(std::string& strOut, const Level& level) {
+			append_vector(strOut, level.offsets);
+			append_vector(strOut, level.keys);
+			append_vector(strOut, level.sorted);
+			append_pod(strOut, static_cast<uint64_t>(level.keyBuffer.size()));
+			strOut.append(level.keyBuffer);
+		}
+
+		template<typename T>
+		static void read_pod(const std::string& strData, size_t& pos, T& data) {
+			if (strData.size() < pos || strData.size() - pos < sizeof(data))
+				throw std::out_of_range("json index file truncated.");
+			memcpy(&data, strData.data() + pos, sizeof(data));
+			pos += sizeof(data);
+		}
+
+		template<typename T>
+		static void read_vector(const std::string& strData, size_t& pos, std::vector<T>& vecData) {
+			uint64_t size = 0;
+			read_pod(strData, pos, size);
+			if (size > (strData.size() - pos) / sizeof(T))
+				throw std::out_of_range("json index file truncated.");
+			vecData.resize(static_cast<size_t>(size));
+			if (size > 0)
+				memcpy(vecData.data(), strData.data() + pos, static_cast<size_t>(size) * sizeof(T));
+			pos += static_cast<size_t>(size) * sizeof(T);
+		}
+
+		static void read_level(const std::string& strData, size_t& pos, Level& level) {
+			read_vector(strData, pos, level.offsets);
+			read_vector(strData, pos, level.keys);
+			read_vector(strData, pos, level.sorted);
+			uint64_t size = 0;
+			read_pod(strData, pos, size);
+			if (size > strData.size() - pos)
+				throw std::out_of_range("json index file truncated.");
+			level.keyBuffer.assign(strData.data() + pos, static_cast<size_t>(size));
+			pos += static_cast<size_t>(size);
+		}
+
+	private:
+		bool m_bObject = false;
+		bool m_bDepth2 = false;
+		uint32_t m_stride = 1;
+		uint64_t m_sourceSize = 0;
+		uint64_t m_sourceHash = 0;
+		uint64_t m_sourceTime = 0;
+		uint64_t m_count = 0;
+		Level m_level1;
+		std::vector<uint64_t> m_vecChildBegin;	//第一层每个元素在第二层中的起始位置，最后一项为第二层的元素个数
+		Level m_level2;
+	};
+
+	//通过索引随机访问的大Json文件
+	class IndexedFile
+	{
+	public:
+		IndexedFile() = default;
+
+		//映射Json文件并读取strFile + ".idx"；索引文件不存在或与Json文件不对应时重新生成并保存
+		std::string open(const std::string& strFile, bool bDepth2 = false, uint32_t stride = 1) {
+			MappedFile temFile;
+			std::string strErr = temFile.open(strFile);
+			if (!strErr.empty())
+				return strErr;
+			JsonIndex temIndex;
+			std::string strIndexFile = strFile + ".idx";
+			if (!temIndex.load_from_file(strIndexFile).empty() || !temIndex.matches(temFile.view()) || temIndex.source_time() != temFile.modify_time()
+				|| temIndex.has_depth2() != bDepth2 || temIndex.stride() != (temIndex.is_object() ? 1 : stride))
+			{
+				strErr = build_index(temFile, bDepth2, stride, strIndexFile, temIndex);
+				if (!strErr.empty())
+					return strErr;
+			}
+			m_file = std::move(temFile);
+			m_index = std::move(temIndex);
+			m_strIndexFile = strIndexFile;
+			return std::string();
+		}
+
+		//使用已有的索引，索引须与文件对应
+		std::string open(const std::string& strFile, JsonIndex index) {
+			MappedFile temFile;
+			std::string strErr = temFile.open(strFile);
+			if (!strErr.empty())
+				return strErr;
+			if (!index.matches(temFile.view()))
+				return "json index does not match file " + strFile + ".";
+			m_file = std::move(temFile);
+			m_index = std::move(index);
+			m_strIndexFile.clear();
+			return std::string();
+		}
+
+		const JsonIndex& index() const { return m_index; }
+		std::string_view view() const { return m_file.view(); }
+
+		//顶层元素个数
+		uint64_t size() const { return m_index.size(); }
+
+		//查找时索引与文件内容不对应会重新生成索引，所以查找接口不是const的
+		//解析顶层数组的第index个元素
+		std::string at(uint64_t index, Value& jvOut) {
+			Pointer::Segment seg;
+			seg.key = std::to_string(index);
+			seg.index = index < Pointer::Segment::npos ? static_cast<uint32_t>(index) : Pointer::Segment::npos;
+			return get_segments(&seg, 1, jvOut);
+		}
+
+		//解析顶层对象中key对应的值，key与Json::Value::find一致为转义后的形式
+		std::string get(const std::string_view& key, Value& jvOut) {
+			Pointer::Segment seg;
+			seg.key.assign(key.data(), key.size());
+			return get_segments(&seg, 1, jvOut);
+		}
+
+		//按JSON Pointer查找：前一层或两层通过索引定位，解析定位到的值后再查找其余各级；空路径解析整个文件
+		std::string get(const Pointer& ptr, Value& jvOut) {
+			if (ptr.empty())
+				return m_file.is_open() ? parse_at(0, jvOut) : not_open();
+			return get_segments(ptr.segments().data(), ptr.size(), jvOut, &ptr);
+		}
+
+	private:
+		std::string get_segments(const Pointer::Segment* pSegs, size_t count, Value& jvOut, const Pointer* pPtr = nullptr) {
+			if (!m_file.is_open())
+				return not_open();
+			uint64_t offset = 0;
+			size_t used = 1;
+			bool bStale = false;
+			std::string strErr = locate(pSegs, count, pPtr, offset, used, bStale);
+			if (bStale)
+			{
+				//文件修改后大小、修改时间及首尾内容都没有变化时索引文件仍会被使用，重新生成后再定位一次
+				strErr = build_index(m_file, m_index.has_depth2(), m_index.stride(), m_strIndexFile, m_index);
+				if (strErr.empty())
+					strErr = locate(pSegs, count, pPtr, offset, used, bStale);
+			}
+			if (!strErr.empty())
+				return strErr;
+			strErr = parse_at(offset, jvOut);
+			if (!strErr.empty() || used == count)
+				return strErr;
+			Value* pFound = pPtr->resolve_from(&jvOut, used, count);
+			if (pFound == nullptr)
+				return not_found(pSegs, count, pPtr);
+			Value jvFound = std::move(*pFound);
+			jvOut = std::move(jvFound);
+			return std::string();
+		}
+
+		//按索引定位前一层或两层，used为已定位的层数；索引中的偏移处不是一个值的开始时bStale为true
+		std::string locate(const Pointer::Segment* pSegs, size_t count, const Pointer* pPtr, uint64_t& offset, size_t& used, bool& bStale) const {
+			const JsonIndex::Level& level1 = m_index.level1();
+			uint32_t stride = m_index.stride();
+			used = 1;
+			if (stride > 1)
+			{
+				//每隔stride个元素记录一次，从记录的元素开始跳过其余元素
+				if (pSegs[0].index == Pointer::Segment::npos || pSegs[0].index >= m_index.size())
+					return not_found(pSegs, count, pPtr);
+				offset = level1.offsets[pSegs[0].index / stride];
+				bStale = !value_at(offset);
+				return bStale ? std::string() : skip_elements(offset, pSegs[0].index % stride);
+			}
+			uint64_t idx = m_index.find(level1, 0, level1.offsets.size(), pSegs[0]);
+			if (idx == JsonIndex::npos)
+				return not_found(pSegs, count, pPtr);
+			offset = level1.offsets[idx];
+			auto range = m_index.children(idx);
+			if (count > 1 && range.first < range.second)
+			{
+				uint64_t child = m_index.find(m_index.level2(), range.first, range.second, pSegs[1]);
+				if (child == JsonIndex::npos)
+					return not_found(pSegs, count, pPtr);
+				offset = m_index.level2().offsets[child];
+				used = 2;
+			}
+			bStale = !value_at(offset);
+			return std::string();
+		}
+
+		//偏移处是否为一个值的开始
+		bool value_at(uint64_t offset) const {
+			std::string_view json = m_file.view();
+			if (offset >= json.size())
+				return false;
+			char c = json[static_cast<size_t>(offset)];
+			return c == '{' || c == '[' || c == '"' || c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n';
+		}
+
+		//生成索引并记录文件的修改时间，strIndexFile不为空时保存，保存失败时只影响下次打开的速度
+		static std::string build_index(const MappedFile& file, bool bDepth2, uint32_t stride, const std::string& strIndexFile, JsonIndex& index) {
+			std::string strErr = index.build(file.view(), bDepth2, stride);
+			if (!strErr.empty())
+				return strErr;
+			index.set_source_time(file.modify_time());
+			if (!strIndexFile.empty())
+				index.save_to_file(strIndexFile);
+			return std::string();
+		}
+
+		//从offset处解析一个值，错误信息中的行列号为整个文件中的位置
+		std::string parse_at(uint64_t offset, Value& jvOut) const {
+			std::string_view json = m_file.view();
+			size_t pos = static_cast<size_t>(offset);
+			try
+			{
+				jvOut = Value::parse_next(json, pos);
+			}
+			catch (const std::exception& e)
+			{
+				return e.what() + Value::error_position(json, pos);
+			}
+			return std::string();
+		}
+
+		std::string skip_elements(uint64_t& offset, uint64_t count) const {
+			std::string_view json = m_file.view();
+			size_t pos = static_cast<size_t>(offset);
+			try
+			{
+				for (uint64_t i = 0; i < count; ++i)
+				{
+					Value::skip_next(json, pos);
+					Value::consume_ws(json, pos);
+					if (json[pos] != ',')
+						throw std::invalid_argument(std::string("ERROR: Array: Expected ',', found '") + json[pos] + "'.");
+					Value::consume_ws(json, ++pos);
+				}
+			}
+			catch (const std::exception& e)
+			{
+				return e.what() + Value::error_position(json, pos);
+			}
+			offset = pos;
+			return std::string();
+		}
+
+		static std::string not_open() { return "json file is not open."; }
+
+		static std::string not_found(const Pointer::Segment* pSegs, size_t count, const Pointer* pPtr) {
+			if (pPtr != nullptr)
+				return "json pointer " + pPtr->toString() + " not found.";
+			return "json element " + (count > 0 ? pSegs[0].key : std::string()) + " not found.";
+		}
+
+		MappedFile m_file;
+		JsonIndex m_index;
+		std::string m_strIndexFile;	//open(strFile, index)使用已有的索引时为空，重新生成的索引不保存
+	};
+}
+
+#endif // !MMR_UTIL_JSON_INDEX_HPP
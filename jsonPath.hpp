@@ -0,0 +1,570 @@
+/**
+ * @file jsonPath.hpp
+ * @brief 流式JSONPath查询，直接在Json文本上匹配，不构建Json::Value树
+ * @author Mounmory (237628106@qq.com) https://github.com/Mounmory
+ * @date
+ *
+ *
+ * 支持JSONPath的常用子集：
+ * - $ 根节点，.name、['name'] 子节点（可列出多个名称），.*、[*] 通配
+ * - [0]、[0,2] 下标，[start:end:step] 切片；流式处理时不知道数组长度，不支持负数下标
+ * - ..name、..*、..[0] 递归查找
+ * - [?(@.a.b)] 存在判断，[?(@.a op 常量)] 比较，op为== != < <= > >=，常量为数字、字符串、true、false、null
+ * 表达式编译为状态集合（每一步一个状态位），读取文本时每一层只保存当前的状态集合，内存占用与输入大小无关
+ */
+
+#ifndef MMR_UTIL_JSON_PATH_HPP
+#define MMR_UTIL_JSON_PATH_HPP
+#include "json.hpp"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+namespace Json
+{
+	class JsonPath
+	{
+	public:
+		static constexpr size_t STEPS_MAX = 62;//状态集合保存在uint64_t中
+		static constexpr size_t DEPTH_MAX = 1024;
+
+		JsonPath() = default;//"$"，匹配根节点
+
+		//表达式格式错误时抛出std::invalid_argument
+		explicit JsonPath(const std::string_view& expr) {
+			std::string strErr = load(expr);
+			if (!strErr.empty())
+				throw std::invalid_argument(strErr);
+		}
+
+		//编译表达式，失败时返回错误信息且不改变原有表达式
+		std::string load(const std::string_view& expr) {
+			std::vector<Step> vecSteps;
+			size_t pos = 0;
+			try
+			{
+				skip_space(expr, pos);
+				if (pos >= expr.size() || expr[pos] != '$')
+					throw std::invalid_argument("JSONPath must start with '$'.");
+				++pos;
+				while (skip_space(expr, pos), pos < expr.size())
+				{
+					Step step;
+					if (expr[pos] == '.')
+					{
+						if (pos + 1 < expr.size() && expr[pos + 1] == '.')
+						{
+							step.descendant = true;
+							++pos;
+						}
+						if (++pos < expr.size() && expr[pos] == '[' && step.descendant)
+							parse_bracket(expr, pos, step);
+						else if (pos < expr.size() && expr[pos] == '*')
+						{
+							step.kind = emStep::Wildcard;
+							++pos;
+						}
+						else
+						{
+							step.kind = emStep::Name;
+							step.names.push_back(escaped(read_name(expr, pos)));
+						}
+					}
+					else if (expr[pos] == '[')
+						parse_bracket(expr, pos, step);
+					else
+						throw std::invalid_argument(std::string("JSONPath: unexpected character '") + expr[pos] + "'.");
+					vecSteps.push_back(std::move(step));
+					if (vecSteps.size() > STEPS_MAX)
+						throw std::invalid_argument("JSONPath: too many steps.");
+				}
+			}
+			catch (const std::exception& e)
+			{
+				return e.what() + Value::error_position(expr, pos);
+			}
+			m_vecSteps = std::move(vecSteps);
+			return std::string();
+		}
+
+		//按文档顺序对每个匹配的值调用func(std::string_view)，参数为该值在原文中的片段，不复制
+		//输入可以是多个连续的Json值（如每行一个Json的日志），每个值单独匹配；func返回false时停止
+		//失败时返回错误信息，出错前匹配到的值已经回调
+		template<typename _Func>
+		std::string forEach(const std::string_view& json, _Func&& func) const {
+			return run(json, [&](Reader& rd) {
+				size_t start = rd.offset();
+				skip(rd);
+				return invoke(func, json.substr(start, rd.offset() - start), 0);
+			});
+		}
+
+		//对每个匹配的值调用func(Json::Value&&)，只解析匹配的子树
+		template<typename _Func>
+		std::string forEachValue(const std::string_view& json, _Func&& func) const {
+			return run(json, [&](Reader& rd) {
+				return invoke(func, rd.readValue(), 0);
+			});
+		}
+
+		std::string select(const std::string_view& json, std::vector<std::string_view>& vecOut) const {
+			return forEach(json, [&vecOut](const std::string_view& slice) { vecOut.push_back(slice); });
+		}
+
+		std::string select(const std::string_view& json, std::vector<Value>& vecOut) const {
+			return forEachValue(json, [&vecOut](Value&& jvData) { vecOut.push_back(std::move(jvData)); });
+		}
+
+		size_t size() const { return m_vecSteps.size(); }
+
+	private:
+		enum class emStep : uint8_t {
+			Name,
+			Wildcard,
+			Index,
+			Slice,
+			Filter
+		};
+
+		enum class emCompare : uint8_t {
+			Exists,
+			Eq,
+			Ne,
+			Lt,
+			Le,
+			Gt,
+			Ge
+		};
+
+		struct Step
+		{
+			static constexpr uint32_t npos = 0xFFFFFFFF;
+
+			emStep kind = emStep::Wildcard;
+			bool descendant = false;				//..，同时匹配所有后代
+			std::vector<std::string> names;			//转义后的形式，与Reader::readKey一致
+			std::vector<uint32_t> indexes;
+			uint32_t start = 0, end = npos, step = 1;//切片
+			std::vector<std::string> filterPath;	//过滤条件中@之后的各级键
+			emCompare op = emCompare::Exists;
+			Value literal;
+		};
+
+		//func返回bool时以返回值决定是否继续，返回void时一直继续
+		template<typename _Func, typename _Arg>
+		static auto invoke(_Func& func, _Arg&& arg, int) -> decltype(bool(func(std::forward<_Arg>(arg)))) {
+			return func(std::forward<_Arg>(arg));
+		}
+
+		template<typename _Func, typename _Arg>
+		static bool invoke(_Func& func, _Arg&& arg, long) {
+			func(std::forward<_Arg>(arg));
+			return true;
+		}
+
+		template<typename _Emit>
+		std::string run(const std::string_view& json, _Emit&& emit) const {
+			Reader rd(json);
+			std::string strErr;
+			try
+			{
+				bool bStop = false;
+				while (!bStop && rd.peek() != '\0')
+					walk(rd, 1, 0, emit, bStop);
+			}
+			catch (const std::exception& e)
+			{
+				strErr = e.what() + Value::error_position(json, rd.offset());
+			}
+			return strErr;
+		}
+
+		//rd指向一个值，mask为该值所处的状态集合，第i位表示前i步已经匹配
+		template<typename _Emit>
+		void walk(Reader& rd, uint64_t mask, size_t depth, _Emit& emit, bool& bStop) const {
+			const uint64_t matched = 1ull << m_vecSteps.size();
+			char c = rd.peek();
+			if (mask & matched)
+			{
+				mask &= ~matched;
+				if (mask == 0 || (c != '{' && c != '['))
+				{
+					bStop = !emit(rd);
+					return;
+				}
+				//匹配的值中还可能有后代匹配（递归查找），输出后回到起始位置继续
+				size_t start = rd.offset();
+				if (!emit(rd))
+				{
+					bStop = true;
+					return;
+				}
+				rd.seek(start);
+			}
+			if (depth >= DEPTH_MAX)
+				throw std::out_of_range("json nested too deep.");
+			if (c == '{')
+			{
+				if (!rd.beginObject())
+					return;
+				std::string strKey;
+				do
+				{
+					rd.readKey(strKey);
+					rd.peek();
+					uint64_t child = transition(rd, mask, &strKey, 0);
+					if (child == 0)
+						skip(rd);
+					else
+					{
+						walk(rd, child, depth + 1, emit, bStop);
+						if (bStop)
+							return;
+					}
+				} while (rd.nextElement('}'));
+			}
+			else if (c == '[')
+			{
+				if (!rd.beginArray())
+					return;
+				uint32_t index = 0;
+				do
+				{
+					rd.peek();
+					uint64_t child = transition(rd, mask, nullptr, index++);
+					if (child == 0)
+						skip(rd);
+					else
+					{
+						walk(rd, child, depth + 1, emit, bStop);
+						if (bStop)
+							return;
+					}
+				} while (rd.nextElement(']'));
+			}
+			else
+				rd.skipValue();
+		}
+
+		//计算子节点的状态集合，pKey为空时子节点为数组元素
+		uint64_t transition(Reader& rd, uint64_t mask, const std::string* pKey, uint32_t index) const {
+			uint64_t child = 0;
+			for (size_t i = 0; i < m_vecSteps.size(); ++i)
+			{
+				if ((mask & (1ull << i)) == 0)
+					continue;
+				const Step& step = m_vecSteps[i];
+				if (step.descendant)
+					child |= 1ull << i;
+				if (match(step, rd, pKey, index))
+					child |= 1ull << (i + 1);
+			}
+			return child;
+		}
+
+		bool match(const Step& step, Reader& rd, const std::string* pKey, uint32_t index) const {
+			switch (step.kind) {
+			case emStep::Name:
+				return pKey != nullptr && std::find(step.names.begin(), step.names.end(), *pKey) != step.names.end();
+			case emStep::Wildcard:
+				return true;
+			case emStep::Index:
+				return pKey == nullptr && std::find(step.indexes.begin(), step.indexes.end(), index) != step.indexes.end();
+			case emStep::Slice:
+				return pKey == nullptr && index >= step.start && index < step.end && (index - step.start) % step.step == 0;
+			case emStep::Filter:
+				return eval_filter(step, rd);
+			}
+			return false;
+		}
+
+		//在子节点中查找过滤条件的值，比较后回到子节点的起始位置
+		bool eval_filter(const Step& step, Reader& rd) const {
+			size_t start = rd.offset();
+			bool bRet = false;
+			bool bFound = true;
+			std::string strKey;
+			for (const auto& key : step.filterPath)
+			{
+				bFound = false;
+				if (rd.peek() != '{' || !rd.beginObject())
+					break;
+				do
+				{
+					rd.readKey(strKey);
+					if (strKey == key)
+					{
+						bFound = true;
+						break;
+					}
+					skip(rd);
+				} while (rd.nextElement('}'));
+				if (!bFound)
+					break;
+			}
+			if (bFound)
+			{
+				char c = rd.peek();
+				if (step.op == emCompare::Exists)
+					bRet = true;
+				else if (c != '{' && c != '[')
+					bRet = compare(rd.readValue(), step.op, step.literal);
+				else
+					bRet = step.op == emCompare::Ne;
+			}
+			rd.seek(start);
+			return bRet;
+		}
+
+		static bool compare(const Value& lhs, emCompare op, const Value& rhs) {
+			int cmp = 0;
+			bool bOrdered = false;
+			auto isNumber = [](emJsonType type) {
+				return type == emJsonType::Integral || type == emJsonType::Uintegral || type == emJsonType::Floating;
+			};
+			if (isNumber(lhs.JSONType()) && isNumber(rhs.JSONType()))
+			{
+				bool bRet = false;
+				double dLhs = lhs.get<double>(bRet);
+				double dRhs = rhs.get<double>(bRet);
+				cmp = dLhs < dRhs ? -1 : (dLhs > dRhs ? 1 : 0);
+				bOrdered = true;
+			}
+			else if (lhs.JSONType() == emJsonType::String && rhs.JSONType() == emJsonType::String)
+			{
+				cmp = lhs.get<std::string>().compare(rhs.get<std::string>());
+				bOrdered = true;
+			}
+			else if (lhs.JSONType() == rhs.JSONType())
+				cmp = lhs.dumpFast() == rhs.dumpFast() ? 0 : 1;//布尔、null只比较是否相等
+			else
+				cmp = 1;
+			switch (op) {
+			case emCompare::Eq: return cmp == 0;
+			case emCompare::Ne: return cmp != 0;
+			case emCompare::Lt: return bOrdered && cmp < 0;
+			case emCompare::Le: return bOrdered && cmp <= 0;
+			case emCompare::Gt: return bOrdered && cmp > 0;
+			case emCompare::Ge: return bOrdered && cmp >= 0;
+			default: return true;
+			}
+		}
+
+		static void skip(Reader& rd) {
+			size_t offset = rd.offset();
+			Value::skip_fast(rd.str(), offset);
+			rd.seek(offset);
+		}
+
+		static void skip_space(const std::string_view& expr, size_t& pos) {
+			while (pos < expr.size() && isspace(static_cast<unsigned char>(expr[pos])))
+				++pos;
+		}
+
+		static void expect(const std::string_view& expr, size_t& pos, char c) {
+			skip_space(expr, pos);
+			if (pos >= expr.size() || expr[pos] != c)
+				throw std::invalid_argument(std::string("JSONPath: expected '") + c + "'.");
+			++pos;
+		}
+
+		static std::string escaped(const std::string& strRaw) {
+			return Value::need_escape(strRaw) ? Value::json_escape(strRaw) : strRaw;
+		}
+
+		static std::string read_name(const std::string_view& expr, size_t& pos) {
+			size_t start = pos;
+			while (pos < expr.size() && expr[pos] != '.' && expr[pos] != '[' && expr[pos] != ']' && expr[pos] != ')'
+				&& !isspace(static_cast<unsigned char>(expr[pos]))
+				&& (expr[pos] != '=' && expr[pos] != '!' && expr[pos] != '<' && expr[pos] != '>'))
+				++pos;
+			if (pos == start)
+				throw std::invalid_argument("JSONPath: expected name.");
+			return std::string(expr.data() + start, pos - start);
+		}
+
+		static std::string read_quoted(const std::string_view& expr, size_t& pos) {
+			char quote = expr[pos++];
+			std::string strRet;
+			for (; pos < expr.size() && expr[pos] != quote; ++pos)
+			{
+				if (expr[pos] == '\\' && pos + 1 < expr.size())
+					++pos;
+				strRet.push_back(expr[pos]);
+			}
+			if (pos >= expr.size())
+				throw std::invalid_argument("JSONPath: unterminated string.");
+			++pos;
+			return strRet;
+		}
+
+		static bool read_uint(const std::string_view& expr, size_t& pos, uint32_t& value) {
+			skip_space(expr, pos);
+			if (pos < expr.size() && expr[pos] == '-')
+				throw std::invalid_argument("JSONPath: negative index is not supported in streaming query.");
+			size_t start = pos;
+			uint64_t result = 0;
+			while (pos < expr.size() && expr[pos] >= '0' && expr[pos] <= '9')
+			{
+				result = result * 10 + static_cast<uint64_t>(expr[pos++] - '0');
+				if (result >= Step::npos)
+					throw std::invalid_argument("JSONPath: index out of range.");
+			}
+			value = static_cast<uint32_t>(result);
+			return pos > start;
+		}
+
+		//pos指向'['，解析到']'之后
+		static void parse_bracket(const std::string_view& expr, size_t& pos, Step& step) {
+			++pos;
+			skip_space(expr, pos);
+			if (pos >= expr.size())
+				throw std::invalid_argument("JSONPath: expected ']'.");
+			char c = expr[pos];
+			if (c == '*')
+			{
+				step.kind = emStep::Wildcard;
+				++pos;
+			}
+			else if (c == '?')
+			{
+				step.kind = emStep::Filter;
+				++pos;
+				parse_filter(expr, pos, step);
+			}
+			else if (c == '\'' || c == '\"')
+			{
+				step.kind = emStep::Name;
+				while (true)
+				{
+					step.names.push_back(escaped(read_quoted(expr, pos)));
+					skip_space(expr, pos);
+					if (pos >= expr.size() || expr[pos] != ',')
+						break;
+					++pos;
+					skip_space(expr, pos);
+					if (pos >= expr.size() || (expr[pos] != '\'' && expr[pos] != '\"'))
+						throw std::invalid_argument("JSONPath: expected quoted name.");
+				}
+			}
+			else
+			{
+				uint32_t value = 0;
+				bool bHas = read_uint(expr, pos, value);
+				skip_space(expr, pos);
+				if (pos < expr.size() && expr[pos] == ':')
+				{
+					step.kind = emStep::Slice;
+					step.start = bHas ? value : 0;
+					++pos;
+					if (read_uint(expr, pos, value))
+						step.end = value;
+					skip_space(expr, pos);
+					if (pos < expr.size() && expr[pos] == ':')
+					{
+						++pos;
+						if (read_uint(expr, pos, value))
+						{
+							if (value == 0)
+								throw std::invalid_argument("JSONPath: slice step must be positive.");
+							step.step = value;
+						}
+					}
+				}
+				else
+				{
+					if (!bHas)
+						throw std::invalid_argument("JSONPath: expected index.");
+					step.kind = emStep::Index;
+					step.indexes.push_back(value);
+					while (pos < expr.size() && expr[pos] == ',')
+					{
+						++pos;
+						if (!read_uint(expr, pos, value))
+							throw std::invalid_argument("JSONPath: expected index.");
+						step.indexes.push_back(value);
+						skip_space(expr, pos);
+					}
+				}
+			}
+			expect(expr, pos, ']');
+		}
+
+		//数字、true、false、null
+		static Value parse_literal(const std::string& strLiteral) {
+			if (strLiteral == "true" || strLiteral == "false")
+				return Value(strLiteral == "true");
+			if (strLiteral == "null")
+				return Value(nullptr);
+			char* pEnd = nullptr;
+			if (!strLiteral.empty() && strLiteral.find_first_of(".eE") == std::string::npos)
+			{
+				errno = 0;
+				long long lData = strtoll(strLiteral.c_str(), &pEnd, 10);
+				if (*pEnd == '\0' && errno == 0)
+					return Value(static_cast<int64_t>(lData));
+			}
+			double dData = strtod(strLiteral.c_str(), &pEnd);
+			if (strLiteral.empty() || *pEnd != '\0')
+				throw std::invalid_argument("JSONPath: invalid filter literal.");
+			return Value(dData);
+		}
+
+		//?(@.a.b op 常量)，pos指向'?'之后
+		static void parse_filter(const std::string_view& expr, size_t& pos, Step& step) {
+			expect(expr, pos, '(');
+			expect(expr, pos, '@');
+			while (pos < expr.size() && (expr[pos] == '.' || expr[pos] == '['))
+			{
+				if (expr[pos] == '.')
+					step.filterPath.push_back(escaped(read_name(expr, ++pos)));
+				else
+				{
+					++pos;
+					skip_space(expr, pos);
+					if (pos >= expr.size() || (expr[pos] != '\'' && expr[pos] != '\"'))
+						throw std::invalid_argument("JSONPath: filter only supports member names.");
+					step.filterPath.push_back(escaped(read_quoted(expr, pos)));
+					expect(expr, pos, ']');
+				}
+			}
+			skip_space(expr, pos);
+			static const std::pair<const char*, emCompare> ops[] = {
+				{ "==", emCompare::Eq }, { "!=", emCompare::Ne }, { "<=", emCompare::Le },
+				{ ">=", emCompare::Ge }, { "<", emCompare::Lt }, { ">", emCompare::Gt }
+			};
+			for (const auto& iter : ops)
+			{
+				size_t len = strlen(iter.first);
+				if (expr.substr(pos, len) == iter.first)
+				{
+					step.op = iter.second;
+					pos += len;
+					break;
+				}
+			}
+			if (step.op != emCompare::Exists)
+			{
+				skip_space(expr, pos);
+				if (pos < expr.size() && (expr[pos] == '\'' || expr[pos] == '\"'))
+					step.literal = Value(read_quoted(expr, pos));
+				else
+				{
+					size_t start = pos;
+					while (pos < expr.size() && expr[pos] != ')' && !isspace(static_cast<unsigned char>(expr[pos])))
+						++pos;
+					step.literal = parse_literal(std::string(expr.data() + start, pos - start));
+				}
+			}
+			expect(expr, pos, ')');
+		}
+
+	private:
+		std::vector<Step> m_vecSteps;
+	};
+}
+
+#endif // !MMR_UTIL_JSON_PATH_HPP
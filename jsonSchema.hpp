@@ -0,0 +1,877 @@
+/**
+ * @file jsonSchema.hpp
+ * @brief JSON Schema校验，模式预先编译为校验程序
+ * @author Mounmory (237628106@qq.com) https://github.com/Mounmory
+ * @date
+ *
+ *
+ * 支持JSON Schema draft 2020-12中的常用关键字：type、properties、required、additionalProperties、items、
+ * enum、const、minimum、maximum、exclusiveMinimum、exclusiveMaximum、minLength、maxLength、pattern、
+ * minItems、maxItems、minProperties、maxProperties，以及true/false模式。
+ * - 加载模式时编译为按下标引用的节点数组：属性按键的哈希排序，正则表达式预先编译，校验时不再按字符串查找关键字
+ * - 可以校验Json::Value，也可以在Json::Reader读取文本的同一遍中校验，不构建Json::Value
+ * - 校验失败不抛出异常，错误记录出错位置的JSON Pointer、关键字和说明
+ * - 对象有重复的键时，属性个数与Json::Value一致只计一次；校验文本时每个重复的值都会校验，Json::Value中只保留并校验最后一个
+ */
+
+#ifndef MMR_UTIL_JSON_SCHEMA_HPP
+#define MMR_UTIL_JSON_SCHEMA_HPP
+#include "json.hpp"
+
+#include <string>
+#include <vector>
+#include <regex>
+#include <deque>
+#include <algorithm>
+#include <cmath>
+
+namespace Json
+{
+	class Schema
+	{
+	public:
+		struct Error
+		{
+			std::string path;		//出错位置的JSON Pointer，根节点为空
+			std::string keyword;	//未通过的关键字
+			std::string message;
+		};
+
+		Schema() { m_vecNodes.emplace_back(); }//接受任何值
+
+		//模式有错误或使用了不支持的关键字时抛出std::invalid_argument
+		explicit Schema(const Value& jvSchema) {
+			std::string strErr = load(jvSchema);
+			if (!strErr.empty())
+				throw std::invalid_argument(strErr);
+		}
+
+		//编译模式，失败时返回错误信息，原有的校验程序不变
+		std::string load(const Value& jvSchema) {
+			Schema temSchema;
+			temSchema.m_vecNodes.clear();
+			try
+			{
+				std::string strPath;
+				temSchema.compile(jvSchema, strPath);
+			}
+			catch (const std::exception& e)
+			{
+				return e.what();
+			}
+			(*this) = std::move(temSchema);
+			return std::string();
+		}
+
+		//校验通过返回true，遇到第一个错误即返回
+		bool validate(const Value& jv) const {
+			Context ctx;
+			return check(0, jv, ctx);
+		}
+
+		//校验通过返回true，vecErrors中记录全部错误
+		bool validate(const Value& jv, std::vector<Error>& vecErrors) const {
+			vecErrors.clear();
+			Context ctx;
+			ctx.pErrors = &vecErrors;
+			return check(0, jv, ctx);
+		}
+
+		//从reader的当前位置读取并校验一个值，与读取其它内容在同一遍中完成；
+		//vecErrors中追加校验错误，文本格式错误与Reader一致抛出异常
+		bool validate(Reader& reader, std::vector<Error>& vecErrors) const {
+			Context ctx;
+			ctx.pErrors = &vecErrors;
+			size_t count = vecErrors.size();
+			check_stream(0, reader, ctx);
+			return vecErrors.size() == count;
+		}
+
+		//直接校验Json文本，不构建Json::Value；返回文本的格式错误（包含行列号），校验错误记录在vecErrors中
+		std::string validateText(const std::string_view& json, std::vector<Error>& vecErrors) const {
+			vecErrors.clear();
+			Reader reader(json);
+			try
+			{
+				validate(reader, vecErrors);
+				reader.finish();
+			}
+			catch (const std::exception& e)
+			{
+				return e.what() + Value::error_position(json, reader.offset());
+			}
+			return std::string();
+		}
+
+		//编译后的节点个数
+		size_t size() const { return m_vecNodes.size(); }
+
+	private:
+		static constexpr uint32_t npos = 0xFFFFFFFF;
+		static constexpr uint64_t unlimited = ~0ull;
+
+		enum emTypeMask : uint8_t {
+			TYPE_NULL = 1,
+			TYPE_BOOLEAN = 2,
+			TYPE_OBJECT = 4,
+			TYPE_ARRAY = 8,
+			TYPE_NUMBER = 16,
+			TYPE_INTEGER = 32,
+			TYPE_STRING = 64,
+			TYPE_ALL = 127
+		};
+
+		struct Bound
+		{
+			bool set = false;
+			bool exclusive = false;
+			bool isInt = false;	//整数边界按整数比较，避免大整数转换为double的误差
+			int64_t i = 0;
+			double d = 0;
+		};
+
+		struct Property
+		{
+			std::string key;	//与Json::Value中保存的键形式一致（转义后的形式）
+			uint64_t hash = 0;
+			uint32_t node = npos;//properties中的模式，只在required中出现时为npos
+			bool required = false;
+		};
+
+		struct Node
+		{
+			bool reject = false;	//false模式
+			bool trivial = true;	//没有任何约束，读取文本时直接跳过
+			uint8_t types = TYPE_ALL;
+			Bound minimum;
+			Bound maximum;
+			uint64_t minLength = 0, maxLength = unlimited;
+			uint64_t minItems = 0, maxItems = unlimited;
+			uint64_t minProperties = 0, maxProperties = unlimited;
+			uint32_t pattern = npos;	//m_vecRegex中的下标
+			uint32_t items = npos;
+			uint32_t additional = npos;
+			bool noAdditional = false;	//additionalProperties为false
+			bool hasEnum = false;
+			uint32_t enumFirst = 0, enumCount = 0;	//m_vecEnums中的范围
+			std::vector<Property> properties;		//按哈希、键排序
+			uint32_t requiredCount = 0;
+			uint64_t requiredMask = 0;				//属性不超过64个时必需属性的位图
+		};
+
+		//校验过程中的路径，出错时才拼接为字符串
+		struct PathItem
+		{
+			std::string_view key;
+			size_t index = 0;
+		};
+
+		struct Context
+		{
+			std::vector<Error>* pErrors = nullptr;//为空时遇到第一个错误即返回
+			std::vector<PathItem> path;
+			std::deque<std::string> keys;//读取文本时每层对象的键缓冲区，扩大时已有的键不移动
+			std::string str;
+		};
+
+		//编译一个模式节点，返回节点下标
+		uint32_t compile(const Value& jv, std::string& strPath) {
+			uint32_t idx = static_cast<uint32_t>(m_vecNodes.size());
+			m_vecNodes.emplace_back();
+			if (jv.JSONType() == emJsonType::Boolean)
+			{
+				m_vecNodes[idx].reject = !jv.get<bool>();
+				m_vecNodes[idx].trivial = !m_vecNodes[idx].reject;
+				return idx;
+			}
+			if (jv.JSONType() != emJsonType::Object)
+				schema_error(strPath, "schema must be an object or boolean.");
+
+			//先处理子模式，节点数组扩容后再取当前节点
+			std::vector<Property> vecProps;
+			uint32_t items = npos, additional = npos;
+			bool noAdditional = false;
+			jv.for_each_member([&](const std::string& key, const Value& jvItem) {
+				if (key == "properties")
+				{
+					if (jvItem.JSONType() != emJsonType::Object)
+						schema_error(strPath, "properties must be an object.");
+					jvItem.for_each_member([&](const std::string& name, const Value& jvProp) {
+						size_t len = strPath.size();
+						strPath += "/properties/" + escape_token(name);
+						Property prop;
+						prop.key = name;
+						prop.hash = key_hash(name.data(), name.size());
+						prop.node = compile(jvProp, strPath);
+						vecProps.push_back(std::move(prop));
+						strPath.resize(len);
+					});
+				}
+				else if (key == "items" || key == "additionalProperties")
+				{
+					size_t len = strPath.size();
+					strPath += "/" + key;
+					uint32_t child = compile(jvItem, strPath);
+					strPath.resize(len);
+					if (key == "items")
+						items = child;
+					else if (jvItem.JSONType() == emJsonType::Boolean)
+						noAdditional = !jvItem.get<bool>();
+					else
+						additional = child;
+				}
+			});
+
+			Node& node = m_vecNodes[idx];
+			node.items = items;
+			node.additional = additional;
+			node.noAdditional = noAdditional;
+			node.properties = std::move(vecProps);
+			jv.for_each_member([&](const std::string& key, const Value& jvItem) {
+				compile_keyword(node, key, jvItem, strPath);
+			});
+			std::sort(node.properties.begin(), node.properties.end(), [](const Property& lhs, const Property& rhs) {
+				return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : lhs.key < rhs.key;
+			});
+			for (size_t i = 0; i < node.properties.size(); ++i)
+			{
+				if (node.properties[i].required && i < 64)
+					node.requiredMask |= 1ull << i;
+			}
+			node.trivial = node.types == TYPE_ALL && !node.minimum.set && !node.maximum.set
+				&& node.minLength == 0 && node.maxLength == unlimited && node.pattern == npos
+				&& node.minItems == 0 && node.maxItems == unlimited && node.items == npos
+				&& node.minProperties == 0 && node.maxProperties == unlimited && node.properties.empty()
+				&& node.additional == npos && !node.noAdditional && !node.hasEnum;
+			return idx;
+		}
+
+		void compile_keyword(Node& node, const std::string& key, const Value& jv, const std::string& strPath) {
+			if (key == "type")
+			{
+				node.types = 0;
+				if (jv.JSONType() == emJsonType::Array)
+				{
+					for (const auto& jvType : jv.ArrayRange())
+						node.types |= type_from_name(jvType, strPath);
+				}
+				else
+					node.types = type_from_name(jv, strPath);
+			}
+			else if (key == "required")
+			{
+				if (jv.JSONType() != emJsonType::Array)
+					schema_error(strPath, "required must be an array.");
+				for (const auto& jvName : jv.ArrayRange())
+				{
+					if (jvName.JSONType() != emJsonType::String)
+						schema_error(strPath, "required must be an array of strings.");
+					std::string name = jvName.get<std::string>();
+					uint64_t hash = key_hash(name.data(), name.size());
+					auto iter = std::find_if(node.properties.begin(), node.properties.end(), [&](const Property& prop) {
+						return prop.hash == hash && prop.key == name;
+					});
+					if (iter == node.properties.end())
+					{
+						Property prop;
+						prop.key = std::move(name);
+						prop.hash = hash;
+						node.properties.push_back(std::move(prop));
+						iter = node.properties.end() - 1;
+					}
+					if (!iter->required)
+						++node.requiredCount;
+					iter->required = true;
+				}
+			}
+			else if (key == "enum" || key == "const")
+			{
+				if (key == "enum" && (jv.JSONType() != emJsonType::Array || jv.size() == 0))
+					schema_error(strPath, "enum must be a non-empty array.");
+				node.hasEnum = true;
+				node.enumFirst = static_cast<uint32_t>(m_vecEnums.size());
+				if (key == "enum")
+				{
+					Value temp;
+					for (int i = 0; i < jv.size(); ++i)
+						m_vecEnums.push_back(item_at(jv, i, temp));
+				}
+				else
+					m_vecEnums.push_back(jv);
+				node.enumCount = static_cast<uint32_t>(m_vecEnums.size()) - node.enumFirst;
+			}
+			else if (key == "minimum" || key == "exclusiveMinimum")
+				tighten(node.minimum, make_bound(jv, key == "exclusiveMinimum", strPath, key), true);
+			else if (key == "maximum" || key == "exclusiveMaximum")
+				tighten(node.maximum, make_bound(jv, key == "exclusiveMaximum", strPath, key), false);
+			else if (key == "minLength")
+				node.minLength = make_count(jv, strPath, key);
+			else if (key == "maxLength")
+				node.maxLength = make_count(jv, strPath, key);
+			else if (key == "minItems")
+				node.minItems = make_count(jv, strPath, key);
+			else if (key == "maxItems")
+				node.maxItems = make_count(jv, strPath, key);
+			else if (key == "minProperties")
+				node.minProperties = make_count(jv, strPath, key);
+			else if (key == "maxProperties")
+				node.maxProperties = make_count(jv, strPath, key);
+			else if (key == "pattern")
+			{
+				if (jv.JSONType() != emJsonType::String)
+					schema_error(strPath, "pattern must be a string.");
+				try
+				{
+					m_vecRegex.emplace_back(jv.str_view().data(), jv.str_view().size(), std::regex::ECMAScript | std::regex::optimize);
+				}
+				catch (const std::regex_error& e)
+				{
+					schema_error(strPath, std::string("invalid pattern: ") + e.what());
+				}
+				node.pattern = static_cast<uint32_t>(m_vecRegex.size() - 1);
+			}
+			else if (is_unsupported(key))
+				schema_error(strPath, "unsupported keyword \"" + key + "\".");
+			//其它关键字（$schema、title、description、format等）为注释，忽略
+		}
+
+		//同一个对象中同时有minimum和exclusiveMinimum时使用较严格的一个
+		static void tighten(Bound& bound, const Bound& other, bool bLower) {
+			int cmp = compare_double(other.d, bound.d);
+			if (!bound.set || (bLower ? cmp > 0 : cmp < 0) || (cmp == 0 && other.exclusive))
+				bound = other;
+		}
+
+		static Bound make_bound(const Value& jv, bool exclusive, const std::string& strPath, const std::string& key) {
+			Bound bound;
+			bound.set = true;
+			bound.exclusive = exclusive;
+			switch (jv.JSONType()) {
+			case emJsonType::Integral: bound.isInt = true; bound.i = jv.Internal.Int; bound.d = static_cast<double>(bound.i); break;
+			case emJsonType::Uintegral: bound.d = static_cast<double>(jv.Internal.Uint64); break;
+			case emJsonType::Floating: bound.d = jv.Internal.Float; break;
+			default: schema_error(strPath, key + " must be a number.");
+			}
+			return bound;
+		}
+
+		static uint64_t make_count(const Value& jv, const std::string& strPath, const std::string& key) {
+			if (jv.JSONType() == emJsonType::Integral && jv.Internal.Int >= 0)
+				return static_cast<uint64_t>(jv.Internal.Int);
+			if (jv.JSONType() == emJsonType::Uintegral)
+				return jv.Internal.Uint64;
+			if (jv.JSONType() == emJsonType::Floating && jv.Internal.Float >= 0 && std::floor(jv.Internal.Float) == jv.Internal.Float)
+				return static_cast<uint64_t>(jv.Internal.Float);
+			schema_error(strPath, key + " must be a non-negative integer.");
+			return 0;
+		}
+
+		static uint8_t type_from_name(const Value& jv, const std::string& strPath) {
+			std::string_view name = jv.str_view();
+			if (jv.JSONType() == emJsonType::String)
+			{
+				if (name == "null") return TYPE_NULL;
+				if (name == "boolean") return TYPE_BOOLEAN;
+				if (name == "object") return TYPE_OBJECT;
+				if (name == "array") return TYPE_ARRAY;
+				if (name == "number") return TYPE_NUMBER;
+				if (name == "integer") return TYPE_INTEGER;
+				if (name == "string") return TYPE_STRING;
+			}
+			schema_error(strPath, "invalid type \"" + jv.dumpFast() + "\".");
+			return 0;
+		}
+
+		//会改变校验结果、但尚未支持的关键字，编译时报错，避免误判为通过
+		static bool is_unsupported(const std::string& key) {
+			static const char* const arrKeys[] = {
+				"$ref", "$dynamicRef", "allOf", "anyOf", "oneOf", "not", "if", "then", "else",
+				"dependentSchemas", "dependentRequired", "prefixItems", "contains", "minContains", "maxContains",
+				"patternProperties", "propertyNames", "unevaluatedItems", "unevaluatedProperties", "uniqueItems", "multipleOf"
+			};
+			for (auto pKey : arrKeys)
+			{
+				if (key == pKey)
+					return true;
+			}
+			return false;
+		}
+
+		[[noreturn]] static void schema_error(const std::string& strPath, const std::string& strMsg) {
+			throw std::invalid_argument("Schema: " + strMsg + " path:" + (strPath.empty() ? "/" : strPath));
+		}
+
+		//键保存为转义后的形式，先还原，再按RFC 6901只转义'~'和'/'
+		static std::string escape_token(const std::string_view& key) {
+			std::string strRaw(key.data(), key.size());
+			if (strRaw.find('\\') != std::string::npos)
+			{
+				std::string strQuoted = "\"" + strRaw + "\"";
+				size_t offset = 0;
+				strRaw.clear();
+				Value::parse_string_raw(strQuoted, offset, strRaw);
+			}
+			std::string strOut;
+			for (char c : strRaw)
+			{
+				if (c == '~')
+					strOut += "~0";
+				else if (c == '/')
+					strOut += "~1";
+				else
+					strOut += c;
+			}
+			return strOut;
+		}
+
+		const Property* find_property(const Node& node, const std::string_view& key, uint64_t hash) const {
+			auto iter = std::lower_bound(node.properties.begin(), node.properties.end(), hash, [](const Property& prop, uint64_t h) {
+				return prop.hash < h;
+			});
+			for (; iter != node.properties.end() && iter->hash == hash; ++iter)
+			{
+				if (iter->key == key)
+					return &*iter;
+			}
+			return nullptr;
+		}
+
+		/*----------------------------------校验Json::Value----------------------------------*/
+		bool check(uint32_t idx, const Value& jv, Context& ctx) const {
+			const Node& node = m_vecNodes[idx];
+			if (node.trivial)
+				return true;
+			if (node.reject)
+				return fail(ctx, "false", "no value is allowed here.");
+			bool bOk = check_type(node, type_mask(jv), ctx);
+			if (!bOk && !ctx.pErrors)
+				return false;
+			switch (jv.Type) {
+			case emJsonType::String: bOk &= check_string(node, jv.str_view(), ctx); break;
+			case emJsonType::Integral:
+			case emJsonType::Uintegral:
+			case emJsonType::Floating: bOk &= check_number(node, jv, ctx); break;
+			case emJsonType::Array: bOk &= check_array(node, jv, ctx); break;
+			case emJsonType::Object: bOk &= check_object(node, jv, ctx); break;
+			default: break;
+			}
+			if (node.hasEnum && (bOk || ctx.pErrors))
+				bOk &= check_enum(node, jv, ctx);
+			return bOk;
+		}
+
+		bool check_array(const Node& node, const Value& jv, Context& ctx) const {
+			size_t count = static_cast<size_t>(jv.size());
+			bool bOk = check_count(count, node.minItems, node.maxItems, "minItems", "maxItems", "items", ctx);
+			if (node.items == npos || (!bOk && !ctx.pErrors))
+				return bOk;
+			Value temp;
+			ctx.path.emplace_back();
+			for (size_t i = 0; i < count; ++i)
+			{
+				ctx.path.back().index = i;
+				if (!check(node.items, item_at(jv, i, temp), ctx))
+				{
+					bOk = false;
+					if (!ctx.pErrors)
+						break;
+				}
+			}
+			ctx.path.pop_back();
+			return bOk;
+		}
+
+		bool check_object(const Node& node, const Value& jv, Context& ctx) const {
+			bool bOk = check_count(static_cast<size_t>(jv.size()), node.minProperties, node.maxProperties, "minProperties", "maxProperties", "properties", ctx);
+			if (!bOk && !ctx.pErrors)
+				return false;
+			uint32_t requiredSeen = 0;
+			auto checkMember = [&](const std::string& key, uint64_t hash, const Value& jvMember) {
+				if (!bOk && !ctx.pErrors)
+					return;
+				const Property* pProp = node.properties.empty() ? nullptr : find_property(node, key, hash);
+				uint32_t child = npos;
+				if (pProp != nullptr)
+				{
+					requiredSeen += pProp->required ? 1 : 0;
+					child = pProp->node;
+				}
+				else if (node.noAdditional)
+				{
+					ctx.path.push_back(PathItem{ key });
+					bOk &= fail(ctx, "additionalProperties", "additional property is not allowed.");
+					ctx.path.pop_back();
+					return;
+				}
+				else
+					child = node.additional;
+				if (child != npos)
+				{
+					ctx.path.push_back(PathItem{ key });
+					bOk &= check(child, jvMember, ctx);
+					ctx.path.pop_back();
+				}
+			};
+			if (jv.ObjStorage == emObjectStorage::Shaped)
+			{
+				const ObjectShape& shape = *jv.Internal.Record->Shape;
+				for (size_t slot = 0; slot < shape.size(); ++slot)
+					checkMember(shape.key(slot).str(), shape.key(slot).hash(), jv.Internal.Record->Slots[slot]);
+			}
+			else
+			{
+				for (const auto& iter : *jv.Internal.Map)
+					checkMember(iter.first, key_hash(iter.first.data(), iter.first.size()), iter.second);
+			}
+			if (requiredSeen < node.requiredCount && (bOk || ctx.pErrors))
+			{
+				for (const auto& prop : node.properties)
+				{
+					if (prop.required && jv.find(prop.key, prop.hash) == nullptr)
+					{
+						bOk = fail(ctx, "required", "missing required property \"" + prop.key + "\".");
+						if (!ctx.pErrors)
+							break;
+					}
+				}
+			}
+			return bOk;
+		}
+
+		bool check_enum(const Node& node, const Value& jv, Context& ctx) const {
+			for (uint32_t i = 0; i < node.enumCount; ++i)
+			{
+				if (equal(jv, m_vecEnums[node.enumFirst + i]))
+					return true;
+			}
+			return fail(ctx, node.enumCount == 1 ? "const" : "enum", "value " + jv.dumpFast() + " is not one of the allowed values.");
+		}
+
+		/*----------------------------------校验Json文本----------------------------------*/
+		bool check_stream(uint32_t idx, Reader& reader, Context& ctx) const {
+			const Node& node = m_vecNodes[idx];
+			if (node.trivial)
+			{
+				reader.skipValue();
+				return true;
+			}
+			if (node.reject)
+			{
+				reader.skipValue();
+				return fail(ctx, "false", "no value is allowed here.");
+			}
+			if (node.hasEnum)//与枚举值比较需要完整的值
+				return check(idx, reader.readValue(), ctx);
+			char c = reader.peek();
+			switch (c) {
+			case '{': return check_type(node, TYPE_OBJECT, ctx) ? check_object_stream(node, reader, ctx) : skip(reader);
+			case '[': return check_type(node, TYPE_ARRAY, ctx) ? check_array_stream(node, reader, ctx) : skip(reader);
+			case '\"':
+				if (!check_type(node, TYPE_STRING, ctx))
+					return skip(reader);
+				if (node.minLength == 0 && node.maxLength == unlimited && node.pattern == npos)
+				{
+					reader.skipValue();
+					return true;
+				}
+				reader.readStringRaw(ctx.str);
+				return check_string(node, ctx.str, ctx);
+			case 't':
+			case 'f': return check_type(node, TYPE_BOOLEAN, ctx) ? (reader.skipValue(), true) : skip(reader);
+			case 'n': return check_type(node, TYPE_NULL, ctx) ? (reader.skipValue(), true) : skip(reader);
+			default: {
+				Value jvNum = reader.readValue();
+				bool bOk = check_type(node, type_mask(jvNum), ctx);
+				return check_number(node, jvNum, ctx) && bOk;
+			}
+			}
+		}
+
+		bool check_array_stream(const Node& node, Reader& reader, Context& ctx) const {
+			bool bOk = true;
+			size_t count = 0;
+			if (reader.beginArray())
+			{
+				ctx.path.emplace_back();
+				do
+				{
+					if (node.items != npos)
+					{
+						ctx.path.back().index = count;
+						bOk &= check_stream(node.items, reader, ctx);
+					}
+					else
+						reader.skipValue();
+					++count;
+				} while (reader.nextElement(']'));
+				ctx.path.pop_back();
+			}
+			return check_count(count, node.minItems, node.maxItems, "minItems", "maxItems", "items", ctx) && bOk;
+		}
+
+		bool check_object_stream(const Node& node, Reader& reader, Context& ctx) const {
+			bool bOk = true;
+			size_t count = 0;
+			uint64_t seenMask = 0;
+			std::vector<bool> vecSeen;//属性超过64个时使用
+			if (node.properties.size() > 64)
+				vecSeen.resize(node.properties.size());
+			//限制了属性个数时记录各个键，重复的键只计一次，与Json::Value中保留最后一个值一致
+			const bool bCountKeys = node.minProperties > 0 || node.maxProperties != unlimited;
+			std::vector<std::string> vecKeys;
+			if (reader.beginObject())
+			{
+				size_t depth = ctx.path.size();
+				if (ctx.keys.size() <= depth)
+					ctx.keys.resize(depth + 1);
+				do
+				{
+					std::string& strKey = ctx.keys[depth];
+					reader.readKey(strKey);
+					++count;
+					if (bCountKeys)
+						vecKeys.push_back(strKey);
+					const Property* pProp = node.properties.empty() ? nullptr : find_property(node, strKey, key_hash(strKey.data(), strKey.size()));
+					uint32_t child = npos;
+					ctx.path.push_back(PathItem{ strKey });
+					if (pProp != nullptr)
+					{
+						size_t pos = pProp - node.properties.data();
+						if (pos < 64)
+							seenMask |= 1ull << pos;
+						else
+							vecSeen[pos] = true;
+						child = pProp->node;
+					}
+					else if (node.noAdditional)
+						bOk &= fail(ctx, "additionalProperties", "additional property is not allowed.");
+					else
+						child = node.additional;
+					if (child != npos)
+						bOk &= check_stream(child, reader, ctx);
+					else
+						reader.skipValue();
+					ctx.path.pop_back();
+				} while (reader.nextElement('}'));
+			}
+			if (bCountKeys)
+			{
+				std::sort(vecKeys.begin(), vecKeys.end());
+				count = static_cast<size_t>(std::unique(vecKeys.begin(), vecKeys.end()) - vecKeys.begin());
+			}
+			bOk &= check_count(count, node.minProperties, node.maxProperties, "minProperties", "maxProperties", "properties", ctx);
+			if (node.requiredCount > 0 && ((seenMask & node.requiredMask) != node.requiredMask || node.properties.size() > 64))
+			{
+				for (size_t i = 0; i < node.properties.size(); ++i)
+				{
+					const Property& prop = node.properties[i];
+					bool bSeen = i < 64 ? (seenMask >> i) & 1 : vecSeen[i];
+					if (prop.required && !bSeen)
+						bOk &= fail(ctx, "required", "missing required property \"" + prop.key + "\".");
+				}
+			}
+			return bOk;
+		}
+
+		static bool skip(Reader& reader) {
+			reader.skipValue();
+			return false;
+		}
+
+		/*----------------------------------公共检查----------------------------------*/
+		bool check_type(const Node& node, uint8_t mask, Context& ctx) const {
+			if (mask & node.types)
+				return true;
+			std::string strMsg = "expected ";
+			static const char* const arrNames[] = { "null", "boolean", "object", "array", "number", "integer", "string" };
+			bool bFirst = true;
+			for (int i = 0; i < 7; ++i)
+			{
+				if (node.types & (1 << i))
+				{
+					strMsg += bFirst ? "" : " or ";
+					strMsg += arrNames[i];
+					bFirst = false;
+				}
+			}
+			for (int i = 0; i < 7; ++i)
+			{
+				if (mask & (1 << i))
+				{
+					strMsg += std::string(", found ") + arrNames[i] + ".";
+					break;
+				}
+			}
+			return fail(ctx, "type", strMsg);
+		}
+
+		bool check_string(const Node& node, const std::string_view& str, Context& ctx) const {
+			bool bOk = true;
+			if (node.minLength > 0 || node.maxLength != unlimited)
+			{
+				uint64_t len = 0;//按UTF-8字符计数
+				for (char c : str)
+					len += (static_cast<uint8_t>(c) & 0xC0) != 0x80 ? 1 : 0;
+				if (len < node.minLength)
+					bOk = fail(ctx, "minLength", "string is shorter than " + std::to_string(node.minLength) + ".");
+				else if (len > node.maxLength)
+					bOk = fail(ctx, "maxLength", "string is longer than " + std::to_string(node.maxLength) + ".");
+				if (!bOk && !ctx.pErrors)
+					return false;
+			}
+			if (node.pattern != npos && !std::regex_search(str.begin(), str.end(), m_vecRegex[node.pattern]))
+				bOk = fail(ctx, "pattern", "string does not match pattern.");
+			return bOk;
+		}
+
+		bool check_number(const Node& node, const Value& jv, Context& ctx) const {
+			if (node.minimum.set)
+			{
+				int cmp = compare(jv, node.minimum);
+				if (cmp < 0 || (cmp == 0 && node.minimum.exclusive))
+					return fail(ctx, node.minimum.exclusive ? "exclusiveMinimum" : "minimum", "value " + jv.dumpFast() + " is less than " + (node.minimum.exclusive ? "or equal to " : "") + bound_string(node.minimum) + ".");
+			}
+			if (node.maximum.set)
+			{
+				int cmp = compare(jv, node.maximum);
+				if (cmp > 0 || (cmp == 0 && node.maximum.exclusive))
+					return fail(ctx, node.maximum.exclusive ? "exclusiveMaximum" : "maximum", "value " + jv.dumpFast() + " is greater than " + (node.maximum.exclusive ? "or equal to " : "") + bound_string(node.maximum) + ".");
+			}
+			return true;
+		}
+
+		bool check_count(size_t count, uint64_t minCount, uint64_t maxCount, const char* pMinKey, const char* pMaxKey, const char* pWhat, Context& ctx) const {
+			if (count < minCount)
+				return fail(ctx, pMinKey, std::string("expected at least ") + std::to_string(minCount) + " " + pWhat + ", found " + std::to_string(count) + ".");
+			if (count > maxCount)
+				return fail(ctx, pMaxKey, std::string("expected at most ") + std::to_string(maxCount) + " " + pWhat + ", found " + std::to_string(count) + ".");
+			return true;
+		}
+
+		static std::string bound_string(const Bound& bound) {
+			return bound.isInt ? std::to_string(bound.i) : Value(bound.d).dumpFast();
+		}
+
+		//数字与边界比较，返回-1、0、1
+		static int compare(const Value& jv, const Bound& bound) {
+			switch (jv.Type) {
+			case emJsonType::Integral:
+				if (bound.isInt)
+					return jv.Internal.Int < bound.i ? -1 : (jv.Internal.Int > bound.i ? 1 : 0);
+				return compare_double(static_cast<double>(jv.Internal.Int), bound.d);
+			case emJsonType::Uintegral:
+				if (bound.isInt)
+					return bound.i < 0 || jv.Internal.Uint64 > static_cast<uint64_t>(bound.i) ? 1 : (jv.Internal.Uint64 < static_cast<uint64_t>(bound.i) ? -1 : 0);
+				return compare_double(static_cast<double>(jv.Internal.Uint64), bound.d);
+			default:
+				return compare_double(jv.Internal.Float, bound.d);
+			}
+		}
+
+		static int compare_double(double lhs, double rhs) {
+			return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+		}
+
+		static uint8_t type_mask(const Value& jv) {
+			switch (jv.Type) {
+			case emJsonType::Null: return TYPE_NULL;
+			case emJsonType::Boolean: return TYPE_BOOLEAN;
+			case emJsonType::Object: return TYPE_OBJECT;
+			case emJsonType::Array: return TYPE_ARRAY;
+			case emJsonType::String: return TYPE_STRING;
+			case emJsonType::Integral:
+			case emJsonType::Uintegral: return TYPE_NUMBER | TYPE_INTEGER;
+			default://小数部分为0的浮点数也是integer
+				return TYPE_NUMBER | (std::isfinite(jv.Internal.Float) && std::floor(jv.Internal.Float) == jv.Internal.Float ? TYPE_INTEGER : 0);
+			}
+		}
+
+		//数组的第i个元素，紧凑存储的数组把元素放在temp中返回
+		static const Value& item_at(const Value& jv, size_t i, Value& temp) {
+			switch (jv.Storage) {
+			case emArrayStorage::Int64: temp = (*jv.Internal.IntList)[i]; return temp;
+			case emArrayStorage::Double: temp = (*jv.Internal.FloatList)[i]; return temp;
+			default: return (*jv.Internal.List)[i];
+			}
+		}
+
+		//Json值相等，数字按数值比较（1与1.0相等）
+		static bool equal(const Value& lhs, const Value& rhs) {
+			uint8_t lhsMask = type_mask(lhs), rhsMask = type_mask(rhs);
+			if ((lhsMask & TYPE_NUMBER) && (rhsMask & TYPE_NUMBER))
+			{
+				if (rhs.Type == emJsonType::Floating)
+				{
+					Bound bound;
+					bound.d = rhs.Internal.Float;
+					return compare(lhs, bound) == 0;
+				}
+				if (rhs.Type == emJsonType::Uintegral)
+				{
+					if (lhs.Type == emJsonType::Uintegral)
+						return lhs.Internal.Uint64 == rhs.Internal.Uint64;
+					if (lhs.Type == emJsonType::Integral)
+						return lhs.Internal.Int >= 0 && static_cast<uint64_t>(lhs.Internal.Int) == rhs.Internal.Uint64;
+					Bound bound;
+					bound.d = static_cast<double>(rhs.Internal.Uint64);
+					return lhs.Type == emJsonType::Floating && compare(lhs, bound) == 0;
+				}
+				Bound bound;
+				bound.isInt = true;
+				bound.i = rhs.Internal.Int;
+				bound.d = static_cast<double>(bound.i);
+				return compare(lhs, bound) == 0;
+			}
+			if (lhs.Type != rhs.Type)
+				return false;
+			switch (lhs.Type) {
+			case emJsonType::Null: return true;
+			case emJsonType::Boolean: return lhs.Internal.Bool == rhs.Internal.Bool;
+			case emJsonType::String: return *lhs.Internal.String == *rhs.Internal.String;
+			case emJsonType::Array: {
+				size_t count = static_cast<size_t>(lhs.size());
+				if (count != static_cast<size_t>(rhs.size()))
+					return false;
+				Value lhsTemp, rhsTemp;
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (!equal(item_at(lhs, i, lhsTemp), item_at(rhs, i, rhsTemp)))
+						return false;
+				}
+				return true;
+			}
+			case emJsonType::Object: {
+				if (lhs.size() != rhs.size())
+					return false;
+				bool bEqual = true;
+				lhs.for_each_member([&](const std::string& key, const Value& jvMember) {
+					const Value* pOther = bEqual ? rhs.find(key) : nullptr;
+					bEqual = pOther != nullptr && equal(jvMember, *pOther);
+				});
+				return bEqual;
+			}
+			default: return false;
+			}
+		}
+
+		bool fail(Context& ctx, const char* pKeyword, std::string strMsg) const {
+			if (ctx.pErrors != nullptr)
+			{
+				Error error;
+				for (const auto& item : ctx.path)
+					error.path += "/" + (item.key.data() != nullptr ? escape_token(item.key) : std::to_string(item.index));
+				error.keyword = pKeyword;
+				error.message = std::move(strMsg);
+				ctx.pErrors->push_back(std::move(error));
+			}
+			return false;
+		}
+
+	private:
+		std::vector<Node> m_vecNodes;	//第0个为根节点
+		std::vector<Value> m_vecEnums;
+		std::vector<std::regex> m_vecRegex;
+	};
+}
+
+#endif // !MMR_UTIL_JSON_SCHEMA_HPP
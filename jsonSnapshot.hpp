@@ -0,0 +1,425 @@
+/**
+ * @file jsonSnapshot.hpp
+ * @brief 只读文档的二进制快照，可通过内存映射直接打开
+ * @author Mounmory (237628106@qq.com) https://github.com/Mounmory
+ * @date
+ *
+ *
+ * FrozenDocument的tape中只保存偏移，不保存指针，可以原样写入文件：
+ * - 快照由文件头、tape、字符串缓冲区和键索引组成，各段按8字节对齐
+ * - MappedDocument以只读方式映射快照文件，打开时只检查文件头，不解析、不分配内存
+ * - 通过ValueRef访问数据，接口与FrozenDocument一致，访问到的页面由系统按需加载
+ */
+
+#ifndef MMR_UTIL_JSON_SNAPSHOT_HPP
+#define MMR_UTIL_JSON_SNAPSHOT_HPP
+#include "jsonFrozen.hpp"
+
+#include <string>
+#include <cstring>
+#include <fstream>
+
+#if defined(OS_MMR_WIN) || defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+	快照文件格式，整数按本机字节序保存，字节序不同的机器上打开时报错
+		- 文件头64字节：8字节标识"MMRJSNAP"、4字节版本号、4字节字节序标记0x01020304，
+		  之后依次为tape、字符串缓冲区、键索引的偏移和长度（各8字节，tape和键索引的长度为元素个数）
+		- tape、字符串缓冲区、键索引，每段的起始偏移按8字节对齐
+	快照的内容与FrozenDocument完全一致，对象的键索引同样保存在文件中，按键查找为二分查找
+*/
+
+namespace Json
+{
+	struct SnapshotHeader
+	{
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint32_t ORDER_MARK = 0x01020304;
+
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrder;
+		uint64_t tapeOffset;
+		uint64_t tapeLen;
+		uint64_t stringsOffset;
+		uint64_t stringsLen;
+		uint64_t indexOffset;
+		uint64_t indexLen;
+	};
+	static_assert(sizeof(SnapshotHeader) == 64, "snapshot header must be 64 bytes.");
+
+	//以只读方式映射整个文件
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator = (const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) : m_pData(other.m_pData), m_size(other.m_size), m_modifyTime(other.m_modifyTime) {
+			other.m_pData = nullptr;
+			other.m_size = 0;
+		}
+
+		MappedFile& operator = (MappedFile&& other) {
+			if (this != &other)
+			{
+				close();
+				m_pData = other.m_pData;
+				m_size = other.m_size;
+				m_modifyTime = other.m_modifyTime;
+				other.m_pData = nullptr;
+				other.m_size = 0;
+			}
+			return *this;
+		}
+
+		~MappedFile() { close(); }
+
+		//失败时返回错误信息，原有映射不变；空文件无法映射，返回错误
+		std::string open(const std::string& strFile) {
+#if defined(OS_MMR_WIN) || defined(_WIN32)
+			HANDLE hFile = CreateFileA(strFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (hFile == INVALID_HANDLE_VALUE)
+				return "open file " + strFile + " failed!";
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0)
+			{
+				CloseHandle(hFile);
+				return "file " + strFile + " is empty!";
+			}
+			FILETIME writeTime = {};
+			GetFileTime(hFile, nullptr, nullptr, &writeTime);
+			uint64_t modifyTime = (static_cast<uint64_t>(writeTime.dwHighDateTime) << 32) | writeTime.dwLowDateTime;
+			HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(hFile);
+			if (hMapping == nullptr)
+				return "map file " + strFile + " failed!";
+			void* pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(hMapping);//映射视图保持对映射对象的引用
+			if (pData == nullptr)
+				return "map file " + strFile + " failed!";
+			size_t size = static_cast<size_t>(fileSize.QuadPart);
+#else
+			int fd = ::open(strFile.c_str(), O_RDONLY);
+			if (fd < 0)
+				return "open file " + strFile + " failed!";
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0)
+			{
+				::close(fd);
+				return "file " + strFile + " is empty!";
+			}
+			void* pData = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);//映射建立后可以关闭文件
+			if (pData == MAP_FAILED)
+				return "map file " + strFile + " failed!";
+			size_t size = static_cast<size_t>(st.st_size);
+#if defined(__APPLE__)
+			uint64_t modifyTime = static_cast<uint64_t>(st.st_mtimespec.tv_sec) * 1000000000ull + static_cast<uint64_t>(st.st_mtimespec.tv_nsec);
+#else
+			uint64_t modifyTime = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000ull + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+#endif
+#endif
+			close();
+			m_pData = static_cast<const char*>(pData);
+			m_size = size;
+			m_modifyTime = modifyTime;
+			return std::string();
+		}
+
+		void close() {
+			if (m_pData != nullptr)
+			{
+#if defined(OS_MMR_WIN) || defined(_WIN32)
+				UnmapViewOfFile(m_pData);
+#else
+				munmap(const_cast<char*>(m_pData), m_size);
+#endif
+			}
+			m_pData = nullptr;
+			m_size = 0;
+			m_modifyTime = 0;
+		}
+
+		bool is_open() const { return m_pData != nullptr; }
+		const char* data() const { return m_pData; }
+		size_t size() const { return m_size; }
+		std::string_view view() const { return std::string_view(m_pData, m_size); }
+		//打开时文件的修改时间，只用于判断文件是否变化，单位与平台有关
+		uint64_t modify_time() const { return m_modifyTime; }
+
+	private:
+		const char* m_pData = nullptr;
+		size_t m_size = 0;
+		uint64_t m_modifyTime = 0;
+	};
+
+	class MappedDocument
+	{
+	public:
+		MappedDocument() = default;
+
+		MappedDocument(const MappedDocument&) = delete;
+		MappedDocument& operator = (const MappedDocument&) = delete;
+
+		MappedDocument(MappedDocument&& other) { move_from(other); }
+
+		MappedDocument& operator = (MappedDocument&& other) {
+			if (this != &other)
+			{
+				close();
+				move_from(other);
+			}
+			return *this;
+		}
+
+		~MappedDocument() { close(); }
+
+		//将只读文档写为快照，追加到strOut中
+		static void write(const FrozenDocument& doc, std::string& strOut) {
+			SnapshotHeader header;
+			memcpy(header.magic, "MMRJSNAP", sizeof(header.magic));
+			header.version = SnapshotHeader::VERSION;
+			header.byteOrder = SnapshotHeader::ORDER_MARK;
+			header.tapeOffset = sizeof(SnapshotHeader);
+			header.tapeLen = doc.m_vecTape.size();
+			header.stringsOffset = align8(header.tapeOffset + header.tapeLen * sizeof(uint64_t));
+			header.stringsLen = doc.m_strBuffer.size();
+			header.indexOffset = align8(header.stringsOffset + header.stringsLen);
+			header.indexLen = doc.m_vecIndex.size();
+
+			size_t base = strOut.size();
+			strOut.resize(base + static_cast<size_t>(header.indexOffset + header.indexLen * sizeof(uint32_t)), '\0');
+			char* pOut = &strOut[base];
+			memcpy(pOut, &header, sizeof(header));
+			if (header.tapeLen > 0)
+				memcpy(pOut + header.tapeOffset, doc.m_vecTape.data(), static_cast<size_t>(header.tapeLen * sizeof(uint64_t)));
+			if (header.stringsLen > 0)
+				memcpy(pOut + header.stringsOffset, doc.m_strBuffer.data(), static_cast<size_t>(header.stringsLen));
+			if (header.indexLen > 0)
+				memcpy(pOut + header.indexOffset, doc.m_vecIndex.data(), static_cast<size_t>(header.indexLen * sizeof(uint32_t)));
+		}
+
+		static bool save_to_file(const FrozenDocument& doc, const std::string& strFile) {
+			std::string strData;
+			write(doc, strData);
+			std::ofstream outFile(strFile, std::ios::binary | std::ios::trunc);
+			if (!outFile.is_open())
+				return false;
+			outFile.write(strData.data(), static_cast<std::streamsize>(strData.size()));
+			return outFile.good();
+		}
+
+		static bool save_to_file(const Value& jvData, const std::string& strFile) {
+			return save_to_file(FrozenDocument(jvData), strFile);
+		}
+
+		//映射快照文件，失败时返回错误信息，原有数据不变；bVerify为true时检查整个tape，会读取全部页面
+		std::string open(const std::string& strFile, bool bVerify = false) {
+			MappedDocument temDoc;
+			std::string strErr = temDoc.m_file.open(strFile);
+			if (strErr.empty())
+				strErr = temDoc.attach(temDoc.m_file.data(), temDoc.m_file.size(), bVerify);
+			if (strErr.empty())
+				(*this) = std::move(temDoc);
+			return strErr;
+		}
+
+		//使用调用方持有的内存中的快照，不拷贝数据，data需按8字节对齐且在文档使用期间有效
+		std::string load(const void* data, size_t len, bool bVerify = false) {
+			MappedDocument temDoc;
+			std::string strErr = temDoc.attach(static_cast<const char*>(data), len, bVerify);
+			if (strErr.empty())
+				(*this) = std::move(temDoc);
+			return strErr;
+		}
+
+		void close() {
+			m_file.close();
+			m_pData = nullptr;
+			m_size = 0;
+			m_view = TapeView();
+		}
+
+		bool is_open() const { return m_view.tapeLen > 0; }
+
+		//文档为空时返回null
+		ValueRef root() const {
+			return is_open() ? ValueRef(&m_view, 0) : ValueRef();
+		}
+
+		//快照的字节数
+		size_t size() const { return m_size; }
+
+		//逐个检查tape中的字、字符串及键索引是否越界，用于打开来源不可信的快照
+		std::string verify() const {
+			if (!is_open())
+				return "snapshot is not open.";
+			size_t pos = 0;
+			std::string strErr = verify_value(pos, 0);
+			if (strErr.empty() && pos != m_view.tapeLen)
+				strErr = "snapshot tape has trailing data.";
+			return strErr;
+		}
+
+	private:
+		static uint64_t align8(uint64_t offset) { return (offset + 7) & ~static_cast<uint64_t>(7); }
+
+		void move_from(MappedDocument& other) {
+			m_file = std::move(other.m_file);
+			m_pData = other.m_pData;
+			m_size = other.m_size;
+			m_stringsLen = other.m_stringsLen;
+			m_indexLen = other.m_indexLen;
+			m_view = other.m_view;
+			other.m_pData = nullptr;
+			other.m_size = 0;
+			other.m_view = TapeView();
+		}
+
+		//检查文件头后直接指向快照中的各段，不拷贝数据
+		std::string attach(const char* data, size_t len, bool bVerify) {
+			if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0)
+				return "snapshot data is not 8-byte aligned.";
+			if (len < sizeof(SnapshotHeader))
+				return "snapshot data is too short.";
+			SnapshotHeader header;
+			memcpy(&header, data, sizeof(header));
+			if (memcmp(header.magic, "MMRJSNAP", sizeof(header.magic)) != 0)
+				return "not a json snapshot.";
+			if (header.byteOrder != SnapshotHeader::ORDER_MARK)
+				return "snapshot byte order mismatch.";
+			if (header.version != SnapshotHeader::VERSION)
+				return "unsupported snapshot version " + std::to_string(header.version) + ".";
+			if (!section_valid(header.tapeOffset, header.tapeLen, sizeof(uint64_t), len)
+				|| !section_valid(header.stringsOffset, header.stringsLen, 1, len)
+				|| !section_valid(header.indexOffset, header.indexLen, sizeof(uint32_t), len)
+				|| header.tapeLen == 0 || header.tapeLen > 0xFFFFFFFFull)
+				return "snapshot section out of range.";
+
+			m_view.tape = reinterpret_cast<const uint64_t*>(data + header.tapeOffset);
+			m_view.tapeLen = static_cast<size_t>(header.tapeLen);
+			m_view.strings = data + header.stringsOffset;
+			m_view.index = reinterpret_cast<const uint32_t*>(data + header.indexOffset);
+			m_stringsLen = static_cast<size_t>(header.stringsLen);
+			m_indexLen = static_cast<size_t>(header.indexLen);
+			m_pData = data;
+			m_size = len;
+			return bVerify ? verify() : std::string();
+		}
+
+		static bool section_valid(uint64_t offset, uint64_t count, size_t unit, size_t len) {
+			return offset % 8 == 0 && offset >= sizeof(SnapshotHeader) && offset <= len
+				&& count <= (len - offset) / unit;
+		}
+
+		bool string_valid(size_t pos) const {
+			uint64_t offset = m_view.payload(pos);
+			if (offset > m_stringsLen || m_stringsLen - offset < sizeof(uint32_t) + 1)
+				return false;
+			uint32_t len = 0;
+			memcpy(&len, m_view.strings + offset, sizeof(len));
+			return len <= m_stringsLen - offset - sizeof(uint32_t) - 1;
+		}
+
+		std::string verify_value(size_t& pos, size_t depth) const {
+			if (pos >= m_view.tapeLen)
+				return "snapshot tape truncated.";
+			if (depth >= 1024)
+				return "snapshot nested too deep.";
+			size_t open = pos;
+			switch (m_view.tag(pos)) {
+			case 'n':
+			case 't':
+			case 'f':
+				++pos;
+				return std::string();
+			case 'l':
+			case 'u':
+			case 'd':
+				pos += 2;
+				return pos <= m_view.tapeLen ? std::string() : "snapshot tape truncated.";
+			case '"':
+				++pos;
+				return string_valid(open) ? std::string() : "snapshot string out of range.";
+			case '[':
+			case '{': {
+				bool isObject = m_view.tag(pos) == '{';
+				size_t end = static_cast<uint32_t>(m_view.payload(pos));
+				if (end <= open + (isObject ? 2 : 1) || end > m_view.tapeLen
+					|| m_view.tag(end - 1) != (isObject ? '}' : ']') || m_view.payload(end - 1) != open)
+					return "snapshot container out of range.";
+				size_t count = 0;
+				pos = open + (isObject ? 2 : 1);
+				while (pos < end - 1)
+				{
+					bool bLive = true;
+					if (isObject)
+					{
+						bLive = m_view.tag(pos) == '"';
+						if ((!bLive && m_view.tag(pos) != TapeView::DEAD_KEY) || !string_valid(pos))
+							return "snapshot object key invalid.";
+						++pos;
+					}
+					std::string strErr = verify_value(pos, depth + 1);
+					if (!strErr.empty())
+						return strErr;
+					if (bLive)
+						++count;
+				}
+				if (pos != end - 1)
+					return "snapshot container out of range.";
+				uint64_t cnt = m_view.payload(open) >> 32;
+				if (cnt != (count < TapeView::COUNT_SATURATED ? count : TapeView::COUNT_SATURATED))
+					return "snapshot container count mismatch.";
+				pos = end;
+				if (isObject)
+					return verify_key_index(open, count);
+				return std::string();
+			}
+			default:
+				return "snapshot tape has unknown tag.";
+			}
+		}
+
+		//键索引中的每一项必须指向本对象的键
+		std::string verify_key_index(size_t objIdx, size_t count) const {
+			uint64_t aux = m_view.tape[objIdx + 1];
+			if (aux == 0)
+				return std::string();
+			if (aux - 1 >= m_indexLen || m_view.index[aux - 1] != count || count > m_indexLen - aux)
+				return "snapshot key index out of range.";
+			size_t end = static_cast<uint32_t>(m_view.payload(objIdx)) - 1;
+			const uint32_t* pBegin = m_view.index + aux;
+			for (size_t i = 0; i < count; ++i)
+			{
+				size_t keyPos = pBegin[i];
+				if (keyPos <= objIdx + 1 || keyPos >= end || m_view.tag(keyPos) != '"')
+					return "snapshot key index out of range.";
+			}
+			return std::string();
+		}
+
+	private:
+		MappedFile m_file;
+		const char* m_pData = nullptr;
+		size_t m_size = 0;
+		size_t m_stringsLen = 0;
+		size_t m_indexLen = 0;
+		TapeView m_view;
+	};
+}
+
+#endif // !MMR_UTIL_JSON_SNAPSHOT_HPP
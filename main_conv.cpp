@@ -1,5 +1,5 @@
 ﻿#include <iostream>
-#include "JsonConverter.hpp"
+#include "jsonConverter.hpp"
 
 
 enum class EM_type
@@ -1,4 +1,4 @@
-﻿#include "JsonConverter.hpp"
+﻿#include "jsonConverter.hpp"
 #include <iostream>
 #include <functional>
 
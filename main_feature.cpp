@@ -0,0 +1,1515 @@
+#include "jsonFrozen.hpp"
+#include "jsonSnapshot.hpp"
+#include "jsonCompact.hpp"
+#include "jsonConverter.hpp"
+#include "jsonPath.hpp"
+#include "jsonIndex.hpp"
+#include "jsonSchema.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <ctime>
+
+//功能检查，失败时计数，返回值非0
+static int g_iFailed = 0;
+
+#define FEATURE_CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			++g_iFailed; \
+			std::cout << "检查失败 " << __FILE__ << ":" << __LINE__ << " " << #expr << std::endl; \
+		} \
+	} while (0)
+
+static const char* s_jsonDoc = R"({"name":"tiny","count":3,"ratio":2.5,"big":18446744073709551615,
+	"list":[1,2.5,"x\ny",true,null],"sub":{"k1":1,"k2":2,"k3":3,"k4":4,"k5":5,"k6":6,"k7":7,"k8":8,"k9":9}})";
+
+struct FeaturePoint
+{
+	int x = 0;
+	int y = 0;
+	std::string label;
+	std::vector<double> weights;
+
+	ADD_JSON_MEMBER(x, y, label, weights);
+};
+
+//手写转换接口的结构体
+struct FeatureColor
+{
+	int r = 0;
+	int g = 0;
+	int b = 0;
+
+	Json::Value generateJson() const
+	{
+		Json::Value jv;
+		generateJson(jv);
+		return jv;
+	}
+	void parseJson(const Json::Value& jv)
+	{
+		r = jv["r"].get<int>();
+		g = jv["g"].get<int>();
+		b = jv["b"].get<int>();
+	}
+protected:
+	friend class Json::Value;
+	void generateJson(Json::Value& jv) const
+	{
+		jv["r"] = r;
+		jv["g"] = g;
+		jv["b"] = b;
+	}
+};
+
+//继承自手写转换接口的基类
+struct FeatureStyledColor : public FeatureColor
+{
+	std::string style = "solid";
+	double alpha = 1.0;
+
+	ADD_JSON_MEMBER_INHERIT(FeatureColor, style, alpha);
+};
+
+struct FeatureNamedColor : public FeatureStyledColor
+{
+	std::string label;
+
+	ADD_JSON_MEMBER_INHERIT(FeatureStyledColor, label);
+};
+
+struct FeaturePalette
+{
+	std::string name = "palette";
+	FeatureColor color;
+	std::vector<FeatureColor> vecColors;
+
+	ADD_JSON_MEMBER(name, color, vecColors);
+};
+
+struct FeatureGroup
+{
+	std::string name = "group";
+	std::optional<int> optCount;
+	std::optional<double> optRatio = 0.25;
+	std::shared_ptr<FeaturePoint> ptrCenter;
+	std::map<std::string, std::vector<FeaturePoint>> mapPoints;
+	std::vector<int> vecEmpty;
+	Json::Value jvExtra;
+
+	ADD_JSON_MEMBER(name, optCount, optRatio, ptrCenter, mapPoints, vecEmpty, jvExtra);
+};
+
+//多态类型
+struct FeatureShape
+{
+	std::string color = "red";
+	int borderWidth = 1;
+
+	ADD_JSON_MEMBER_BASE_DEPL(FeatureShape, color, borderWidth);
+};
+
+struct FeatureCircle : public FeatureShape
+{
+	double radius = 10.0;
+
+	ADD_JSON_MEMBER_DERIVE_DEPL(FeatureShape, FeatureCircle, radius);
+};
+
+#if __cplusplus < 201703L//小于cpp17标准，注册类型
+REGISTER_TEPE(FeatureShape);
+REGISTER_TEPE(FeatureCircle);
+#endif
+
+struct FeatureDrawing
+{
+	std::shared_ptr<FeatureShape> shape;
+	std::vector<std::shared_ptr<FeatureShape>> vecShapes;
+	std::string name = "drawing";
+
+	ADD_JSON_MEMBER(shape, vecShapes, name);
+};
+
+//记录修改的结构体
+struct FeatureState
+{
+	int tick = 0;
+	std::string name = "state";
+	FeaturePoint pos;
+	std::vector<int> vecIds;
+
+	ADD_JSON_MEMBER_TRACKED(tick, name, pos, vecIds);
+};
+
+//时间类型
+struct FeatureEvent
+{
+	std::chrono::system_clock::time_point tpTime;
+	std::chrono::milliseconds msDelay{ 0 };
+	std::vector<FeaturePoint> vecPoints;
+
+	ADD_JSON_MEMBER(tpTime, msDelay, vecPoints);
+};
+
+#ifdef MMR_JSON_CPP17
+//变体类型
+struct FeatureVariant
+{
+	std::variant<int, double> varNumber;
+	std::variant<double, int> varInt;
+	std::variant<unsigned int, int> varSigned;
+	std::variant<std::monostate, std::string, int64_t> varOther;
+
+	ADD_JSON_MEMBER(varNumber, varInt, varSigned, varOther);
+};
+#endif // MMR_JSON_CPP17
+
+//二进制数据
+struct FeatureBlob
+{
+	std::vector<uint8_t> vecData;
+#ifdef MMR_JSON_CPP17
+	std::vector<std::byte> vecBytes;
+
+	ADD_JSON_MEMBER(vecData, vecBytes);
+#else
+	ADD_JSON_MEMBER(vecData);
+#endif // MMR_JSON_CPP17
+};
+
+//其它容器
+struct FeatureContainers
+{
+	std::unordered_map<std::string, int> mapCount;
+	std::deque<FeaturePoint> dequePoints;
+	std::array<int, 3> arrData{};
+	std::set<std::string> setNames;
+	std::unordered_set<int> setIds;
+	std::pair<std::string, double> pairValue;
+	std::tuple<int, std::string, std::vector<int>> tupleValue;
+
+	ADD_JSON_MEMBER(mapCount, dequePoints, arrData, setNames, setIds, pairValue, tupleValue);
+};
+
+//由Value转换得到的文本与直接输出的文本内容一致
+template<typename T>
+bool same_as_value(const T& data)
+{
+	Json::Value jv;
+	jv << data;
+	Json::Value jvWritten;
+	return jvWritten.load(mmrUtil::toJsonString(data)).empty() && jv.dumpFast() == jvWritten.dumpFast();
+}
+
+static FeatureGroup make_group()
+{
+	FeatureGroup group;
+	group.ptrCenter = std::make_shared<FeaturePoint>();
+	group.ptrCenter->label = "center";
+	group.mapPoints["a"].resize(2);
+	group.mapPoints["a"][1].weights = { 1.0, 2.0 };
+	group.mapPoints["b"];
+	group.jvExtra["k"] = "v";
+	return group;
+}
+
+/****** 只读文档 ******/
+void testFrozen()
+{
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(s_jsonDoc).empty());
+
+	//由Value生成的输出一致，直接解析时对象成员保持原始顺序
+	Json::FrozenDocument fdFromValue = Json::freeze(jv);
+	Json::FrozenDocument fdLoad;
+	FEATURE_CHECK(fdLoad.load(s_jsonDoc).empty());
+	FEATURE_CHECK(fdFromValue.root().dumpFast() == jv.dumpFast());
+	FEATURE_CHECK(fdLoad.root().size() == jv.size());
+
+	Json::ValueRef root = fdLoad.root();
+	FEATURE_CHECK(root["name"].get<std::string>() == "tiny");
+	FEATURE_CHECK(root["big"].get<uint64_t>() == 18446744073709551615ull);
+	FEATURE_CHECK(root["list"].length() == 5);
+	FEATURE_CHECK(root["list"][4].IsNull());
+	FEATURE_CHECK(root["sub"]["k7"].get<int>() == 7);
+	FEATURE_CHECK(!root.hasKey("none"));
+
+	//解析失败时保留原有数据
+	std::string strErr = fdLoad.load(R"({"a":,})");
+	FEATURE_CHECK(!strErr.empty());
+	FEATURE_CHECK(fdLoad.root()["count"].get<int>() == 3);
+
+	//重复的键与Json::Value一致，以最后一个为准
+	const char* szDup[] = { R"({"a":1,"a":2,"b":3})",
+		R"({"k0":0,"k1":1,"k2":2,"k1":{"x":[1]},"k3":3,"k4":4,"k5":5,"k6":6,"k0":7,"k7":8})" };
+	for (const char* szText : szDup)
+	{
+		Json::Value jvDup;
+		Json::FrozenDocument fdDup;
+		FEATURE_CHECK(jvDup.load(szText).empty() && fdDup.load(szText).empty());
+		FEATURE_CHECK(fdDup.root().size() == jvDup.size());
+		int iMembers = 0;
+		for (const auto& kv : fdDup.root().ObjectRange())
+		{
+			++iMembers;
+			FEATURE_CHECK(kv.second.dumpFast() == jvDup[std::string(kv.first.data(), kv.first.size())].dumpFast());
+		}
+		FEATURE_CHECK(iMembers == jvDup.size());
+	}
+
+	//多线程同时读取
+	int iSum[2] = { 0, 0 };
+	auto reader = [&root](int& iOut) {
+		for (int i = 0; i < 1000; ++i)
+			for (const auto& kv : root["sub"].ObjectRange())
+				iOut += kv.second.get<int>();
+	};
+	std::thread th1(reader, std::ref(iSum[0]));
+	std::thread th2(reader, std::ref(iSum[1]));
+	th1.join();
+	th2.join();
+	FEATURE_CHECK(iSum[0] == 45000 && iSum[1] == 45000);
+}
+
+/****** 紧凑型Json值 ******/
+void testCompact()
+{
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(R"({"a":1,"b":[1,-2.5,"x\ny",true,null,-140737488355329,9223372036854775807],"c":{"k":-5}})").empty());
+	jv["u"] = uint64_t(0xFFFFFFFFFFFFFFFFull);
+
+	//往返转换结果一致，超出内联范围的整数单独分配
+	Json::CompactValue cv(jv);
+	FEATURE_CHECK(cv.dumpFast() == jv.dumpFast());
+	FEATURE_CHECK(cv.toValue().dumpFast() == jv.dumpFast());
+	FEATURE_CHECK(cv["u"].JSONType() == Json::emJsonType::Uintegral);
+	FEATURE_CHECK(cv["u"].get<uint64_t>() == 0xFFFFFFFFFFFFFFFFull);
+	FEATURE_CHECK(cv["b"][5].get<int64_t>() == -140737488355329LL);
+	FEATURE_CHECK(cv["b"][6].get<int64_t>() == 9223372036854775807LL);
+
+	//移动不抛异常，数组扩容时移动元素而不是深拷贝
+	FEATURE_CHECK(std::is_nothrow_move_constructible<Json::CompactValue>::value);
+	FEATURE_CHECK(std::is_nothrow_move_assignable<Json::CompactValue>::value);
+
+	Json::CompactValue cvCopy = cv;
+	cv.clear();
+	FEATURE_CHECK(cvCopy["c"]["k"].get<int>() == -5);
+
+	Json::CompactValue cvStr = "hello";
+	cvStr = std::string("world");
+	FEATURE_CHECK(cvStr.get<std::string>() == "world");
+}
+
+/****** 数字数组紧凑存储的只读访问 ******/
+void testPackedConst()
+{
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(R"({"ids":[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19],"tags":["a","b"]})").empty());
+	const Json::Value& jvConst = jv;
+	FEATURE_CHECK(jvConst["ids"].ArrayStorage() == Json::emArrayStorage::Int64);
+
+	//const接口读取时不转换存储方式
+	FEATURE_CHECK(jvConst["ids"][5].get<int>() == 5);
+	FEATURE_CHECK(jvConst["ids"].at(19).get<int>() == 19);
+	FEATURE_CHECK(jvConst["ids"][20].IsNull());
+	FEATURE_CHECK(jvConst["tags"][1].get<std::string>() == "b");
+	FEATURE_CHECK(jvConst["tags"][7].IsNull() && jvConst["tags"].length() == 2);
+	bool bThrow = false;
+	try { jvConst["ids"].at(20); }
+	catch (const std::out_of_range&) { bThrow = true; }
+	FEATURE_CHECK(bThrow);
+
+	//返回的引用指向只读副本，数组修改前一直有效，追加的元素同步到副本
+	Json::Value jvLong;
+	for (int i = 0; i <= 100; ++i)
+		jvLong.append(i);
+	FEATURE_CHECK(jvLong.pack());
+	const Json::Value& jvLongConst = jvLong;
+	const Json::Value& jvElem = jvLongConst[2];
+	const Json::Value& jvLast = jvLongConst.at(100);
+	FEATURE_CHECK(jvElem.get<int>() == 2 && jvLast.get<int>() == 100 && &jvElem == &jvLongConst[2]);
+	jvLong.append(101);
+	FEATURE_CHECK(jvLong.ArrayStorage() == Json::emArrayStorage::Int64 && jvLongConst[101].get<int>() == 101);
+	FEATURE_CHECK(jvElem.get<int>() == 2 && jvLast.get<int>() == 100);
+	Json::Value jvLongCopy = jvLong;
+	FEATURE_CHECK(jvLongCopy.ArrayStorage() == Json::emArrayStorage::Int64 && jvLongCopy.dumpFast() == jvLong.dumpFast());
+	jvLong[0] = "zero";
+	FEATURE_CHECK(&jvElem == &jvLong[2] && jvLong[101].get<int>() == 101);
+
+	//多线程同时通过const接口读取
+	int iSum[2] = { 0, 0 };
+	auto reader = [&jvConst](int& iOut) {
+		for (int i = 0; i < 1000; ++i)
+		{
+			for (const auto& item : jvConst["ids"].ArrayRange())
+				iOut += item.get<int>();
+			iOut -= jvConst["ids"][19].get<int>();
+		}
+	};
+	std::thread th1(reader, std::ref(iSum[0]));
+	std::thread th2(reader, std::ref(iSum[1]));
+	th1.join();
+	th2.join();
+	FEATURE_CHECK(iSum[0] == 171000 && iSum[1] == 171000);
+	FEATURE_CHECK(jvConst["ids"].ArrayStorage() == Json::emArrayStorage::Int64);
+
+	//非const访问时转换为通用存储
+	jv["ids"][0] = "zero";
+	FEATURE_CHECK(jv["ids"].ArrayStorage() == Json::emArrayStorage::Generic);
+	FEATURE_CHECK(jv["ids"][0].get<std::string>() == "zero" && jv["ids"][1].get<int>() == 1);
+}
+
+/****** 键驻留 ******/
+void testKeyPool()
+{
+	static_assert(Json::key_hash("id", 2) != 0, "key_hash is constexpr");
+	Json::KeyPool pool;
+	Json::InternedKey id = pool.intern("id");
+	FEATURE_CHECK(id == pool.intern(std::string("id")));
+	FEATURE_CHECK(id != pool.intern("ts"));
+	FEATURE_CHECK(id.hash() == Json::key_hash("id", 2) && id.str() == "id");
+	FEATURE_CHECK(pool.size() == 2);
+
+	//全局驻留表多线程驻留
+	Json::InternedKey keys[2];
+	auto worker = [&keys](int i) {
+		for (int n = 0; n < 1000; ++n)
+			keys[i] = Json::KeyPool::global().intern("key" + std::to_string(n));
+	};
+	std::thread th1(worker, 0);
+	std::thread th2(worker, 1);
+	th1.join();
+	th2.join();
+	FEATURE_CHECK(keys[0] == keys[1] && keys[0].str() == "key999");
+
+	//按形状保存的对象使用驻留表中的键，std::map存储的对象键含转义时原样往返
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(R"([{"id":1,"ts":2},{"id":3,"ts":4}])", pool).empty());
+	FEATURE_CHECK(jv[0].Shape() != nullptr && jv[0].Shape()->key(0) == pool.intern(jv[0].Shape()->key(0).str()));
+	FEATURE_CHECK(pool.size() == 2);
+	FEATURE_CHECK(jv.load(R"({"a\"b":1,"c":{"d":[1,2]}})").empty());
+	FEATURE_CHECK(jv.dumpFast() == R"({"a\"b":1,"c":{"d":[1,2]}})");
+	FEATURE_CHECK(!jv.load(R"({"a":1,"b"})").empty());
+	FEATURE_CHECK(jv.hasKey("c"));
+}
+
+/****** 对象形状的只读访问 ******/
+void testShapeConst()
+{
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(R"([{"id":1,"ts":100,"v":0.5},{"id":2,"ts":101,"v":0.7}])").empty());
+	const Json::Value& jvConst = jv;
+	FEATURE_CHECK(jvConst[0].Shape() != nullptr && jvConst[0].Shape() == jvConst[1].Shape());
+
+	//const接口读取时不转换存储方式，不存在的键为null且不插入
+	FEATURE_CHECK(jvConst[1]["ts"].get<int>() == 101);
+	FEATURE_CHECK(jvConst[1]["none"].IsNull());
+	FEATURE_CHECK(jvConst[1].size() == 3);
+	std::string strKeys;
+	for (const auto& kv : jvConst[0].ObjectRange())
+		strKeys += kv.first;
+	FEATURE_CHECK(strKeys == "idtsv");
+	auto iter = jvConst[1].ObjectRange().begin();
+	FEATURE_CHECK(iter->first == "id" && iter->second.get<int>() == 2);
+
+	//与std::map存储一致，遍历时可以使用auto&
+	Json::Value jvMap;
+	FEATURE_CHECK(jvMap.load(R"({"b":2,"a":1})").empty() && jvMap.ObjectStorage() == Json::emObjectStorage::Generic);
+	const Json::Value& jvMapConst = jvMap;
+	for (const Json::Value* pObject : { &jvConst[0], &jvMapConst })
+	{
+		std::string strRange;
+		for (auto& kv : pObject->ObjectRange())
+			strRange += kv.first + kv.second.dumpFast() + ";";
+		FEATURE_CHECK(strRange == (pObject == &jvMapConst ? "a1;b2;" : "id1;ts100;v0.500000;"));
+	}
+	FEATURE_CHECK(jvConst[0].ObjectStorage() == Json::emObjectStorage::Shaped);
+
+	//多线程同时通过const接口读取
+	int iSum[2] = { 0, 0 };
+	auto reader = [&jvConst](int& iOut) {
+		for (int i = 0; i < 1000; ++i)
+		{
+			for (const auto& kv : jvConst[1].ObjectRange())
+			{
+				if (kv.first != "v")
+					iOut += kv.second.get<int>();
+			}
+			iOut -= jvConst[0]["ts"].get<int>();
+		}
+	};
+	std::thread th1(reader, std::ref(iSum[0]));
+	std::thread th2(reader, std::ref(iSum[1]));
+	th1.join();
+	th2.join();
+	FEATURE_CHECK(iSum[0] == 3000 && iSum[1] == 3000);
+	FEATURE_CHECK(jvConst[1].ObjectStorage() == Json::emObjectStorage::Shaped);
+
+	//插入新的键时转换为std::map存储，输出一致
+	std::string strBefore = jv.dumpFast();
+	jv[0]["extra"] = true;
+	FEATURE_CHECK(jv[0].ObjectStorage() == Json::emObjectStorage::Generic);
+	FEATURE_CHECK(jv[1].dumpFast() == R"({"id":2,"ts":101,"v":0.700000})");
+	FEATURE_CHECK(strBefore.size() < jv.dumpFast().size());
+}
+
+/****** 结构体成员名称表 ******/
+void testMemberTable()
+{
+	FeaturePoint pt;
+	pt.x = 3;
+	pt.y = -4;
+	pt.label = "a long label that does not fit in the small string buffer";
+	pt.weights = { 0.5, 1.5 };
+
+	//Value与Writer两条输出路径内容一致（Writer按声明顺序输出），往返后数据不变
+	Json::Value jv;
+	jv << pt;
+	Json::Value jvWritten;
+	FEATURE_CHECK(jvWritten.load(mmrUtil::toJsonString(pt)).empty());
+	FEATURE_CHECK(jv.dumpFast() == jvWritten.dumpFast());
+	FeaturePoint ptRead;
+	jv >> ptRead;
+	FEATURE_CHECK(ptRead.x == 3 && ptRead.y == -4 && ptRead.label == pt.label && ptRead.weights == pt.weights);
+
+	//set替换已存在的键，按形状保存的对象通过槽位赋值
+	jv.set(std::string_view("x"), Json::Value(7));
+	FEATURE_CHECK(jv["x"].get<int>() == 7 && jv.size() == 4);
+	Json::Value jvRecords;
+	FEATURE_CHECK(jvRecords.load(R"([{"x":1,"y":2},{"x":3,"y":4}])").empty());
+	jvRecords[1].set(std::string_view("y"), Json::Value(9));
+	FEATURE_CHECK(jvRecords[1].ObjectStorage() == Json::emObjectStorage::Shaped && jvRecords[1]["y"].get<int>() == 9);
+	jvRecords[1].set(std::string_view("z"), Json::Value(1));
+	FEATURE_CHECK(jvRecords[1].size() == 3 && jvRecords[0].size() == 2);
+
+	//std::map存储的对象直接用string_view查找，键不需要以'\0'结尾
+	std::string strKeys = "xyz";
+	FEATURE_CHECK(jvRecords[1].ObjectStorage() == Json::emObjectStorage::Generic);
+	FEATURE_CHECK(jvRecords[1].find(std::string_view(strKeys.data() + 1, 1))->get<int>() == 9);
+	FEATURE_CHECK(jvRecords[1].find(std::string_view(strKeys.data(), 2)) == nullptr);
+	FEATURE_CHECK((std::is_same<Json::Value::ObjectType::key_compare, std::less<>>::value));
+
+	//类型不匹配时抛出异常
+	FEATURE_CHECK(jv.load(R"({"x":"three","y":1})").empty());
+	bool bThrow = false;
+	try { jv >> ptRead; }
+	catch (const std::exception&) { bThrow = true; }
+	FEATURE_CHECK(bThrow);
+}
+
+/****** 结构体直接输出为文本 ******/
+void testWriteStruct()
+{
+	FeatureGroup group = make_group();
+	FEATURE_CHECK(same_as_value(group));
+	FEATURE_CHECK(same_as_value(FeatureGroup()));
+	FEATURE_CHECK(mmrUtil::toJsonString(std::vector<int>{}) == "null");//与Value的转换一致，空数组为null
+	FEATURE_CHECK(mmrUtil::toJsonString(std::string("a\"b\n")) == R"("a\"b\n")");
+
+	std::string strText = mmrUtil::toJsonString(group);
+	FEATURE_CHECK(strText.find(R"("optCount":null)") != std::string::npos);
+
+	//手写转换接口的成员经过Json::Value输出
+	FeaturePalette palette;
+	palette.color.g = 128;
+	palette.vecColors.resize(2);
+	FEATURE_CHECK(same_as_value(palette));
+	FEATURE_CHECK(mmrUtil::toJsonString(palette).find(R"("color":{"b":0,"g":128,"r":0})") != std::string::npos);
+
+	//输出的文本可以转换回结构体
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(strText).empty());
+	FeatureGroup groupRead;
+	jv >> groupRead;
+	FEATURE_CHECK(groupRead.name == group.name && !groupRead.optCount && groupRead.ptrCenter && groupRead.ptrCenter->label == "center");
+	FEATURE_CHECK(groupRead.mapPoints["a"][1].weights == group.mapPoints["a"][1].weights && groupRead.mapPoints["b"].empty());
+}
+
+/****** 文本直接解析为结构体 ******/
+void testReadStruct()
+{
+	//与经过Value的转换结果一致
+	FeatureGroup group = make_group();
+	std::string strText = mmrUtil::toJsonString(group);
+	FeatureGroup groupRead;
+	FEATURE_CHECK(mmrUtil::parseInto(strText, groupRead).empty());
+	FEATURE_CHECK(mmrUtil::toJsonString(groupRead) == strText);
+
+	//未注册的键跳过，支持注释
+	FeaturePoint pt;
+	FEATURE_CHECK(mmrUtil::parseInto(R"({"unknown":{"a":[1,"x\"",{"q":null}]}, /*注释*/ "x":1,"y":2,"label":"p","weights":[0.5]})", pt).empty());
+	FEATURE_CHECK(pt.x == 1 && pt.y == 2 && pt.label == "p" && pt.weights.size() == 1);
+
+	//缺少成员、类型不匹配、格式错误时返回错误信息
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"x":1})", pt).empty());
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"x":"1","y":2,"label":"p","weights":null})", pt).empty());
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"x":1,"y":2 z)", pt).empty());
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"x":1,"y":2,"label":"p","weights":null} 5)", pt).empty());
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"x":1,"y":2,"label":"abc)", pt).empty());
+
+	std::vector<int> vecData;
+	FEATURE_CHECK(mmrUtil::parseInto("[1,2,3]", vecData).empty() && vecData.size() == 3);
+
+	//手写转换接口的成员先读取为Json::Value再转换
+	FeaturePalette palette;
+	FEATURE_CHECK(mmrUtil::parseInto(R"({"name":"p","color":{"r":1,"g":2,"b":3},"vecColors":[{"r":4,"g":5,"b":6}]})", palette).empty());
+	FEATURE_CHECK(palette.color.b == 3 && palette.vecColors.size() == 1 && palette.vecColors[0].r == 4);
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"name":"p","color":{"r":"x","g":2,"b":3},"vecColors":null})", palette).empty());
+}
+
+/****** 继承手写转换接口的基类 ******/
+void testInheritHandWritten()
+{
+	FeatureNamedColor color;
+	color.r = 10;
+	color.b = 30;
+	color.style = "dash";
+	color.label = "sky";
+	static_assert(!mmrUtil::has_member_table<FeatureColor>::value && !mmrUtil::has_member_table<FeatureNamedColor>::value, "whole base");
+	static_assert(FeatureNamedColor::jsonMemberCount() == 1, "own members only");
+
+	//Value、文本、二进制三条路径往返结果一致
+	Json::Value jv;
+	jv << color;
+	FEATURE_CHECK(jv.dumpFast() == R"({"alpha":1.000000,"b":30,"g":0,"label":"sky","r":10,"style":"dash"})");
+	FEATURE_CHECK(same_as_value(color));
+	FeatureNamedColor colorRead;
+	jv >> colorRead;
+	FEATURE_CHECK(colorRead.r == 10 && colorRead.b == 30 && colorRead.style == "dash" && colorRead.label == "sky");
+
+	FeatureNamedColor colorText;
+	FEATURE_CHECK(mmrUtil::parseInto(mmrUtil::toJsonString(color), colorText).empty());
+	FEATURE_CHECK(colorText.r == 10 && colorText.style == "dash" && colorText.label == "sky");
+
+	FeatureNamedColor colorBin;
+	FEATURE_CHECK(mmrUtil::fromBinary(mmrUtil::toBinary(color), colorBin).empty());
+	FEATURE_CHECK(colorBin.b == 30 && colorBin.style == "dash" && colorBin.label == "sky");
+
+	//基类接口抛出的异常记录在ErrorList中，派生类的成员继续转换
+	FEATURE_CHECK(jv.load(R"({"r":"x","g":0,"b":0,"style":"s","alpha":0.5,"label":"l"})").empty());
+	mmrUtil::ErrorList errors;
+	FeatureNamedColor colorTry;
+	FEATURE_CHECK(!mmrUtil::tryParse(jv, colorTry, errors));
+	FEATURE_CHECK(errors.size() == 1 && colorTry.label == "l" && colorTry.alpha == 0.5);
+
+	//缺少派生类的成员
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"r":1,"g":2,"b":3,"style":"s","alpha":0.5})", colorText).empty());
+}
+
+/****** 右值文档转换为结构体 ******/
+void testMoveFrom()
+{
+	FeatureGroup group = make_group();
+	group.name = "a long group name that does not fit in small string buffer";
+	group.ptrCenter->label = "a long center label that does not fit in small string buffer";
+
+	//右值与左值转换结果一致，右值中的字符串被移走
+	Json::Value jv;
+	jv << group;
+	Json::Value jvMove = jv;
+	FeatureGroup groupCopy;
+	FeatureGroup groupMove;
+	jv >> groupCopy;
+	std::move(jvMove) >> groupMove;
+	FEATURE_CHECK(mmrUtil::toJsonString(groupCopy) == mmrUtil::toJsonString(groupMove));
+	FEATURE_CHECK(groupMove.name == group.name && groupMove.ptrCenter->label == group.ptrCenter->label);
+	FEATURE_CHECK(groupMove.jvExtra["k"].get<std::string>() == "v");
+	FEATURE_CHECK(jvMove["name"].get<std::string>().empty());
+	FEATURE_CHECK(jv["name"].get<std::string>() == group.name);
+
+	//对象数组、继承、map等值的嵌套转换
+	Json::Value jvColor;
+	FEATURE_CHECK(jvColor.load(R"({"r":1,"g":2,"b":3,"style":"a long style name that does not fit in small string buffer","alpha":0.5,"label":"l"})").empty());
+	FeatureNamedColor color;
+	std::move(jvColor) >> color;
+	FEATURE_CHECK(color.b == 3 && color.style.size() > 32 && color.label == "l");
+
+	Json::Value jvMap;
+	FEATURE_CHECK(jvMap.load(R"({"a":[1,2],"b":[]})").empty());
+	auto mapData = mmrUtil::fromJson<std::map<std::string, std::vector<int>>>(std::move(jvMap));
+	FEATURE_CHECK(mapData.size() == 2 && mapData["a"].size() == 2);
+
+	//按形状保存的对象，键直接从共享的形状复制到map的节点中
+	Json::Value jvRecords;
+	FEATURE_CHECK(jvRecords.load(R"([{"id":1,"ts":2},{"id":3,"ts":4}])").empty() && jvRecords[0].Shape() != nullptr);
+	auto vecRecords = mmrUtil::fromJson<std::vector<std::unordered_map<std::string, int>>>(std::move(jvRecords));
+	FEATURE_CHECK(vecRecords.size() == 2 && vecRecords[1]["id"] == 3 && vecRecords[1]["ts"] == 4 && vecRecords[0].size() == 2);
+
+	//缺少成员时仍然抛出异常
+	bool bThrown = false;
+	try
+	{
+		FeaturePoint pt;
+		Json::Value jvBad;
+		jvBad.load(R"({"x":1})");
+		std::move(jvBad) >> pt;
+	}
+	catch (const std::runtime_error&)
+	{
+		bThrown = true;
+	}
+	FEATURE_CHECK(bThrown);
+}
+
+/****** 多态类型的类型字段 ******/
+void testPolymorphic()
+{
+	FeatureDrawing drawing;
+	auto ptrCircle = std::make_shared<FeatureCircle>();
+	ptrCircle->radius = 3.5;
+	ptrCircle->color = "blue";
+	drawing.shape = ptrCircle;
+	drawing.vecShapes = { std::make_shared<FeatureShape>(), ptrCircle };
+
+	//直接输出文本时类型字段是对象的第一个键
+	std::string strText = mmrUtil::toJsonString(drawing);
+	FEATURE_CHECK(strText.find("{\"" FINAL_CLASS_TYPE "\":") != std::string::npos);
+	FEATURE_CHECK(same_as_value(drawing));
+
+	FeatureDrawing drawingRead;
+	FEATURE_CHECK(mmrUtil::parseInto(strText, drawingRead).empty());
+	auto* pCircle = dynamic_cast<FeatureCircle*>(drawingRead.shape.get());
+	FEATURE_CHECK(pCircle && pCircle->radius == 3.5 && pCircle->color == "blue");
+	FEATURE_CHECK(drawingRead.vecShapes.size() == 2 && !dynamic_cast<FeatureCircle*>(drawingRead.vecShapes[0].get())
+		&& dynamic_cast<FeatureCircle*>(drawingRead.vecShapes[1].get()));
+	FEATURE_CHECK(mmrUtil::toJsonString(drawingRead) == strText);
+
+	//类型字段不在第一个键时扫描查找
+	FEATURE_CHECK(mmrUtil::parseInto(R"({"shape":{"color":"g","borderWidth":2,"radius":1.5,")" FINAL_CLASS_TYPE R"(":"FeatureCircle"},"vecShapes":null,"name":"n"})", drawingRead).empty());
+	pCircle = dynamic_cast<FeatureCircle*>(drawingRead.shape.get());
+	FEATURE_CHECK(pCircle && pCircle->radius == 1.5 && pCircle->borderWidth == 2 && drawingRead.name == "n");
+
+	//经过Value转换结果一致
+	Json::Value jv;
+	jv << drawing;
+	FeatureDrawing drawingValue;
+	jv >> drawingValue;
+	FEATURE_CHECK(mmrUtil::toJsonString(drawingValue) == strText);
+
+	//按类名或数字标签创建，未注册的类型
+	FEATURE_CHECK(dynamic_cast<FeatureCircle*>(FeatureShape::genClass("FeatureCircle").get()) != nullptr);
+	FEATURE_CHECK(dynamic_cast<FeatureCircle*>(FeatureShape::genClass(ptrCircle->binaryTypeTag()).get()) != nullptr);
+	FEATURE_CHECK(!FeatureShape::genClass("FeatureSquare") && !FeatureShape::genClass(std::string_view("FeatureCircl")));
+	FEATURE_CHECK(jv.load(R"({"shape":{")" FINAL_CLASS_TYPE R"(":)" + std::to_string(ptrCircle->binaryTypeTag()) + R"(,"color":"c","borderWidth":1,"radius":4},"vecShapes":null,"name":"n"})").empty());
+	jv >> drawingValue;
+	pCircle = dynamic_cast<FeatureCircle*>(drawingValue.shape.get());
+	FEATURE_CHECK(pCircle && pCircle->radius == 4);
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"shape":{")" FINAL_CLASS_TYPE R"(":"FeatureSquare"},"vecShapes":null,"name":"n"})", drawingRead).empty());
+	mmrUtil::ErrorList errors;
+	FEATURE_CHECK(jv.load(R"({"shape":{")" FINAL_CLASS_TYPE R"(":"FeatureSquare"},"vecShapes":null,"name":"n"})").empty());
+	FEATURE_CHECK(!mmrUtil::tryParse(jv, drawingValue, errors) && errors[0].code == mmrUtil::emParseError::UnknownType);
+
+	//数字标签冲突在第二个类型注册时报告，已注册的类型不受影响
+	mmrUtil::PolymorphicRegistry<FeatureShape::BasePtrType> registry;
+	auto genCircle = []()->FeatureShape::BasePtrType { return FeatureShape::BasePtrType(new FeatureCircle()); };
+	registry.add("Shape103816", genCircle);
+	registry.add("Shape103816", genCircle);
+	bool bThrow = false;
+	try
+	{
+		registry.add("Shape120688", genCircle);
+	}
+	catch (const std::logic_error& e)
+	{
+		bThrow = std::string(e.what()).find("Shape103816") != std::string::npos;
+	}
+	FEATURE_CHECK(bThrow);
+	FEATURE_CHECK(!registry.find("Shape120688") && registry.find("Shape103816"));
+	FEATURE_CHECK(registry.find(mmrUtil::polymorphic_tag("Shape103816", 11)) == registry.find("Shape103816"));
+}
+
+/****** 结构体数组并行转换 ******/
+void testParallel()
+{
+	FeatureGroup group;
+	std::vector<FeaturePoint>& vecPoints = group.mapPoints["points"];
+	vecPoints.resize(3000);
+	for (size_t i = 0; i < vecPoints.size(); ++i)
+	{
+		vecPoints[i].x = static_cast<int>(i);
+		vecPoints[i].label = "p" + std::to_string(i);
+		vecPoints[i].weights = { i * 0.5 };
+	}
+	Json::Value jvSerial;
+	jvSerial << group;
+	std::string strSerial = mmrUtil::toJsonString(group);
+
+	//多线程与单线程结果一致
+	for (size_t threadCount : { 2, 3, 8 })
+	{
+		mmrUtil::setParallelConvert(threadCount, 100);
+		Json::Value jv;
+		jv << group;
+		FEATURE_CHECK(jv.dumpFast() == jvSerial.dumpFast());
+		FEATURE_CHECK(mmrUtil::toJsonString(group) == strSerial);
+		FeatureGroup groupRead;
+		jv >> groupRead;
+		FEATURE_CHECK(mmrUtil::toJsonString(groupRead) == strSerial);
+	}
+
+	//多个元素出错时抛出与单线程相同的异常
+	Json::Value jvBad = jvSerial;
+	jvBad["mapPoints"]["points"][2500].eraseKey("label");
+	jvBad["mapPoints"]["points"][700].eraseKey("y");
+	std::string strSerialErr;
+	std::string strParallelErr;
+	mmrUtil::setParallelConvert(0);
+	try
+	{
+		FeatureGroup groupRead;
+		jvBad >> groupRead;
+	}
+	catch (const std::exception& e)
+	{
+		strSerialErr = e.what();
+	}
+	mmrUtil::setParallelConvert(8, 100);
+	try
+	{
+		FeatureGroup groupRead;
+		jvBad >> groupRead;
+	}
+	catch (const std::exception& e)
+	{
+		strParallelErr = e.what();
+	}
+	FEATURE_CHECK(!strSerialErr.empty() && strSerialErr == strParallelErr);
+
+	//自定义执行器
+	size_t callCount = 0;
+	mmrUtil::setParallelConvert(4, 100, [&callCount](size_t taskCount, const std::function<void(size_t)>& task) {
+		++callCount;
+		for (size_t i = taskCount; i-- > 0;)
+			task(i);
+	});
+	Json::Value jvExecutor;
+	jvExecutor << group;
+	FEATURE_CHECK(callCount > 0 && jvExecutor.dumpFast() == jvSerial.dumpFast());
+	mmrUtil::setParallelConvert(0);
+}
+
+/****** 修改记录与补丁 ******/
+void testTracked()
+{
+	FeatureState state;
+	FEATURE_CHECK(!state.isJsonDirty());
+	state.setJsonMember(state.tick, 0);//值不变不标记
+	FEATURE_CHECK(!state.isJsonDirty());
+
+	//只输出标记过的成员，文本与Value一致
+	state.setJsonMember(state.tick, 10);
+	state.pos.x = 3;
+	state.markJsonDirty(state.pos);
+	FEATURE_CHECK(state.isJsonDirty());
+	Json::Value jvPatch = state.generateJsonPatch();
+	FEATURE_CHECK(jvPatch.size() == 2 && jvPatch.hasKey("tick") && jvPatch.hasKey("pos"));
+	std::string strPatch;
+	Json::Writer writer(strPatch);
+	state.writeJsonPatch(writer);
+	Json::Value jvWritten;
+	FEATURE_CHECK(jvWritten.load(strPatch).empty() && jvWritten.dumpFast() == jvPatch.dumpFast());
+	state.clearJsonDirty();
+	FEATURE_CHECK(!state.isJsonDirty() && state.generateJsonPatch().size() == 0);
+
+	//应用补丁时补丁中没有的成员保持不变
+	FeatureState remote;
+	remote.name = "remote";
+	remote.vecIds = { 1, 2 };
+	jvPatch >> remote;
+	FEATURE_CHECK(remote.tick == 10 && remote.pos.x == 3 && remote.name == "remote" && remote.vecIds.size() == 2);
+	Json::Reader reader(R"({"name":"renamed"})");
+	remote.readJson(reader);
+	FEATURE_CHECK(remote.name == "renamed" && remote.tick == 10);
+
+	//完整转换输出全部成员
+	Json::Value jvFull;
+	jvFull << state;
+	FEATURE_CHECK(jvFull.size() == 4 && same_as_value(state));
+}
+
+/****** 二进制编码 ******/
+void testBinary()
+{
+	//与Json转换结果一致
+	FeatureGroup group = make_group();
+	group.optCount = 7;
+	std::string strBin = mmrUtil::toBinary(group);
+	FeatureGroup groupBin;
+	FEATURE_CHECK(mmrUtil::fromBinary(strBin, groupBin).empty());
+	FEATURE_CHECK(mmrUtil::toJsonString(groupBin) == mmrUtil::toJsonString(group));
+
+	//多态指针、手写转换接口的成员
+	FeatureDrawing drawing;
+	auto ptrCircle = std::make_shared<FeatureCircle>();
+	ptrCircle->radius = 2.5;
+	drawing.shape = ptrCircle;
+	drawing.vecShapes = { nullptr, std::make_shared<FeatureShape>() };
+	FeatureDrawing drawingBin;
+	FEATURE_CHECK(mmrUtil::fromBinary(mmrUtil::toBinary(drawing), drawingBin).empty());
+	auto* pCircle = dynamic_cast<FeatureCircle*>(drawingBin.shape.get());
+	FEATURE_CHECK(pCircle && pCircle->radius == 2.5);
+	FEATURE_CHECK(drawingBin.vecShapes.size() == 2 && !drawingBin.vecShapes[0] && drawingBin.vecShapes[1]);
+
+	FeaturePalette palette;
+	palette.color.g = 9;
+	palette.vecColors.resize(2);
+	FeaturePalette paletteBin;
+	FEATURE_CHECK(mmrUtil::fromBinary(mmrUtil::toBinary(palette), paletteBin).empty());
+	FEATURE_CHECK(paletteBin.color.g == 9 && paletteBin.vecColors.size() == 2);
+
+	//模式不一致、数据截断时返回错误，目标不变
+	FeaturePoint pt;
+	pt.x = 5;
+	FEATURE_CHECK(!mmrUtil::fromBinary(strBin, pt).empty());
+	FEATURE_CHECK(pt.x == 5);
+	FEATURE_CHECK(!mmrUtil::fromBinary(strBin.substr(0, strBin.size() / 2), groupBin).empty());
+	FEATURE_CHECK(!mmrUtil::fromBinary(strBin + "x", groupBin).empty());
+}
+
+/****** 不抛出异常的转换 ******/
+void testTryParse()
+{
+	mmrUtil::ErrorList errors;
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(R"({"tpTime":[1],"msDelay":"x","vecPoints":[{"x":1,"y":2,"label":"a","weights":null},{"x":3000000000,"label":5,"weights":null}]})").empty());
+	FeatureEvent event;
+	FEATURE_CHECK(!mmrUtil::tryParse(jv, event, errors));
+	FEATURE_CHECK(errors.size() == 5);
+
+	//错误记录路径和期望的类型
+	std::map<std::string, std::string> mapErrors;
+	for (const auto& error : errors)
+		mapErrors[error.strPath] = std::string(mmrUtil::ErrorList::error_name(error.code)) + "," + error.expected;
+	FEATURE_CHECK(mapErrors["$.tpTime"] == "type mismatch,time");
+	FEATURE_CHECK(mapErrors["$.msDelay"] == "type mismatch,int64");
+	FEATURE_CHECK(mapErrors["$.vecPoints[1].x"] == "out of range,int32");
+	FEATURE_CHECK(mapErrors["$.vecPoints[1].y"] == "missing key,int32");
+	FEATURE_CHECK(mapErrors["$.vecPoints[1].label"] == "type mismatch,string");
+	FEATURE_CHECK(event.vecPoints.size() == 2 && event.vecPoints[0].label == "a");
+
+	//时间点的毫秒数超出范围
+	FEATURE_CHECK(jv.load(R"({"tpTime":99999999999999999999.5,"msDelay":5,"vecPoints":null})").empty());
+	FEATURE_CHECK(!mmrUtil::tryParse(jv, event, errors));
+	FEATURE_CHECK(errors.size() == 1 && errors[0].code == mmrUtil::emParseError::OutOfRange && std::string(errors[0].expected) == "time");
+
+	//遇到第一个错误后停止，重复使用时先清空
+	errors.setPolicy(mmrUtil::ErrorList::emPolicy::Stop);
+	FEATURE_CHECK(jv.load(R"({"tpTime":"bad","msDelay":"x","vecPoints":null})").empty());
+	FEATURE_CHECK(!mmrUtil::tryParse(jv, event, errors) && errors.size() == 1);
+	FEATURE_CHECK(jv.load(R"({"tpTime":0,"msDelay":5,"vecPoints":[],"extra":null})").empty());
+	FEATURE_CHECK(mmrUtil::tryParse(jv, event, errors) && errors.empty() && event.msDelay.count() == 5);
+}
+
+#ifdef MMR_JSON_CPP17
+/****** 变体类型的数字选择 ******/
+void testVariant()
+{
+	FeatureVariant data;
+	data.varNumber = 1.5;
+	data.varInt = 3;
+	data.varSigned = -4;
+	data.varOther = int64_t(2);
+
+	//Value、文本两条路径都选择类型完全一致的成员
+	auto same_variant = [&data](const FeatureVariant& read) {
+		return read.varNumber.index() == 1 && std::get<1>(read.varNumber) == 1.5
+			&& read.varInt.index() == 1 && std::get<1>(read.varInt) == 3
+			&& read.varSigned.index() == 1 && std::get<1>(read.varSigned) == -4
+			&& read.varOther == data.varOther;
+	};
+	Json::Value jv;
+	jv << data;
+	FeatureVariant dataValue;
+	jv >> dataValue;
+	FEATURE_CHECK(same_variant(dataValue));
+	FeatureVariant dataText;
+	FEATURE_CHECK(mmrUtil::parseInto(mmrUtil::toJsonString(data), dataText).empty());
+	FEATURE_CHECK(same_variant(dataText));
+	mmrUtil::ErrorList errors;
+	FeatureVariant dataTry;
+	FEATURE_CHECK(mmrUtil::tryParse(jv, dataTry, errors) && same_variant(dataTry));
+
+	//没有完全一致的成员时选择第一个数字类型，非负整数选择第一个整数类型
+	FEATURE_CHECK(jv.load(R"({"varNumber":2,"varInt":2.5,"varSigned":7,"varOther":null})").empty());
+	jv >> dataValue;
+	FEATURE_CHECK(dataValue.varNumber.index() == 0 && dataValue.varInt.index() == 0 && dataValue.varSigned.index() == 0);
+	FEATURE_CHECK(dataValue.varOther.index() == 0);
+	FEATURE_CHECK(mmrUtil::parseInto(R"({"varNumber":2,"varInt":2.5,"varSigned":7,"varOther":"s"})", dataText).empty());
+	FEATURE_CHECK(dataText.varNumber.index() == 0 && dataText.varInt.index() == 0 && dataText.varSigned.index() == 0);
+	FEATURE_CHECK(dataText.varOther.index() == 1);
+}
+#endif // MMR_JSON_CPP17
+
+/****** 二进制数据的Base64编码 ******/
+void testBase64()
+{
+	//RFC 4648的测试数据
+	const char* tests[][2] = { { "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" },
+		{ "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" } };
+	for (const auto& test : tests)
+		FEATURE_CHECK(Json::base64::encode(test[0], strlen(test[0])) == test[1]);
+
+	//各种长度编解码往返，覆盖向量指令处理的部分和剩余部分
+	std::vector<uint8_t> vecSrc(200);
+	for (size_t i = 0; i < vecSrc.size(); ++i)
+		vecSrc[i] = static_cast<uint8_t>(i * 37 + 11);
+	bool bRoundTrip = true;
+	for (size_t len = 0; len <= vecSrc.size(); ++len)
+	{
+		std::string strEncoded = Json::base64::encode(vecSrc.data(), len);
+		std::vector<uint8_t> vecOut(Json::base64::decoded_max_size(strEncoded.size()));
+		size_t outLen = 0;
+		bRoundTrip = bRoundTrip && strEncoded.size() == Json::base64::encoded_size(len)
+			&& Json::base64::decode(strEncoded.data(), strEncoded.size(), vecOut.data(), outLen)
+			&& outLen == len && std::equal(vecSrc.begin(), vecSrc.begin() + len, vecOut.begin());
+	}
+	FEATURE_CHECK(bRoundTrip);
+
+	//非法字符在向量处理的部分和剩余部分都能发现
+	std::string strBad = Json::base64::encode(vecSrc.data(), 96);
+	std::vector<uint8_t> vecOut(Json::base64::decoded_max_size(strBad.size()));
+	size_t outLen = 0;
+	strBad[5] = '*';
+	FEATURE_CHECK(!Json::base64::decode(strBad.data(), strBad.size(), vecOut.data(), outLen));
+	strBad[5] = 'A';
+	strBad[strBad.size() - 2] = '-';
+	FEATURE_CHECK(!Json::base64::decode(strBad.data(), strBad.size(), vecOut.data(), outLen));
+
+	//结构体成员转换为Base64字符串，读取时兼容整数数组
+	FeatureBlob blob;
+	blob.vecData.assign(vecSrc.begin(), vecSrc.begin() + 50);
+	Json::Value jv;
+	FeatureBlob blobRead;
+#ifdef MMR_JSON_CPP17
+	blob.vecBytes = { std::byte{ 0 }, std::byte{ 255 } };
+	jv << blob;
+	FEATURE_CHECK(jv["vecBytes"].JSONType() == Json::emJsonType::String && jv["vecBytes"].get<std::string>() == "AP8=");
+	jv >> blobRead;
+	FEATURE_CHECK(blobRead.vecBytes == blob.vecBytes);
+	FEATURE_CHECK(mmrUtil::fromBinary(mmrUtil::toBinary(blob), blobRead).empty() && blobRead.vecBytes == blob.vecBytes);
+#endif // MMR_JSON_CPP17
+	jv << blob;
+	FEATURE_CHECK(jv["vecData"].JSONType() == Json::emJsonType::String);
+	FEATURE_CHECK(same_as_value(blob));
+	jv >> blobRead;
+	FEATURE_CHECK(blobRead.vecData == blob.vecData);
+	FEATURE_CHECK(mmrUtil::parseInto(mmrUtil::toJsonString(blob), blobRead).empty() && blobRead.vecData == blob.vecData);
+	FEATURE_CHECK(mmrUtil::fromBinary(mmrUtil::toBinary(blob), blobRead).empty() && blobRead.vecData == blob.vecData);
+	FEATURE_CHECK(mmrUtil::parseInto(R"({"vecData":[1,2,255],"vecBytes":"AP8="})", blobRead).empty());
+	FEATURE_CHECK(blobRead.vecData == std::vector<uint8_t>({ 1, 2, 255 }));
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"vecData":"A*==","vecBytes":null})", blobRead).empty());
+}
+
+/****** 时间类型 ******/
+void testChrono()
+{
+	using namespace std::chrono;
+	using MilliPoint = time_point<system_clock, milliseconds>;
+	char buf[32];
+
+	//格式化，小数秒位数与精度一致，1970年之前向下取整
+	std::string strTime(buf, mmrUtil::format_rfc3339(MilliPoint(milliseconds(1704164645123)), buf));
+	FEATURE_CHECK(strTime == "2024-01-02T03:04:05.123Z");
+	strTime.assign(buf, mmrUtil::format_rfc3339(time_point<system_clock, seconds>(seconds(951782400)), buf));
+	FEATURE_CHECK(strTime == "2000-02-29T00:00:00Z");
+	strTime.assign(buf, mmrUtil::format_rfc3339(MilliPoint(milliseconds(-500)), buf));
+	FEATURE_CHECK(strTime == "1969-12-31T23:59:59.500Z");
+
+	//与gmtime的结果一致
+	bool bSame = true;
+	for (int64_t secs = -86400LL * 365 * 70; secs < 86400LL * 365 * 130; secs += 86400LL * 37 + 3671)
+	{
+		std::time_t tt = static_cast<std::time_t>(secs);
+		std::tm tmUtc = *std::gmtime(&tt);
+		char bufRef[32];
+		std::strftime(bufRef, sizeof(bufRef), "%Y-%m-%dT%H:%M:%SZ", &tmUtc);
+		size_t len = mmrUtil::format_rfc3339(time_point<system_clock, seconds>(seconds(secs)), buf);
+		bSame = bSame && std::string(buf, len) == bufRef;
+		time_point<system_clock, seconds> tpRead;
+		bSame = bSame && mmrUtil::parse_time_point(bufRef, tpRead) && tpRead.time_since_epoch().count() == secs;
+	}
+	FEATURE_CHECK(bSame);
+
+	//解析时区偏移、小数秒，拒绝不存在的日期
+	MilliPoint tpRead;
+	FEATURE_CHECK(mmrUtil::parse_time_point("2024-01-02T11:04:05.1239+08:00", tpRead));
+	FEATURE_CHECK(tpRead.time_since_epoch().count() == 1704164645123);
+	FEATURE_CHECK(mmrUtil::parse_time_point("2024-02-29 00:00:00z", tpRead));
+	FEATURE_CHECK(!mmrUtil::parse_time_point("2023-02-29T00:00:00Z", tpRead));
+	FEATURE_CHECK(!mmrUtil::parse_time_point("2024-13-01T00:00:00Z", tpRead));
+	FEATURE_CHECK(!mmrUtil::parse_time_point("2024-01-02T03:04:05", tpRead));
+	FEATURE_CHECK(!mmrUtil::parse_time_point("2024-01-02T03:04:05.Z", tpRead));
+
+	//结构体成员，Value、文本两条路径一致，读取时兼容毫秒数
+	FeatureEvent event;
+	event.tpTime = system_clock::time_point(duration_cast<system_clock::duration>(milliseconds(1704164645123)));
+	event.msDelay = milliseconds(250);
+	Json::Value jv;
+	jv << event;
+	FEATURE_CHECK(same_as_value(event));
+	FeatureEvent eventRead;
+	jv >> eventRead;
+	FEATURE_CHECK(eventRead.tpTime == event.tpTime && eventRead.msDelay == event.msDelay);
+	FEATURE_CHECK(mmrUtil::parseInto(R"({"tpTime":1704164645123,"msDelay":7,"vecPoints":null})", eventRead).empty());
+	FEATURE_CHECK(eventRead.tpTime == event.tpTime && eventRead.msDelay.count() == 7);
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"tpTime":"2024-01-02","msDelay":7,"vecPoints":null})", eventRead).empty());
+}
+
+/****** MessagePack与CBOR ******/
+void testMsgPackCbor()
+{
+	//已知编码
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(R"({"a":[1,-1,1.5]})").empty());
+	FEATURE_CHECK(jv.toMsgPack() == std::string("\x81\xa1" "a" "\x93\x01\xff\xcb\x3f\xf8\0\0\0\0\0\0", 15));
+	FEATURE_CHECK(jv.toCbor() == std::string("\xa1\x61" "a" "\x83\x01\x20\xfb\x3f\xf8\0\0\0\0\0\0", 15));
+
+	//往返后内容和数字类型不变，字符串写入转义前的内容
+	FEATURE_CHECK(jv.load(s_jsonDoc).empty());
+	jv["unsigned"] = uint64_t(5);
+	jv["empty"] = Json::Value::Make(Json::emJsonType::Object);
+	Json::Value jvPack;
+	FEATURE_CHECK(jvPack.loadMsgPack(jv.toMsgPack()).empty());
+	FEATURE_CHECK(jvPack.dumpFast() == jv.dumpFast() && jvPack["unsigned"].JSONType() == Json::emJsonType::Uintegral);
+	FEATURE_CHECK(jvPack["list"][2].get<std::string>() == jv["list"][2].get<std::string>());
+	Json::Value jvCbor;
+	FEATURE_CHECK(jvCbor.loadCbor(jv.toCbor()).empty());
+	FEATURE_CHECK(jvCbor.dumpFast() == jv.dumpFast());
+	FEATURE_CHECK(jvCbor["ratio"].JSONType() == Json::emJsonType::Floating && jvCbor["count"].JSONType() == Json::emJsonType::Integral);
+	std::string strPack = jv.toMsgPack();
+	FEATURE_CHECK(strPack.find("x\ny") != std::string::npos);
+
+	//紧凑存储的数字数组与展开后编码一致
+	Json::Value jvArray;
+	FEATURE_CHECK(jvArray.load("[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20]").empty());
+	Json::Value jvUnpacked = jvArray;
+	jvUnpacked[0] = 1;
+	FEATURE_CHECK(jvArray.toMsgPack() == jvUnpacked.toMsgPack() && jvArray.toCbor() == jvUnpacked.toCbor());
+
+	//数据不完整、多余数据时返回错误，原有值不变
+	FEATURE_CHECK(!jvPack.loadMsgPack(strPack.substr(0, strPack.size() - 1)).empty());
+	FEATURE_CHECK(!jvPack.loadMsgPack(strPack + '\x01').empty());
+	std::string strCbor = jv.toCbor();
+	FEATURE_CHECK(!jvCbor.loadCbor(strCbor.substr(0, strCbor.size() / 2)).empty());
+	FEATURE_CHECK(jvPack.dumpFast() == jv.dumpFast() && jvCbor.dumpFast() == jv.dumpFast());
+}
+
+/****** 二进制快照 ******/
+void testSnapshot()
+{
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(s_jsonDoc).empty());
+	Json::FrozenDocument doc = Json::freeze(jv);
+	std::string strSnap;
+	Json::MappedDocument::write(doc, strSnap);
+
+	//从调用方持有的内存加载，内容与只读文档一致
+	std::vector<uint64_t> vecAligned((strSnap.size() + 7) / 8);
+	memcpy(vecAligned.data(), strSnap.data(), strSnap.size());
+	Json::MappedDocument snap;
+	FEATURE_CHECK(snap.load(vecAligned.data(), strSnap.size(), true).empty());
+	FEATURE_CHECK(snap.is_open() && snap.size() == strSnap.size());
+	Json::ValueRef root = snap.root();
+	FEATURE_CHECK(root.dumpFast() == doc.root().dumpFast());
+	FEATURE_CHECK(root["sub"]["k9"].get<int>() == 9 && !root["sub"].hasKey("k10"));
+	FEATURE_CHECK(root["list"][2].get<std::string>() == jv["list"][2].get<std::string>());
+
+	//带有被覆盖成员的文档同样可以通过校验
+	Json::FrozenDocument docDup;
+	FEATURE_CHECK(docDup.load(R"({"a":1,"a":[2],"b":3})").empty());
+	std::string strSnapDup;
+	Json::MappedDocument::write(docDup, strSnapDup);
+	std::vector<uint64_t> vecDup((strSnapDup.size() + 7) / 8);
+	memcpy(vecDup.data(), strSnapDup.data(), strSnapDup.size());
+	Json::MappedDocument snapDup;
+	FEATURE_CHECK(snapDup.load(vecDup.data(), strSnapDup.size(), true).empty());
+	FEATURE_CHECK(snapDup.root().size() == 2 && snapDup.root().dumpFast() == R"({"a":[2],"b":3})");
+
+	//映射文件
+	const char* pFile = "feature_snapshot.snap";
+	FEATURE_CHECK(Json::MappedDocument::save_to_file(jv, pFile));
+	Json::MappedDocument snapFile;
+	FEATURE_CHECK(snapFile.open(pFile).empty() && snapFile.verify().empty());
+	FEATURE_CHECK(snapFile.root().dumpFast() == doc.root().dumpFast());
+	snapFile.close();
+	std::remove(pFile);
+	FEATURE_CHECK(!snapFile.is_open() && snapFile.root().IsNull() && !snapFile.verify().empty());
+	FEATURE_CHECK(!snapFile.open(pFile).empty());
+
+	//格式错误时返回错误信息，原有数据不变
+	FEATURE_CHECK(!snap.load(reinterpret_cast<const char*>(vecAligned.data()) + 1, strSnap.size() - 1).empty());
+	FEATURE_CHECK(!snap.load(vecAligned.data(), strSnap.size() / 2).empty());
+	std::vector<uint64_t> vecBad = vecAligned;
+	reinterpret_cast<char*>(vecBad.data())[0] ^= 1;
+	FEATURE_CHECK(!snap.load(vecBad.data(), strSnap.size()).empty());
+	FEATURE_CHECK(snap.root()["count"].get<int>() == 3);
+}
+
+/****** JSON Pointer ******/
+void testPointer()
+{
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(R"({"data":{"items":[{"id":1,"a/b":"x","m~n":"y"},{"id":2}],"nums":[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16]}})").empty());
+	const Json::Value& jvConst = jv;
+	FEATURE_CHECK(jv["data"]["nums"].ArrayStorage() != Json::emArrayStorage::Generic);
+
+	//转义的键，不存在的路径不插入数据
+	FEATURE_CHECK(Json::Pointer("/data/items/0/a~1b").resolve(jvConst)->get<std::string>() == "x");
+	FEATURE_CHECK(Json::Pointer("/data/items/0/m~0n").resolve(jvConst)->get<std::string>() == "y");
+	FEATURE_CHECK(Json::Pointer("").resolve(jvConst) == &jv);
+	FEATURE_CHECK(!Json::Pointer("/data/items/2").resolve(jvConst) && !Json::Pointer("/data/items/01").resolve(jvConst));
+	FEATURE_CHECK(!Json::Pointer("/data/none/x").resolve(jvConst) && !jv["data"].hasKey("none"));
+	FEATURE_CHECK(Json::Pointer("/data/items/0/a~1b").toString() == "/data/items/0/a~1b");
+	Json::Pointer ptrBad;
+	FEATURE_CHECK(!ptrBad.load("data").empty() && !ptrBad.load("/a~2").empty());
+
+	//const查找不展开紧凑存储的数组
+	const Json::Value* pConstNum = Json::Pointer("/data/nums/15").resolve(jvConst);
+	FEATURE_CHECK(pConstNum != nullptr && pConstNum->get<int>() == 16 && pConstNum == &jvConst["data"]["nums"][15]);
+	FEATURE_CHECK(!Json::Pointer("/data/nums/16").resolve(jvConst) && !Json::Pointer("/data/nums/0/x").resolve(jvConst));
+	FEATURE_CHECK(jv["data"]["nums"].ArrayStorage() != Json::emArrayStorage::Generic);
+
+	Json::PointerBatch batch({ Json::Pointer("/data/nums/3"), Json::Pointer("/data/items/1/id"), Json::Pointer("/data/nums/99"),
+		Json::Pointer("/data/items/0/id"), Json::Pointer("/data/nums/4") });
+	std::vector<const Json::Value*> vecValues = batch.resolve(jvConst);
+	FEATURE_CHECK(vecValues.size() == 5 && vecValues[0]->get<int>() == 4 && vecValues[1]->get<int>() == 2 && vecValues[2] == nullptr);
+	FEATURE_CHECK(vecValues[3]->get<int>() == 1 && vecValues[4]->get<int>() == 5);
+	FEATURE_CHECK(jv["data"]["nums"].ArrayStorage() != Json::emArrayStorage::Generic);
+
+	//多线程同时查找
+	int iSum[2] = { 0, 0 };
+	auto reader = [&jvConst, &batch](int& iOut) {
+		for (int i = 0; i < 1000; ++i)
+			for (const Json::Value* pValue : batch.resolve(jvConst))
+				iOut += pValue != nullptr ? pValue->get<int>() : 0;
+	};
+	std::thread th1(reader, std::ref(iSum[0]));
+	std::thread th2(reader, std::ref(iSum[1]));
+	th1.join();
+	th2.join();
+	FEATURE_CHECK(iSum[0] == 12000 && iSum[1] == 12000);
+
+	//非const查找可以修改，经过紧凑存储的数组时转换为通用存储
+	Json::Value* pNum = Json::Pointer("/data/nums/0").resolve(jv);
+	FEATURE_CHECK(pNum != nullptr);
+	*pNum = "first";
+	FEATURE_CHECK(jv["data"]["nums"][0].get<std::string>() == "first");
+	Json::Pointer("/data/items/-/id").resolveOrCreate(jv) = 3;
+	Json::Pointer("/data/new/0").resolveOrCreate(jv) = true;
+	FEATURE_CHECK(jv["data"]["items"].size() == 3 && jv["data"]["items"][2]["id"].get<int>() == 3);
+	FEATURE_CHECK(jv["data"]["new"].JSONType() == Json::emJsonType::Array && jv["data"]["new"][0].get<bool>());
+}
+
+/****** 流式JSONPath查询 ******/
+void testJsonPath()
+{
+	const char* pStore = R"({"store":{"book":[{"title":"a","price":8.5,"tags":["x"]},{"title":"b","price":12},
+		{"title":"c","price":5,"isbn":"1"},{"title":"d"}],"bicycle":{"price":20,"note":"]}\"{["}}, /*注释*/ "price":1})";
+
+	//匹配结果为原文中的片段，按文档顺序
+	auto select_text = [pStore](const char* pExpr) {
+		std::vector<std::string_view> vecOut;
+		std::string strErr = Json::JsonPath(pExpr).select(pStore, vecOut);
+		std::string strRet = strErr.empty() ? "" : "error";
+		for (const auto& item : vecOut)
+			strRet.append(item.data(), item.size()).append(1, ';');
+		return strRet;
+	};
+	FEATURE_CHECK(select_text("$.store.book[*].title") == R"("a";"b";"c";"d";)");
+	FEATURE_CHECK(select_text("$..price") == "8.5;12;5;20;1;");
+	FEATURE_CHECK(select_text("$.store.book[1:4:2].title") == R"("b";"d";)");
+	FEATURE_CHECK(select_text("$.store.book[0,2]['title','isbn']") == R"("a";"c";"1";)");
+	FEATURE_CHECK(select_text("$.store.book[?(@.price < 10)].title") == R"("a";"c";)");
+	FEATURE_CHECK(select_text("$.store.book[?(@.isbn)].price") == "5;");
+	FEATURE_CHECK(select_text("$.store.bicycle.note") == R"("]}\"{[";)");
+	FEATURE_CHECK(select_text("$.store.book[0].tags") == R"(["x"];)");
+	FEATURE_CHECK(select_text("$.none[*]").empty());
+
+	//只解析匹配的子树，回调返回false时停止
+	std::vector<Json::Value> vecBooks;
+	FEATURE_CHECK(Json::JsonPath("$..book[?(@.price >= 8.5)]").select(pStore, vecBooks).empty());
+	FEATURE_CHECK(vecBooks.size() == 2 && vecBooks[1]["title"].get<std::string>() == "b");
+	int iCount = 0;
+	FEATURE_CHECK(Json::JsonPath("$..title").forEach(pStore, [&iCount](std::string_view) { return ++iCount < 2; }).empty());
+	FEATURE_CHECK(iCount == 2);
+
+	//多个连续的Json值分别匹配，格式错误时返回错误信息
+	std::vector<std::string_view> vecIds;
+	FEATURE_CHECK(Json::JsonPath("$.user.id").select("{\"user\":{\"id\":1}}\n{\"user\":{\"id\":2}}\n", vecIds).empty());
+	FEATURE_CHECK(vecIds.size() == 2 && vecIds[1] == "2");
+	FEATURE_CHECK(!Json::JsonPath("$.a").select(R"({"a":1,"b":[1,2)", vecIds).empty());
+	Json::JsonPath pathBad;
+	FEATURE_CHECK(!pathBad.load("store.book").empty() && !pathBad.load("$.book[-1]").empty());
+}
+
+/****** 投影解析 ******/
+void testProjection()
+{
+	const char* pRequest = R"({"id":7,"body":{"big":[1,{"x":"}]"}],"s":"a\"b"},/*注释*/"payload":{"kind":"click","extra":[1,2]},
+		"ts":123,"list":[{"k":1,"v":2},{"v":3},5],"a.b":{"c":1}})";
+
+	//只保留列出的字段，与完整解析后取出的字段一致
+	Json::Value jv;
+	FEATURE_CHECK(jv.load(pRequest, Json::Projection{ "id", "ts", "payload.kind" }).empty());
+	FEATURE_CHECK(jv.dumpFast() == R"({"id":7,"payload":{"kind":"click"},"ts":123})");
+
+	//经过数组时对每个元素投影，不是对象的元素不保留，JSON Pointer形式用于含'.'的键
+	FEATURE_CHECK(jv.load(pRequest, Json::Projection{ "list.k", "/a.b/c", "body" }).empty());
+	Json::Value jvFull;
+	FEATURE_CHECK(jvFull.load(pRequest).empty());
+	FEATURE_CHECK(jv["body"].dumpFast() == jvFull["body"].dumpFast());
+	FEATURE_CHECK(jv["list"].dumpFast() == R"([{"k":1},{}])" && jv["a.b"]["c"].get<int>() == 1);
+	FEATURE_CHECK(jv.size() == 3);
+
+	//不存在的字段，跳过的内容不完整时返回错误，原有值不变
+	FEATURE_CHECK(jv.load(pRequest, Json::Projection{ "none" }).empty() && jv.size() == 0);
+	FEATURE_CHECK(jv.load(pRequest, Json::Projection{ "id" }).empty());
+	FEATURE_CHECK(!jv.load(R"({"id":1,"skip":{"a":[1,2})", Json::Projection{ "id" }).empty());
+	FEATURE_CHECK(!jv.load(R"({"id":1,"skip":"abc)", Json::Projection{ "id" }).empty());
+	FEATURE_CHECK(jv.dumpFast() == R"({"id":7})");
+}
+
+/****** 大文件索引 ******/
+void testIndexedFile()
+{
+	//未打开时返回错误信息
+	Json::IndexedFile fileEmpty;
+	Json::Value jv;
+	FEATURE_CHECK(!fileEmpty.at(0, jv).empty() && !fileEmpty.get("a", jv).empty());
+	FEATURE_CHECK(!fileEmpty.get(Json::Pointer(), jv).empty() && !fileEmpty.get(Json::Pointer("/0/x"), jv).empty());
+
+	const char* pFile = "feature_index.json";
+	std::string strIndexFile = std::string(pFile) + ".idx";
+	std::string strJson = "[";
+	for (int i = 0; i < 100; ++i)
+		strJson += (i ? "," : "") + std::string("{\"id\":") + std::to_string(i) + ",\"sub\":{\"s\":\"]\\\"" + std::to_string(i) + "\"}}";
+	strJson += "]";
+	{
+		std::ofstream outFile(pFile, std::ios::binary | std::ios::trunc);
+		outFile << strJson;
+	}
+	Json::Value jvFull;
+	FEATURE_CHECK(jvFull.load(strJson).empty());
+
+	//与完整解析的结果一致，第一次打开时生成索引文件，之后直接读取
+	for (uint32_t stride : { 1, 7 })
+	{
+		std::remove(strIndexFile.c_str());
+		Json::IndexedFile file;
+		FEATURE_CHECK(file.open(pFile, stride == 1, stride).empty() && file.size() == 100);
+		FEATURE_CHECK(std::ifstream(strIndexFile).good());
+		FEATURE_CHECK(file.at(57, jv).empty() && jv.dumpFast() == jvFull[57].dumpFast());
+		FEATURE_CHECK(file.get(Json::Pointer("/99/sub/s"), jv).empty() && jv.dumpFast() == jvFull[99]["sub"]["s"].dumpFast());
+		FEATURE_CHECK(file.get(Json::Pointer(), jv).empty() && jv.size() == 100);
+		FEATURE_CHECK(!file.at(100, jv).empty() && !file.get(Json::Pointer("/3/none"), jv).empty());
+		Json::IndexedFile fileReopen;
+		FEATURE_CHECK(fileReopen.open(pFile, stride == 1, stride).empty() && fileReopen.at(6, jv).empty());
+		FEATURE_CHECK(jv["id"].get<int>() == 6);
+	}
+
+	//文件中间被修改而大小、首尾内容和修改时间都没有变化时，定位到的位置不是值的开始，重新生成索引
+	auto writeFile = [pFile](const std::string& strData) {
+		std::ofstream outFile(pFile, std::ios::binary | std::ios::trunc);
+		outFile << strData;
+	};
+	std::string strLarge = "[";
+	for (int i = 0; i < 1000; ++i)
+		strLarge += (i ? "," : "") + std::string("{\"id\":") + std::to_string(i) + "}";
+	strLarge += "]";
+	writeFile(strLarge);
+	std::remove(strIndexFile.c_str());
+	{
+		Json::IndexedFile file;
+		FEATURE_CHECK(file.open(pFile).empty() && file.at(501, jv).empty() && jv["id"].get<int>() == 501);
+	}
+	std::string strChanged = strLarge;
+	strChanged.replace(strChanged.find(R"({"id":500},{"id":501})"), 21, R"({"id":5000},{"id":51})");
+	writeFile(strChanged);
+	Json::MappedFile mapped;
+	Json::JsonIndex index;
+	FEATURE_CHECK(mapped.open(pFile).empty() && index.load_from_file(strIndexFile).empty() && index.matches(mapped.view()));
+	index.set_source_time(mapped.modify_time());//模拟保留修改时间的复制
+	FEATURE_CHECK(index.save_to_file(strIndexFile));
+	{
+		Json::IndexedFile file;
+		FEATURE_CHECK(file.open(pFile).empty() && file.index().source_time() == mapped.modify_time());
+		FEATURE_CHECK(file.at(501, jv).empty() && jv["id"].get<int>() == 51);
+		FEATURE_CHECK(file.at(500, jv).empty() && jv["id"].get<int>() == 5000);
+	}
+	mapped.close();
+
+	//顶层对象按键查找
+	{
+		std::ofstream outFile(pFile, std::ios::binary | std::ios::trunc);
+		outFile << R"({"a":1,"b":{"c":[1,2,3]},"a":2})";
+	}
+	Json::IndexedFile fileObject;
+	FEATURE_CHECK(fileObject.open(pFile).empty());
+	FEATURE_CHECK(fileObject.get("a", jv).empty() && jv.get<int>() == 2);
+	FEATURE_CHECK(fileObject.get(Json::Pointer("/b/c/2"), jv).empty() && jv.get<int>() == 3);
+	FEATURE_CHECK(!fileObject.get("none", jv).empty());
+	fileObject = Json::IndexedFile();
+	std::remove(pFile);
+	std::remove(strIndexFile.c_str());
+}
+
+/****** JSON Schema校验 ******/
+void testSchema()
+{
+	Json::Value jvSchema;
+	FEATURE_CHECK(jvSchema.load(R"({"$schema":"https://json-schema.org/draft/2020-12/schema","type":"object",
+		"properties":{"id":{"type":"integer","minimum":1},"name":{"type":"string","minLength":2,"maxLength":4,"pattern":"^[a-z]+$"},
+		"kind":{"enum":["a","b",1]},"tags":{"type":"array","items":{"type":"string"},"maxItems":2},"ratio":{"exclusiveMaximum":1},
+		"sub":{"type":["object","null"],"additionalProperties":false,"properties":{"x":true}}},
+		"required":["id","name"],"maxProperties":6})").empty());
+	Json::Schema schema;
+	FEATURE_CHECK(schema.load(jvSchema).empty());
+
+	//Value与文本两种校验方式记录的错误相同（文本校验时数组个数在读完元素后检查，顺序可能不同）
+	auto collect = [&schema](const char* pJson) {
+		auto sorted = [](const std::vector<Json::Schema::Error>& errors) {
+			std::vector<std::string> vecRet;
+			for (const auto& error : errors)
+				vecRet.push_back(error.path + " " + error.keyword + ";");
+			std::sort(vecRet.begin(), vecRet.end());
+			return vecRet;
+		};
+		Json::Value jv;
+		std::string strRet = jv.load(pJson).empty() && schema.validate(jv) ? "ok;" : "";
+		std::vector<Json::Schema::Error> errors;
+		schema.validate(jv, errors);
+		std::vector<Json::Schema::Error> textErrors;
+		if (!schema.validateText(pJson, textErrors).empty() || sorted(errors) != sorted(textErrors))
+			return std::string("mismatch");
+		for (const auto& iter : sorted(errors))
+			strRet.append(iter);
+		return strRet;
+	};
+	FEATURE_CHECK(collect(R"({"id":3.0,"name":"ab","kind":1.0,"tags":["x"],"ratio":0.5,"sub":{"x":[]}})") == "ok;");
+	FEATURE_CHECK(collect(R"({"id":0,"name":"ab"})") == "/id minimum;");
+	FEATURE_CHECK(collect(R"({"id":1.5,"name":"abcde"})") == "/id type;/name maxLength;");
+	FEATURE_CHECK(collect(R"({"id":1,"name":"A1"})") == "/name pattern;");
+	FEATURE_CHECK(collect(R"({"id":1,"name":"ab","tags":["x",2,"z"]})") == "/tags maxItems;/tags/1 type;");
+	FEATURE_CHECK(collect(R"({"id":1,"name":"ab","kind":"c","ratio":1})") == "/kind enum;/ratio exclusiveMaximum;");
+	FEATURE_CHECK(collect(R"({"id":1,"name":"ab","sub":{"y":1}})") == "/sub/y additionalProperties;");
+	FEATURE_CHECK(collect(R"({"name":"ab"})") == " required;");
+	FEATURE_CHECK(collect(R"([1])") == " type;");
+
+	//读取文本的同时校验
+	std::vector<Json::Schema::Error> readerErrors;
+	Json::Reader reader(R"({"id":0,"name":"ab"})");
+	schema.validate(reader, readerErrors);
+	FEATURE_CHECK(readerErrors.size() == 1 && readerErrors[0].path == "/id" && reader.peek() == '\0');
+
+	//长度按UTF-8字符计数
+	Json::Value jvLength;
+	FEATURE_CHECK(jvLength.load(R"({"maxLength":2})").empty());
+	Json::Schema schemaLength(jvLength);
+	FEATURE_CHECK(jvLength.load("\"\xE4\xB8\xAD\xE6\x96\x87\"").empty() && schemaLength.validate(jvLength));
+	FEATURE_CHECK(jvLength.load("\"abc\"").empty() && !schemaLength.validate(jvLength));
+
+	//不支持的关键字、格式错误的模式在加载时报错，原有模式不变
+	Json::Value jvBad;
+	FEATURE_CHECK(jvBad.load(R"({"anyOf":[{"type":"string"}]})").empty() && !schema.load(jvBad).empty());
+	FEATURE_CHECK(jvBad.load(R"({"type":"text"})").empty() && !schema.load(jvBad).empty());
+	FEATURE_CHECK(jvBad.load(R"({"pattern":"("})").empty() && !schema.load(jvBad).empty());
+	FEATURE_CHECK(collect(R"({"id":0,"name":"ab"})") == "/id minimum;");
+	std::vector<Json::Schema::Error> errors;
+	FEATURE_CHECK(!schema.validateText(R"({"id":1,)", errors).empty());
+
+	//错误路径中的键先还原转义再按RFC 6901转义；重复的键在两种方式中都只计一次
+	Json::Value jvKeys;
+	FEATURE_CHECK(jvKeys.load(R"({"additionalProperties":{"type":"integer"},"minProperties":2})").empty());
+	FEATURE_CHECK(schema.load(jvKeys).empty());
+	FEATURE_CHECK(collect(R"({"a\"b":"x","c/~d":"y"})") == "/a\"b type;/c~1~0d type;");
+	FEATURE_CHECK(collect(R"({"a":1,"a":2})") == " minProperties;");
+	FEATURE_CHECK(collect(R"({"a":1,"b":2})") == "ok;");
+}
+
+/****** 其它容器 ******/
+void testContainers()
+{
+	FeatureContainers data;
+	data.mapCount = { { "a", 1 }, { "b", 2 } };
+	data.dequePoints.resize(2);
+	data.dequePoints[1].label = "second";
+	data.arrData = { 1, 2, 3 };
+	data.setNames = { "y", "x" };
+	data.setIds = { 5, 6 };
+	data.pairValue = { "p", 0.5 };
+	data.tupleValue = std::make_tuple(1, "t", std::vector<int>{ 2, 3 });
+
+	//Value、文本、二进制三条路径结果一致
+	Json::Value jv;
+	jv << data;
+	FEATURE_CHECK(jv["arrData"].dumpFast() == "[1,2,3]" && jv["setNames"].dumpFast() == R"(["x","y"])");
+	FEATURE_CHECK(jv["pairValue"].dumpFast() == R"(["p",0.500000])" && jv["tupleValue"].dumpFast() == R"([1,"t",[2,3]])");
+	auto same_data = [&data](const FeatureContainers& read) {
+		return read.mapCount == data.mapCount && read.dequePoints.size() == 2 && read.dequePoints[1].label == "second"
+			&& read.arrData == data.arrData && read.setNames == data.setNames && read.setIds == data.setIds
+			&& read.pairValue == data.pairValue && read.tupleValue == data.tupleValue;
+	};
+	FeatureContainers dataValue;
+	jv >> dataValue;
+	FEATURE_CHECK(same_data(dataValue));
+	FeatureContainers dataText;
+	FEATURE_CHECK(mmrUtil::parseInto(mmrUtil::toJsonString(data), dataText).empty() && same_data(dataText));
+	FeatureContainers dataBin;
+	FEATURE_CHECK(mmrUtil::fromBinary(mmrUtil::toBinary(data), dataBin).empty() && same_data(dataBin));
+
+	//定长数组、元组的元素个数必须一致
+	FEATURE_CHECK(jv.load(R"({"mapCount":null,"dequePoints":null,"arrData":[1,2],"setNames":null,"setIds":null,"pairValue":["p",1],"tupleValue":[1,"t",[]]})").empty());
+	bool bThrown = false;
+	try
+	{
+		jv >> dataValue;
+	}
+	catch (const std::runtime_error&)
+	{
+		bThrown = true;
+	}
+	FEATURE_CHECK(bThrown);
+	FEATURE_CHECK(!mmrUtil::parseInto(R"({"mapCount":null,"dequePoints":null,"arrData":[1,2,3],"setNames":null,"setIds":null,"pairValue":["p"],"tupleValue":[1,"t",[]]})", dataText).empty());
+}
+
+int main()
+{
+	testFrozen();
+	testCompact();
+	testPackedConst();
+	testKeyPool();
+	testShapeConst();
+	testMemberTable();
+	testWriteStruct();
+	testReadStruct();
+	testInheritHandWritten();
+	testMoveFrom();
+	testPolymorphic();
+	testParallel();
+	testTracked();
+	testBinary();
+	testTryParse();
+#ifdef MMR_JSON_CPP17
+	testVariant();
+#endif // MMR_JSON_CPP17
+	testContainers();
+	testBase64();
+	testChrono();
+	testMsgPackCbor();
+	testSnapshot();
+	testPointer();
+	testJsonPath();
+	testProjection();
+	testIndexedFile();
+	testSchema();
+
+	if (g_iFailed != 0)
+	{
+		std::cout << "功能检查失败数：" << g_iFailed << std::endl;
+		return 1;
+	}
+	std::cout << "功能检查全部通过" << std::endl;
+	return 0;
+}